@@ -68,6 +68,10 @@ MongoConnectionPool::MongoConnectionPool(
 
 MongoConnectionPool::~MongoConnectionPool()
 {
+	auto stats = getStats();
+	repoDebug << "Mongo connection pool: " << stats.pops << " requests, " << stats.waits << " waited ("
+		<< stats.timeouts << " timed out), total wait: " << stats.totalWaitMs << "ms, longest wait: " << stats.maxWaitMs
+		<< "ms, max connections in use: " << stats.highWaterMark;
 	delete auth;
 	//free workers within the pool
 	std::vector<mongo::DBClientBase*> workers = empty();
@@ -61,6 +61,14 @@ namespace repo{
 						push(worker);
 					}
 
+					/**
+					* @return returns the usage statistics of the pool
+					*/
+					repo::lib::RepoStackStats getStats() const
+					{
+						return RepoStack::getStats();
+					}
+
 
 				private:
 					mongo::DBClientBase* pop();
@@ -0,0 +1,125 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_commit_pipeline.h"
+
+#include <boost/bind.hpp>
+
+#include "../../lib/repo_log.h"
+
+using namespace repo::core::handler;
+
+CommitPipeline::CommitPipeline(
+	AbstractDatabaseHandler *handler,
+	const uint32_t          &nWriters,
+	const size_t            &queueLimit)
+	: handler(handler),
+	finishing(false),
+	finished(false),
+	success(true)
+{
+	uint32_t writerCount = nWriters ? nWriters : (handler ? handler->connectionLimit() : 1);
+	if (!writerCount) writerCount = 1;
+	maxQueued = queueLimit ? queueLimit : writerCount * 2;
+
+	repoTrace << "Starting commit pipeline with " << writerCount << " writers";
+	for (uint32_t i = 0; i < writerCount; ++i)
+	{
+		writers.create_thread(boost::bind(&CommitPipeline::writerLoop, this));
+	}
+}
+
+CommitPipeline::~CommitPipeline()
+{
+	std::string errMsg;
+	finish(errMsg);
+}
+
+bool CommitPipeline::push(const Job &job)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	if (finishing)
+	{
+		//The write would be lost otherwise, report it on the next finish()
+		repoError << "Trying to push a job onto a commit pipeline that has finished";
+		success = false;
+		errors += "Job pushed onto a finished commit pipeline was dropped;";
+		return false;
+	}
+
+	while (jobs.size() >= maxQueued)
+		spaceAvailable.wait(lock);
+
+	jobs.push_back(job);
+	jobAvailable.notify_one();
+	return true;
+}
+
+bool CommitPipeline::finish(std::string &errMsg)
+{
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		finishing = true;
+		jobAvailable.notify_all();
+	}
+
+	if (!finished)
+	{
+		writers.join_all();
+		finished = true;
+	}
+
+	errMsg += errors;
+	errors.clear();
+	return success;
+}
+
+void CommitPipeline::writerLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (jobs.empty() && !finishing)
+				jobAvailable.wait(lock);
+
+			if (jobs.empty()) return;
+
+			job = jobs.front();
+			jobs.pop_front();
+			spaceAvailable.notify_one();
+		}
+
+		std::string errMsg;
+		bool jobSuccess = false;
+		try{
+			jobSuccess = job(handler, errMsg);
+		}
+		catch (std::exception &e)
+		{
+			errMsg += e.what();
+		}
+
+		if (!jobSuccess)
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			success = false;
+			errors += errMsg;
+		}
+	}
+}
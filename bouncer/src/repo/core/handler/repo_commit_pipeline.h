@@ -0,0 +1,97 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Commit pipeline - spreads database writes over a number of writer threads.
+* Each writer performs its writes through the database handler, which hands
+* it a connection from the pool for the duration of the write.
+* Jobs are queued in a bounded queue: pushing blocks while the queue is full
+* so the caller cannot get arbitrarily far ahead of the database.
+*/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include "repo_database_handler_abstract.h"
+
+namespace repo{
+	namespace core{
+		namespace handler {
+			class CommitPipeline
+			{
+			public:
+				/**
+				* A write job, returns true upon success and fills in errMsg otherwise
+				*/
+				typedef std::function<bool(AbstractDatabaseHandler *handler, std::string &errMsg)> Job;
+
+				/**
+				* Start the writer threads
+				* @param handler database handler the jobs are given
+				* @param nWriters number of writer threads (0 = one per pooled connection)
+				* @param queueLimit maximum number of pending jobs (0 = twice the number of writers)
+				*/
+				CommitPipeline(
+					AbstractDatabaseHandler *handler,
+					const uint32_t          &nWriters = 0,
+					const size_t            &queueLimit = 0);
+
+				/**
+				* Waits for any outstanding jobs before returning
+				*/
+				~CommitPipeline();
+
+				/**
+				* Queue a job, blocks while the queue is full
+				* A job pushed after finish() is not run and fails the pipeline
+				* @param job job to queue
+				* @return returns true if the job is queued
+				*/
+				bool push(const Job &job);
+
+				/**
+				* Wait for all queued jobs to complete and stop the writers
+				* No jobs can be pushed after this is called.
+				* @param errMsg error messages of failed jobs are appended to this
+				* @return returns true if every job succeeded
+				*/
+				bool finish(std::string &errMsg);
+
+			private:
+				void writerLoop();
+
+				AbstractDatabaseHandler *handler;
+				size_t maxQueued;
+				std::deque<Job> jobs;
+				boost::thread_group writers;
+				boost::mutex mutex;
+				boost::condition_variable jobAvailable;
+				boost::condition_variable spaceAvailable;
+				bool finishing;
+				bool finished;
+				bool success;
+				std::string errors;
+			};
+		}
+	}
+}
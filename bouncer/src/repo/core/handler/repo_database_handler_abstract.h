@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <functional>
 #include <list>
 #include <map>
 #include <string>
@@ -37,6 +38,16 @@ namespace repo{
 		namespace handler {
 			class AbstractDatabaseHandler {
 			public:
+				/**
+				* Receives a chunk of a raw file, returns false to stop reading
+				*/
+				typedef std::function<bool(const uint8_t *data, const size_t &size)> RawFileSink;
+
+				/**
+				* Receives a batch of query results, returns false to stop the query
+				* The documents may be moved out of the batch.
+				*/
+				typedef std::function<bool(std::vector<repo::core::model::RepoBSON> &batch)> BSONBatchConsumer;
 
 				/**
 				 * A Deconstructor
@@ -49,6 +60,13 @@ namespace repo{
 				*/
                                 uint64_t documentSizeLimit() { return maxDocumentSize; }
 
+				/**
+				* returns the maximum number of concurrent connections
+				* this handler can hold to the database
+				* @return returns the number of connections
+				*/
+				uint32_t connectionLimit() { return maxConnections; }
+
 				///**
 				//* Generates a BSON object containing user credentials
 				//* @param username user name for authentication
@@ -196,6 +214,22 @@ namespace repo{
 					const repo::core::model::RepoBSON &obj,
 					std::string &errMsg) = 0;
 
+				/**
+				* Insert multiple documents in database.collection
+				* Documents are sent in as few round trips as the
+				* message size limits allow.
+				* @param database name
+				* @param collection name
+				* @param objs documents to insert
+				* @param errMsg error message should it fail
+				* @return returns true upon success
+				*/
+				virtual bool insertManyDocuments(
+					const std::string &database,
+					const std::string &collection,
+					const std::vector<repo::core::model::RepoBSON> &objs,
+					std::string &errMsg) = 0;
+
 				/**
 				* Insert big raw file in binary format (using GridFS)
 				* @param database name
@@ -366,6 +400,23 @@ namespace repo{
 					const std::string& collection,
 					const repo::core::model::RepoBSON& criteria) = 0;
 
+				/**
+				* Given a search criteria, find all the documents that passes this query
+				* and hand them to the consumer batch by batch as they arrive
+				* @param database name of database
+				* @param collection name of collection
+				* @param criteria search criteria in a bson object
+				* @param consumer called with each batch of results, in order
+				* @param projection fields to return as a mongo projection (empty for whole documents)
+				* @return returns true if the query completed and the consumer accepted every batch
+				*/
+				virtual bool findAllByCriteria(
+					const std::string& database,
+					const std::string& collection,
+					const repo::core::model::RepoBSON& criteria,
+					const BSONBatchConsumer& consumer,
+					const repo::core::model::RepoBSON& projection = repo::core::model::RepoBSON()) = 0;
+
 				/**
 				* Given a search criteria,  find one documents that passes this query
 				* @param database name of database
@@ -392,6 +443,23 @@ namespace repo{
 					const std::string& collection,
 					const repo::core::model::RepoBSON& uuid) = 0;
 
+				/**
+				* Given a list of unique IDs, find all the documents associated to them
+				* and hand them to the consumer batch by batch as they arrive
+				* @param name of database
+				* @param name of collection
+				* @param array of uuids in a BSON object
+				* @param consumer called with each batch of results, in order
+				* @param projection fields to return as a mongo projection (empty for whole documents)
+				* @return returns true if the query completed and the consumer accepted every batch
+				*/
+				virtual bool findAllByUniqueIDs(
+					const std::string& database,
+					const std::string& collection,
+					const repo::core::model::RepoBSON& uuid,
+					const BSONBatchConsumer& consumer,
+					const repo::core::model::RepoBSON& projection = repo::core::model::RepoBSON()) = 0;
+
 				/**
 				*Retrieves the first document matching given Shared ID (SID), sorting is descending
 				* (newest first)
@@ -432,14 +500,33 @@ namespace repo{
 					const std::string& fname
 					) = 0;
 
+				/**
+				* Stream a raw binary file from database, chunk by chunk,
+				* without holding the whole file in memory
+				* @param database name of database
+				* @param collection name of collection
+				* @param fname name of the file
+				* @param sink called with each chunk in order, returning false stops the read
+				* @return returns true if the whole file was passed to the sink
+				*/
+				virtual bool streamRawFile(
+					const std::string& database,
+					const std::string& collection,
+					const std::string& fname,
+					const RawFileSink& sink
+					) = 0;
+
 			protected:
 				/**
 				* Default constructor
 				* @param size maximum size of documents(records) in bytes
+				* @param connections maximum number of concurrent connections
 				*/
-				AbstractDatabaseHandler(uint64_t size) :maxDocumentSize(size){};
+				AbstractDatabaseHandler(uint64_t size, uint32_t connections = 1)
+					:maxDocumentSize(size), maxConnections(connections ? connections : 1){};
 
 				const uint64_t maxDocumentSize;
+				const uint32_t maxConnections;
 			};
 		}
 	}
@@ -19,15 +19,44 @@
 *  Mongo database handler
 */
 
+#include <deque>
+#include <iterator>
 #include <regex>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
+
+#include <boost/thread.hpp>
 
 #include "repo_database_handler_mongo.h"
+#include "../model/bson/repo_node_mesh.h"
 #include "../../lib/repo_log.h"
 
 using namespace repo::core::handler;
 
 static uint64_t MAX_MONGO_BSON_SIZE = 16777216L;
+static const size_t MAX_IDS_PER_QUERY = 5000;
+static const int MAX_QUERY_ATTEMPTS = 3;
+
+/**
+* Pass every chunk of a GridFS file to the sink, in order
+* @return returns true if every chunk was accepted by the sink
+*/
+static bool readGridFile(
+	const mongo::GridFile &file,
+	const repo::core::handler::AbstractDatabaseHandler::RawFileSink &sink)
+{
+	const int nChunks = file.getNumChunks();
+	for (int i = 0; i < nChunks; ++i)
+	{
+		mongo::GridFSChunk chunk = file.getChunk(i);
+		int len = 0;
+		const char *data = chunk.data(len);
+		if (len < 0 || !sink((const uint8_t*)data, len))
+			return false;
+	}
+	return true;
+}
 //------------------------------------------------------------------------------
 
 const std::string repo::core::handler::MongoDatabaseHandler::ID = "_id";
@@ -52,10 +81,10 @@ MongoDatabaseHandler::MongoDatabaseHandler(
 	const std::string             &username,
 	const std::string             &password,
 	const bool                    &pwDigested) :
-	AbstractDatabaseHandler(MAX_MONGO_BSON_SIZE)
+	AbstractDatabaseHandler(MAX_MONGO_BSON_SIZE, maxConnections)
 {
 	mongo::client::initialize();
-	workerPool = new connectionPool::MongoConnectionPool(maxConnections, dbAddress, createAuthBSON(dbName, username, password, pwDigested));
+	workerPool.reset(new connectionPool::MongoConnectionPool(maxConnections, dbAddress, createAuthBSON(dbName, username, password, pwDigested)));
 }
 
 MongoDatabaseHandler::MongoDatabaseHandler(
@@ -63,10 +92,10 @@ MongoDatabaseHandler::MongoDatabaseHandler(
 	const uint32_t                &maxConnections,
 	const std::string             &dbName,
 	const repo::core::model::RepoBSON  *cred) :
-	AbstractDatabaseHandler(MAX_MONGO_BSON_SIZE)
+	AbstractDatabaseHandler(MAX_MONGO_BSON_SIZE, maxConnections)
 {
 	mongo::client::initialize();
-	workerPool = new connectionPool::MongoConnectionPool(maxConnections, dbAddress, (mongo::BSONObj*)cred);
+	workerPool.reset(new connectionPool::MongoConnectionPool(maxConnections, dbAddress, (mongo::BSONObj*)cred));
 }
 
 /**
@@ -74,8 +103,8 @@ MongoDatabaseHandler::MongoDatabaseHandler(
 */
 MongoDatabaseHandler::~MongoDatabaseHandler()
 {
-	if (workerPool)
-		delete workerPool;
+	//The pool itself is released once the last document fetching files through it is gone
+	workerPool.reset();
 }
 
 bool MongoDatabaseHandler::caseInsensitiveStringCompare(
@@ -189,24 +218,35 @@ void MongoDatabaseHandler::createIndex(const std::string &database, const std::s
 }
 
 repo::core::model::RepoBSON MongoDatabaseHandler::createRepoBSON(
-	mongo::DBClientBase *worker,
 	const std::string &database,
 	const std::string &collection,
 	const mongo::BSONObj &obj)
 {
-	repo::core::model::RepoBSON orgBson = repo::core::model::RepoBSON(obj);
-
-	std::vector<std::pair<std::string, std::string>> extFileList = orgBson.getFileList();
-
-	std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t>> > binMap;
-
-	for (const auto &pair : extFileList)
+	//External files are only fetched from GridFS when they are first accessed.
+	//The document may outlive this handler, so the loader holds on to the pool instead.
+	auto pool = workerPool;
+	return repo::core::model::RepoBSON(obj, [pool, database, collection](const std::string &fileName, std::vector<uint8_t> &data)
 	{
-		repoTrace << "Found existing GridFS reference, retrieving file @ " << database << "." << collection << ":" << pair.first;
-		binMap[pair.first] = std::pair<std::string, std::vector<uint8_t>>(pair.second, getBigFile(worker, database, collection, pair.second));
-	}
+		repoTrace << "Fetching GridFS file @ " << database << "." << collection << ":" << fileName;
+		bool success = false;
+		mongo::DBClientBase *worker = nullptr;
+		try{
+			worker = pool->getWorker();
+			if (worker)
+				success = getBigFile(worker, database, collection, fileName, data);
+			else
+				repoError << "Failed to fetch GridFS file: cannot obtain a database worker from the pool";
+		}
+		catch (mongo::DBException &e)
+		{
+			repoError << "Error fetching GridFS file " << fileName << ": " << e.what();
+		}
 
-	return repo::core::model::RepoBSON(obj, binMap);
+		if (worker)
+			pool->returnWorker(worker);
+
+		return success;
+	});
 }
 
 void MongoDatabaseHandler::disconnectHandler()
@@ -431,44 +471,28 @@ std::vector<repo::core::model::RepoBSON> MongoDatabaseHandler::findAllByCriteria
 	const repo::core::model::RepoBSON& criteria)
 {
 	std::vector<repo::core::model::RepoBSON> data;
-
-	if (!criteria.isEmpty())
+	findAllByCriteria(database, collection, criteria,
+		[&data](std::vector<repo::core::model::RepoBSON> &batch)
 	{
-		mongo::DBClientBase *worker;
-		try{
-			uint64_t retrieved = 0;
-			std::auto_ptr<mongo::DBClientCursor> cursor;
-			worker = workerPool->getWorker();
-			if (worker)
-			{
-				do
-				{
-					repoTrace << " Querying " << database << "." << collection << " with : " << criteria.toString();
-					cursor = worker->query(
-						database + "." + collection,
-						criteria,
-						0,
-						retrieved);
-
-					for (; cursor.get() && cursor->more(); ++retrieved)
-					{
-						data.push_back(createRepoBSON(worker, database, collection, cursor->nextSafe().copy()));
-					}
-				} while (cursor.get() && cursor->more());
-			}
-			else
-				repoError << "Failed to count number of items in collection: cannot obtain a database worker from the pool";
-		}
-		catch (mongo::DBException& e)
-		{
-			repoError << "Error in MongoDatabaseHandler::findAllByCriteria: " << e.what();
-		}
-
-		workerPool->returnWorker(worker);
-	}
+		data.insert(data.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+		return true;
+	});
 	return data;
 }
 
+bool MongoDatabaseHandler::findAllByCriteria(
+	const std::string& database,
+	const std::string& collection,
+	const repo::core::model::RepoBSON& criteria,
+	const BSONBatchConsumer& consumer,
+	const repo::core::model::RepoBSON& projection)
+{
+	if (criteria.isEmpty()) return false;
+
+	uint64_t retrieved = 0;
+	return streamQuery(database, collection, mongo::Query(criteria), projection, consumer, retrieved);
+}
+
 repo::core::model::RepoBSON MongoDatabaseHandler::findOneByCriteria(
 	const std::string& database,
 	const std::string& collection,
@@ -510,53 +534,203 @@ std::vector<repo::core::model::RepoBSON> MongoDatabaseHandler::findAllByUniqueID
 	const std::string& collection,
 	const repo::core::model::RepoBSON& uuids){
 	std::vector<repo::core::model::RepoBSON> data;
+	findAllByUniqueIDs(database, collection, uuids,
+		[&data](std::vector<repo::core::model::RepoBSON> &batch)
+	{
+		data.insert(data.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+		return true;
+	});
+	return data;
+}
 
-	mongo::BSONArray array = mongo::BSONArray(uuids);
-	int fieldsCount = array.nFields();
-	if (fieldsCount > 0)
+bool MongoDatabaseHandler::findAllByUniqueIDs(
+	const std::string& database,
+	const std::string& collection,
+	const repo::core::model::RepoBSON& uuids,
+	const BSONBatchConsumer& consumer,
+	const repo::core::model::RepoBSON& projection){
+	//Split the IDs into chunks so each $in query stays small and chunks can be read in parallel
+	std::vector<std::vector<mongo::BSONElement>> chunks;
+	mongo::BSONObjIterator idIt(uuids);
+	size_t fieldsCount = 0;
+	while (idIt.more())
 	{
-		mongo::DBClientBase *worker;
+		if (!chunks.size() || chunks.back().size() >= MAX_IDS_PER_QUERY)
+			chunks.push_back(std::vector<mongo::BSONElement>());
+		chunks.back().push_back(idIt.next());
+		++fieldsCount;
+	}
+
+	if (!chunks.size()) return true;
+
+	struct ChunkResult
+	{
+		std::vector<repo::core::model::RepoBSON> docs;
+		bool done = false;
+		bool success = false;
+	};
+	std::vector<ChunkResult> results(chunks.size());
+
+	const uint32_t nReaders = std::max<uint32_t>(1, std::min<uint32_t>(connectionLimit(), chunks.size()));
+	//Readers may only get this many chunks ahead of the consumer, bounding the memory held
+	const size_t maxAhead = nReaders * 2;
+	size_t nextChunk = 0, consumed = 0;
+	bool aborted = false;
+	boost::mutex mutex;
+	boost::condition_variable chunkDone, spaceAvailable;
+
+	auto reader = [&]()
+	{
+		while (true)
+		{
+			size_t idx;
+			{
+				boost::mutex::scoped_lock lock(mutex);
+				while (!aborted && nextChunk < chunks.size() && nextChunk >= consumed + maxAhead)
+					spaceAvailable.wait(lock);
+				if (aborted || nextChunk >= chunks.size()) return;
+				idx = nextChunk++;
+			}
+
+			std::vector<repo::core::model::RepoBSON> docs;
+			bool success = findByUniqueIDs(database, collection, chunks[idx], projection, docs);
+
+			boost::mutex::scoped_lock lock(mutex);
+			results[idx].docs = std::move(docs);
+			results[idx].success = success;
+			results[idx].done = true;
+			chunkDone.notify_all();
+		}
+	};
+
+	repoTrace << "Querying " << fieldsCount << " IDs from " << database << "." << collection
+		<< " in " << chunks.size() << " chunks with " << nReaders << " connections";
+	boost::thread_group readers;
+	for (uint32_t i = 0; i < nReaders; ++i)
+		readers.create_thread(reader);
+
+	//Hand the chunks over in order, whichever reader finished first
+	bool success = true;
+	size_t retrieved = 0;
+	for (size_t i = 0; i < chunks.size() && success; ++i)
+	{
+		std::vector<repo::core::model::RepoBSON> docs;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (!results[i].done)
+				chunkDone.wait(lock);
+
+			success = results[i].success;
+			docs = std::move(results[i].docs);
+			consumed = i + 1;
+			spaceAvailable.notify_all();
+		}
+
+		if (success)
+		{
+			retrieved += docs.size();
+			try{
+				success = consumer(docs);
+			}
+			catch (std::exception &e)
+			{
+				repoError << "Failed to process documents from " << database << "." << collection << ": " << e.what();
+				success = false;
+			}
+		}
+	}
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		aborted = true;
+		spaceAvailable.notify_all();
+	}
+	readers.join_all();
+
+	if (success && fieldsCount != retrieved){
+		repoWarning << "Number of documents(" << retrieved << ") retreived by findAllByUniqueIDs did not match the number of unique IDs(" << fieldsCount << ")!";
+	}
+
+	return success;
+}
+
+bool MongoDatabaseHandler::findByUniqueIDs(
+	const std::string &database,
+	const std::string &collection,
+	const std::vector<mongo::BSONElement> &ids,
+	const mongo::BSONObj &projection,
+	std::vector<repo::core::model::RepoBSON> &docs)
+{
+	//Key of an ID, identical for the element in the query and the _id of the document
+	auto idKey = [](const mongo::BSONElement &e) { return std::string(e.value(), e.valuesize()); };
+
+	std::unordered_set<std::string> retrievedIDs;
+	std::vector<mongo::BSONElement> remaining = ids;
+	bool success = false;
+	for (int attempt = 0; !success && attempt < MAX_QUERY_ATTEMPTS; ++attempt)
+	{
+		if (attempt)
+		{
+			//Carry on from where the cursor died by asking only for the documents not retrieved yet
+			std::vector<mongo::BSONElement> notRetrieved;
+			for (const auto &id : remaining)
+			{
+				if (retrievedIDs.find(idKey(id)) == retrievedIDs.end())
+					notRetrieved.push_back(id);
+			}
+			remaining.swap(notRetrieved);
+			repoWarning << "Query on " << database << "." << collection << " failed, retrying for the remaining " << remaining.size() << " IDs";
+			if (!remaining.size())
+			{
+				success = true;
+				break;
+			}
+		}
+
+		mongo::DBClientBase *worker = nullptr;
 		try{
-			uint64_t retrieved = 0;
-			std::auto_ptr<mongo::DBClientCursor> cursor;
 			worker = workerPool->getWorker();
 			if (worker)
 			{
-				do
+				mongo::BSONArrayBuilder array;
+				for (const auto &id : remaining)
+					array.append(id);
+
+				mongo::BSONObjBuilder query;
+				query << ID << BSON("$in" << array.arr());
+
+				//The projection must not exclude _id, it tells which documents have been retrieved
+				std::auto_ptr<mongo::DBClientCursor> cursor = worker->query(
+					getNamespace(database, collection),
+					query.obj(),
+					0,
+					0,
+					projection.isEmpty() ? nullptr : &projection);
+
+				while (cursor.get() && cursor->more())
 				{
-					mongo::BSONObjBuilder query;
-					query << ID << BSON("$in" << array);
-
-					cursor = worker->query(
-						database + "." + collection,
-						query.obj(),
-						0,
-						retrieved);
-
-					for (; cursor.get() && cursor->more(); ++retrieved)
-					{
-						data.push_back(createRepoBSON(worker, database, collection, cursor->nextSafe().copy()));
-					}
-				} while (cursor.get() && cursor->more());
+					//have to copy since the bson info gets cleaned up when cursor gets out of scope
+					mongo::BSONObj obj = cursor->nextSafe().copy();
+					retrievedIDs.insert(idKey(obj.getField(ID)));
+					docs.push_back(createRepoBSON(database, collection, obj));
+				}
+				success = cursor.get() != nullptr;
 			}
 			else
 			{
-				repoError << "Failed to count number of items in collection: cannot obtain a database worker from the pool";
-			}
-
-			if (fieldsCount != retrieved){
-				repoWarning << "Number of documents(" << retrieved << ") retreived by findAllByUniqueIDs did not match the number of unique IDs(" << fieldsCount << ")!";
+				repoError << "Failed to query " << database << "." << collection << ": cannot obtain a database worker from the pool";
 			}
 		}
 		catch (mongo::DBException& e)
 		{
-			repoError << e.what();
+			repoError << "Error querying " << database << "." << collection << ": " << e.what();
 		}
 
-		workerPool->returnWorker(worker);
+		if (worker)
+			workerPool->returnWorker(worker);
 	}
 
-	return data;
+	return success;
 }
 
 repo::core::model::RepoBSON MongoDatabaseHandler::findOneBySharedID(
@@ -584,7 +758,7 @@ repo::core::model::RepoBSON MongoDatabaseHandler::findOneBySharedID(
 				getNamespace(database, collection),
 				query);
 
-			bson = createRepoBSON(worker, database, collection, bsonMongo);
+			bson = createRepoBSON(database, collection, bsonMongo);
 		}
 		else
 		{
@@ -617,7 +791,7 @@ repo::core::model::RepoBSON  MongoDatabaseHandler::findOneByUniqueID(
 			mongo::BSONObj bsonMongo = worker->findOne(getNamespace(database, collection),
 				mongo::Query(queryBuilder.obj()));
 
-			bson = createRepoBSON(worker, database, collection, bsonMongo);
+			bson = createRepoBSON(database, collection, bsonMongo);
 		}
 		else
 			repoError << "Failed to count number of items in collection: cannot obtain a database worker from the pool";
@@ -660,7 +834,7 @@ const int									  &sortOrder)
 			while (cursor.get() && cursor->more())
 			{
 				//have to copy since the bson info gets cleaned up when cursor gets out of scope
-				bsons.push_back(createRepoBSON(worker, database, collection, cursor->nextSafe().copy()));
+				bsons.push_back(createRepoBSON(database, collection, cursor->nextSafe().copy()));
 			}
 		}
 		else
@@ -796,42 +970,50 @@ repo::core::model::DatabaseStats MongoDatabaseHandler::getDatabaseStats(
 	return repo::core::model::DatabaseStats(info);
 }
 
-std::vector<uint8_t> MongoDatabaseHandler::getBigFile(
-	mongo::DBClientBase *worker,
-	const std::string &database,
-	const std::string &collection,
-	const std::string &fileName)
+bool MongoDatabaseHandler::getBigFile(
+	mongo::DBClientBase  *worker,
+	const std::string    &database,
+	const std::string    &collection,
+	const std::string    &fileName,
+	std::vector<uint8_t> &bin)
 {
 	mongo::GridFS gfs(*worker, database, collection);
 	mongo::GridFile tmpFile = gfs.findFileByName(fileName);
 
-	std::vector<uint8_t> bin;
-	if (tmpFile.exists())
+	bin.clear();
+	if (!tmpFile.exists())
 	{
-		std::ostringstream oss;
-		tmpFile.write(oss);
+		repoError << "Failed to find file within GridFS";
+		return false;
+	}
 
-		std::string fileStr = oss.str();
+	const size_t length = tmpFile.getContentLength();
+	if (!length)
+	{
+		repoWarning << "GridFS file : " << fileName << " in "
+			<< database << "." << collection << " is empty.";
+		return true;
+	}
 
-		assert(sizeof(*fileStr.c_str()) == sizeof(uint8_t));
+	bin.resize(length);
+	size_t offset = 0;
+	bool success = readGridFile(tmpFile, [&](const uint8_t *data, const size_t &size)
+	{
+		if (offset + size > length) return false;
+		memcpy(&bin[offset], data, size);
+		offset += size;
+		return true;
+	});
 
-		if (!fileStr.empty())
-		{
-			bin.resize(fileStr.size());
-			memcpy(&bin[0], fileStr.c_str(), fileStr.size());
-		}
-		else
-		{
-			repoError << "GridFS file : " << fileName << " in "
-				<< database << "." << collection << " is empty.";
-		}
-	}
-	else
+	if (!success || offset != length)
 	{
-		repoError << "Failed to find file within GridFS";
+		repoError << "GridFS file : " << fileName << " in "
+			<< database << "." << collection << " is corrupted (read " << offset << " of " << length << " bytes).";
+		bin.clear();
+		return false;
 	}
 
-	return bin;
+	return true;
 }
 
 std::string MongoDatabaseHandler::getProjectFromCollection(const std::string &ns, const std::string &projectExt)
@@ -973,52 +1155,63 @@ std::vector<uint8_t> MongoDatabaseHandler::getRawFile(
 {
 	std::vector<uint8_t> bin;
 
-	mongo::DBClientBase *worker;
+	mongo::DBClientBase *worker = nullptr;
 	try{
 		worker = workerPool->getWorker();
 		if (worker)
 		{
-			mongo::GridFS gfs(*worker, database, collection);
-			mongo::GridFile tmpFile = gfs.findFileByName(fname);
-
 			repoTrace << "Getting file from GridFS: " << fname << " in : " << database << "." << collection;
+			getBigFile(worker, database, collection, fname, bin);
+		}
+		else
+			repoError << "Failed to get raw file: cannot obtain a database worker from the pool";
+	}
+	catch (mongo::DBException &e)
+	{
+		repoError << "Error fetching raw file: " << e.what();
+	}
 
-			if (tmpFile.exists())
-			{
-				std::ostringstream oss;
-				tmpFile.write(oss);
+	if (worker)
+		workerPool->returnWorker(worker);
 
-				std::string fileStr = oss.str();
+	return bin;
+}
 
-				assert(sizeof(*fileStr.c_str()) == sizeof(uint8_t));
+bool MongoDatabaseHandler::streamRawFile(
+	const std::string& database,
+	const std::string& collection,
+	const std::string& fname,
+	const RawFileSink& sink
+	)
+{
+	bool success = false;
 
-				if (!fileStr.empty())
-				{
-					bin.resize(fileStr.size());
-					memcpy(&bin[0], fileStr.c_str(), fileStr.size());
-				}
-				else
-				{
-					repoError << "GridFS file : " << fname << " in "
-						<< database << "." << collection << " is empty.";
-				}
-			}
+	mongo::DBClientBase *worker = nullptr;
+	try{
+		worker = workerPool->getWorker();
+		if (worker)
+		{
+			repoTrace << "Streaming file from GridFS: " << fname << " in : " << database << "." << collection;
+			mongo::GridFS gfs(*worker, database, collection);
+			mongo::GridFile tmpFile = gfs.findFileByName(fname);
+			if (tmpFile.exists())
+				success = readGridFile(tmpFile, sink);
 			else
-			{
 				repoError << "Failed to find file within GridFS";
-			}
 		}
 		else
-			repoError << "Failed to count number of items in collection: cannot obtain a database worker from the pool";
+			repoError << "Failed to stream raw file: cannot obtain a database worker from the pool";
 	}
-	catch (mongo::DBException e)
+	catch (mongo::DBException &e)
 	{
-		repoError << "Error fetching raw file: " << e.what();
+		success = false;
+		repoError << "Error streaming raw file: " << e.what();
 	}
 
-	workerPool->returnWorker(worker);
+	if (worker)
+		workerPool->returnWorker(worker);
 
-	return bin;
+	return success;
 }
 
 bool MongoDatabaseHandler::insertDocument(
@@ -1031,13 +1224,15 @@ bool MongoDatabaseHandler::insertDocument(
 	mongo::DBClientBase *worker;
 	if (!database.empty() || collection.empty())
 	{
+		//Fetching external files needs a connection of its own, do it before taking one
+		obj.prefetchBigFiles();
 		try{
 			worker = workerPool->getWorker();
 			if (worker)
 			{
 				worker->insert(getNamespace(database, collection), obj);
 
-				success = storeBigFiles(worker, database, collection, obj, errMsg);
+				success = storeBigFiles(worker, database, collection, { &obj }, errMsg);
 			}
 			else
 				errMsg = "Failed to count number of items in collection: cannot obtain a database worker from the pool";
@@ -1058,6 +1253,71 @@ bool MongoDatabaseHandler::insertDocument(
 	return success;
 }
 
+bool MongoDatabaseHandler::insertManyDocuments(
+	const std::string &database,
+	const std::string &collection,
+	const std::vector<repo::core::model::RepoBSON> &objs,
+	std::string &errMsg)
+{
+	if (database.empty() || collection.empty())
+	{
+		errMsg = "Unable to insert Documents, database(value : " + database + ")/collection(value : " + collection + ") name was not specified";
+		return false;
+	}
+
+	if (!objs.size()) return true;
+
+	//Fetching external files needs a connection of its own, do it before taking one
+	std::vector<const repo::core::model::RepoBSON*> withFiles;
+	for (const auto &obj : objs)
+	{
+		if (obj.hasOversizeFiles())
+			withFiles.push_back(&obj);
+	}
+	repo::core::model::RepoBSON::prefetchBigFiles(withFiles, 1);
+
+	bool success = false;
+	mongo::DBClientBase *worker = nullptr;
+	try{
+		worker = workerPool->getWorker();
+		if (worker)
+		{
+			success = true;
+			const std::string ns = getNamespace(database, collection);
+			std::vector<mongo::BSONObj> batch;
+			uint64_t batchBytes = 0;
+			for (size_t i = 0; i < objs.size(); ++i)
+			{
+				batch.push_back(objs[i]);
+				batchBytes += objs[i].objsize();
+
+				const bool lastDoc = i + 1 == objs.size();
+				if (lastDoc || batchBytes + objs[i + 1].objsize() > maxDocumentSize)
+				{
+					worker->insert(ns, batch);
+					batch.clear();
+					batchBytes = 0;
+				}
+			}
+
+			success = storeBigFiles(worker, database, collection, withFiles, errMsg);
+		}
+		else
+			errMsg = "Failed to insert documents: cannot obtain a database worker from the pool";
+	}
+	catch (mongo::DBException &e)
+	{
+		success = false;
+		std::string errString(e.what());
+		errMsg += errString;
+	}
+
+	if (worker)
+		workerPool->returnWorker(worker);
+
+	return success;
+}
+
 bool MongoDatabaseHandler::insertRawFile(
 	const std::string          &database,
 	const std::string          &collection,
@@ -1284,6 +1544,9 @@ bool MongoDatabaseHandler::upsertDocument(
 	bool success = true;
 	mongo::DBClientBase *worker;
 
+	//Fetching external files needs a connection of its own, do it before taking one
+	obj.prefetchBigFiles();
+
 	bool upsert = overwrite;
 	try{
 		worker = workerPool->getWorker();
@@ -1333,7 +1596,7 @@ bool MongoDatabaseHandler::upsertDocument(
 			}
 
 			if (success)
-				success = storeBigFiles(worker, database, collection, obj, errMsg);
+				success = storeBigFiles(worker, database, collection, { &obj }, errMsg);
 		}
 		else
 			errMsg = "Failed to count number of items in collection: cannot obtain a database worker from the pool";
@@ -1353,38 +1616,266 @@ bool MongoDatabaseHandler::storeBigFiles(
 	mongo::DBClientBase *worker,
 	const std::string &database,
 	const std::string &collection,
-	const repo::core::model::RepoBSON &obj,
+	const std::vector<const repo::core::model::RepoBSON*> &objs,
 	std::string &errMsg
 	)
 {
 	bool success = true;
 
-	//insert files into gridFS if applicable
-	if (obj.hasOversizeFiles())
+	//files to store, as the document holding it, its field and its name in GridFS
+	std::vector<std::tuple<const repo::core::model::RepoBSON*, std::string, std::string>> files;
+	std::vector<std::string> geometryFiles;
+	for (const auto &obj : objs)
+	{
+		if (!obj->hasOversizeFiles()) continue;
+		for (const auto &file : obj->getFileList())
+		{
+			files.push_back(std::make_tuple(obj, file.first, file.second));
+			if (repo::core::model::MeshNode::isGeometryFileName(file.second))
+				geometryFiles.push_back(file.second);
+		}
+	}
+
+	if (!files.size()) return true;
+	repoTrace << "storeBigFiles: #oversized files: " << files.size();
+
+	//Files named after their content are not stored again if they exist already,
+	//other files are always written as their content may have changed.
+	//Revision clean up never drops files named after their content, so a file found here stays.
+	std::unordered_set<std::string> skipFiles = findGridFSFiles(worker, database, collection, geometryFiles);
+
+	mongo::GridFS gfs(*worker, database, collection);
+	auto storeFile = [&](const repo::core::model::RepoBSON *obj, const std::string &field, const std::string &fileName)
+	{
+		//The caller holds a worker, fetching now would take a second one from the pool.
+		//Files of documents read from the database are fetched before the worker is taken.
+		const std::vector<uint8_t> *binary = obj->findBigFile(field, false);
+		if (!binary)
+		{
+			repoError << "A oversized entry exist but binary not found or failed to fetch!";
+			return false;
+		}
+
+		//store the big biary file within GridFS
+		//FIXME: there must be errors to catch...
+		repoTrace << "storing " << fileName << "(" << field << ") in gridfs: " << database << "." << collection;
+		mongo::BSONObj bson = gfs.storeFile((char*)binary->data(), binary->size() * sizeof((*binary)[0]), fileName);
+
+		repoTrace << "returned object: " << bson.toString();
+		return true;
+	};
+
+	for (const auto &file : files)
 	{
-		const std::vector<std::pair<std::string, std::string>> fNames = obj.getFileList();
-		repoTrace << "storeBigFiles: #oversized files: " << fNames.size();
+		const auto &obj = std::get<0>(file);
+		const auto &field = std::get<1>(file);
+		const auto &fileName = std::get<2>(file);
+
+		if (!repo::core::model::MeshNode::isGeometryFileName(fileName))
+		{
+			success &= storeFile(obj, field, fileName);
+			continue;
+		}
 
-		for (const auto &file : fNames)
+		if (!skipFiles.insert(fileName).second)
 		{
-			std::vector<uint8_t> binary = obj.getBigBinary(file.first);
-			if (binary.size())
+			repoTrace << fileName << " already exists in gridfs: " << database << "." << collection << ", skipping";
+			continue;
+		}
+
+		//Another writer may be storing the same file, in which case its result is taken
+		const std::string fileKey = getNamespace(database, collection) + "/" + fileName;
+		std::shared_ptr<FileUpload> upload;
+		{
+			boost::mutex::scoped_lock lock(filesInFlightMutex);
+			auto it = filesInFlight.find(fileKey);
+			if (it != filesInFlight.end())
 			{
-				//store the big biary file within GridFS
-				mongo::GridFS gfs(*worker, database, collection);
-				//FIXME: there must be errors to catch...
-				repoTrace << "storing " << file.second << "(" << file.first << ") in gridfs: " << database << "." << collection;
-				mongo::BSONObj bson = gfs.storeFile((char*)&binary[0], binary.size() * sizeof(binary[0]), file.second);
+				repoTrace << fileName << " is being stored by another writer, waiting for it";
+				auto otherUpload = it->second;
+				while (!otherUpload->done)
+					fileUploaded.wait(lock);
 
-				repoTrace << "returned object: " << bson.toString();
+				if (!otherUpload->success)
+				{
+					repoError << "Failed to store " << fileName << " by another writer";
+					success = false;
+				}
+				continue;
+			}
+
+			upload = std::make_shared<FileUpload>();
+			filesInFlight[fileKey] = upload;
+		}
+
+		auto finishUpload = [&](const bool &stored)
+		{
+			boost::mutex::scoped_lock lock(filesInFlightMutex);
+			upload->success = stored;
+			upload->done = true;
+			filesInFlight.erase(fileKey);
+			fileUploaded.notify_all();
+		};
+
+		bool stored = false;
+		try{
+			stored = storeFile(obj, field, fileName);
+		}
+		catch (...)
+		{
+			finishUpload(false);
+			throw;
+		}
+
+		finishUpload(stored);
+		success &= stored;
+	}
+
+	if (!success)
+		errMsg += "Failed to store external files into GridFS";
+
+	return success;
+}
+
+std::unordered_set<std::string> MongoDatabaseHandler::findGridFSFiles(
+	mongo::DBClientBase            *worker,
+	const std::string              &database,
+	const std::string              &collection,
+	const std::vector<std::string> &fileNames)
+{
+	std::unordered_set<std::string> found;
+
+	//Look the names up in chunks to keep the queries well within the document size limit
+	const size_t namesPerQuery = 1000;
+	const mongo::BSONObj projection = BSON("filename" << 1 << "_id" << 0);
+	for (size_t start = 0; start < fileNames.size(); start += namesPerQuery)
+	{
+		mongo::BSONArrayBuilder names;
+		const size_t end = std::min(fileNames.size(), start + namesPerQuery);
+		for (size_t i = start; i < end; ++i)
+			names << fileNames[i];
+
+		std::auto_ptr<mongo::DBClientCursor> cursor = worker->query(
+			getNamespace(database, collection + ".files"),
+			BSON("filename" << BSON("$in" << names.arr())),
+			0,
+			0,
+			&projection);
+
+		while (cursor.get() && cursor->more())
+			found.insert(cursor->nextSafe().getStringField("filename"));
+	}
+
+	return found;
+}
+
+bool MongoDatabaseHandler::streamQuery(
+	const std::string &database,
+	const std::string &collection,
+	const mongo::Query &query,
+	const mongo::BSONObj &projection,
+	const BSONBatchConsumer &consumer,
+	uint64_t &retrieved)
+{
+	//Batches read off the cursor but not consumed yet. This is bounded so
+	//the reader cannot get arbitrarily far ahead of the consumer.
+	const size_t maxPending = 2;
+	std::deque<std::vector<repo::core::model::RepoBSON>> pending;
+	boost::mutex mutex;
+	boost::condition_variable batchAvailable, spaceAvailable;
+	bool readerDone = false, aborted = false, querySuccess = true;
+
+	retrieved = 0;
+	boost::thread reader([&]()
+	{
+		mongo::DBClientBase *worker = nullptr;
+		bool success = true;
+		try{
+			worker = workerPool->getWorker();
+			if (worker)
+			{
+				repoTrace << " Querying " << database << "." << collection << " with : " << query.toString();
+				std::auto_ptr<mongo::DBClientCursor> cursor = worker->query(
+					getNamespace(database, collection),
+					query,
+					0,
+					0,
+					projection.isEmpty() ? nullptr : &projection);
+
+				while (cursor.get() && cursor->more())
+				{
+					//Take what the server has sent so far, more() requests the next batch
+					std::vector<repo::core::model::RepoBSON> batch;
+					batch.reserve(cursor->objsLeftInBatch());
+					do
+					{
+						//have to copy since the bson info gets cleaned up when cursor gets out of scope
+						batch.push_back(createRepoBSON(database, collection, cursor->nextSafe().copy()));
+					} while (cursor->objsLeftInBatch() > 0);
+
+					boost::mutex::scoped_lock lock(mutex);
+					while (pending.size() >= maxPending && !aborted)
+						spaceAvailable.wait(lock);
+					if (aborted) break;
+
+					retrieved += batch.size();
+					pending.push_back(std::move(batch));
+					batchAvailable.notify_one();
+				}
 			}
 			else
 			{
-				repoError << "A oversized entry exist but binary not found!";
+				repoError << "Failed to query " << database << "." << collection << ": cannot obtain a database worker from the pool";
 				success = false;
 			}
 		}
+		catch (mongo::DBException& e)
+		{
+			repoError << "Error querying " << database << "." << collection << ": " << e.what();
+			success = false;
+		}
+
+		if (worker)
+			workerPool->returnWorker(worker);
+
+		boost::mutex::scoped_lock lock(mutex);
+		querySuccess = success;
+		readerDone = true;
+		batchAvailable.notify_one();
+	});
+
+	bool consumerSuccess = true;
+	while (consumerSuccess)
+	{
+		std::vector<repo::core::model::RepoBSON> batch;
+		{
+			boost::mutex::scoped_lock lock(mutex);
+			while (pending.empty() && !readerDone)
+				batchAvailable.wait(lock);
+			if (pending.empty()) break;
+
+			batch = std::move(pending.front());
+			pending.pop_front();
+			spaceAvailable.notify_one();
+		}
+
+		try{
+			consumerSuccess = consumer(batch);
+		}
+		catch (std::exception &e)
+		{
+			repoError << "Failed to process documents from " << database << "." << collection << ": " << e.what();
+			consumerSuccess = false;
+		}
 	}
 
-	return success;
+	if (!consumerSuccess)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		aborted = true;
+		spaceAvailable.notify_one();
+	}
+
+	reader.join();
+	return querySuccess && consumerSuccess;
 }
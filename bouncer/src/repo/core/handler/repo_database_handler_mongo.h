@@ -23,7 +23,10 @@
 
 #include <string>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <WinSock2.h>
@@ -33,6 +36,8 @@
 #endif
 
 #include <mongo/client/dbclient.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include "repo_database_handler_abstract.h"
 #include "connectionpool/repo_connection_pool_mongo.h"
@@ -386,6 +391,22 @@ namespace repo{
 					const repo::core::model::RepoBSON &obj,
 					std::string &errMsg);
 
+				/**
+				* Insert multiple documents in database.collection
+				* Documents are split into batches no bigger than
+				* the document size limit, one round trip per batch.
+				* @param database name
+				* @param collection name
+				* @param objs documents to insert
+				* @param errMsg error message should it fail
+				* @return returns true upon success
+				*/
+				bool insertManyDocuments(
+					const std::string &database,
+					const std::string &collection,
+					const std::vector<repo::core::model::RepoBSON> &objs,
+					std::string &errMsg);
+
 				/**
 				* Insert big raw file in binary format (using GridFS)
 				* @param database name
@@ -490,6 +511,25 @@ namespace repo{
 					const std::string& collection,
 					const repo::core::model::RepoBSON& uuids);
 
+				/**
+				* Given a list of unique IDs, find all the documents associated to them
+				* and hand them to the consumer batch by batch as they arrive
+				* The IDs are queried in chunks over several pooled connections in parallel,
+				* the chunks are handed to the consumer in the order of the IDs.
+				* @param name of database
+				* @param name of collection
+				* @param array of uuids in a BSON object
+				* @param consumer called with each batch of results, in order
+				* @param projection fields to return as a mongo projection (empty for whole documents)
+				* @return returns true if the query completed and the consumer accepted every batch
+				*/
+				bool findAllByUniqueIDs(
+					const std::string& database,
+					const std::string& collection,
+					const repo::core::model::RepoBSON& uuids,
+					const BSONBatchConsumer& consumer,
+					const repo::core::model::RepoBSON& projection = repo::core::model::RepoBSON());
+
 				/**
 				* Given a search criteria,  find all the documents that passes this query
 				* @param database name of database
@@ -502,6 +542,24 @@ namespace repo{
 					const std::string& collection,
 					const repo::core::model::RepoBSON& criteria);
 
+				/**
+				* Given a search criteria, find all the documents that passes this query
+				* and hand them to the consumer batch by batch as they arrive
+				* The next batch is fetched while the consumer processes the current one.
+				* @param database name of database
+				* @param collection name of collection
+				* @param criteria search criteria in a bson object
+				* @param consumer called with each batch of results, in order
+				* @param projection fields to return as a mongo projection (empty for whole documents)
+				* @return returns true if the query completed and the consumer accepted every batch
+				*/
+				bool findAllByCriteria(
+					const std::string& database,
+					const std::string& collection,
+					const repo::core::model::RepoBSON& criteria,
+					const BSONBatchConsumer& consumer,
+					const repo::core::model::RepoBSON& projection = repo::core::model::RepoBSON());
+
 				/**
 				* Given a search criteria,  find one documents that passes this query
 				* @param database name of database
@@ -558,6 +616,22 @@ namespace repo{
 					const std::string& fname
 					);
 
+				/**
+				* Stream a raw binary file from database, chunk by chunk,
+				* without holding the whole file in memory
+				* @param database name of database
+				* @param collection name of collection
+				* @param fname name of the file
+				* @param sink called with each chunk in order, returning false stops the read
+				* @return returns true if the whole file was passed to the sink
+				*/
+				bool streamRawFile(
+					const std::string& database,
+					const std::string& collection,
+					const std::string& fname,
+					const RawFileSink& sink
+					);
+
 				/*
 				 *	=============================================================================================
 				 */
@@ -576,7 +650,7 @@ namespace repo{
 				 *	=================================== Private Fields ========================================
 				 */
 
-				connectionPool::MongoConnectionPool *workerPool;
+				std::shared_ptr<connectionPool::MongoConnectionPool> workerPool; //shared with the loaders of the documents read
 
 				/*!
 				 * Map holding database name as key and <username, password digest> as a
@@ -587,6 +661,21 @@ namespace repo{
 
 				mongo::ConnectionString dbAddress; /* !address of the database (host:port)*/
 
+				/*!
+				 * GridFS files (namespace/file name) being stored at the moment.
+				 * Mesh files are named after their content, so concurrent writers
+				 * may attempt to store the same file. Only one stores it, the
+				 * others wait for its result.
+				 */
+				struct FileUpload
+				{
+					bool done = false;
+					bool success = false;
+				};
+				std::unordered_map<std::string, std::shared_ptr<FileUpload>> filesInFlight;
+				boost::mutex filesInFlightMutex;
+				boost::condition_variable fileUploaded;
+
 				/*
 				 *	=============================================================================================
 				 */
@@ -625,18 +714,15 @@ namespace repo{
 					const model::RepoBSON         *cred);
 
 				/**
-				* Create a Repo BSON and populate all relevant data
-				* this includes getting data from GridFS
-				* NOTE: the handler will only get the data from GridFS if it is
-				* listed in REPO_LABEL_OVERSIZED_FILES
-				* @param worker the worker to operate with
+				* Create a Repo BSON from a retrieved document
+				* Files listed in REPO_LABEL_OVERSIZED_FILES are not fetched from
+				* GridFS here but on first access (see RepoBSON::prefetchBigFiles)
 				* @param database database to store in
 				* @param collection collection to store in
 				* @param obj the mongo bson this repoBSON is basing from
-				* @return returns a repo BSON that is fully populated
+				* @return returns a repo BSON
 				*/
 				repo::core::model::RepoBSON createRepoBSON(
-					mongo::DBClientBase *worker,
 					const std::string &database,
 					const std::string &collection,
 					const mongo::BSONObj &obj);
@@ -673,17 +759,21 @@ namespace repo{
 
 				/**
 				* Get large file off GridFS
+				* The buffer is allocated once from the file length and
+				* filled in chunk by chunk.
 				* @param worker the worker to operate with
 				* @param database database that it is stored in
 				* @param collection collection that it is stored in
 				* @param fileName file name in GridFS
-				* @return returns true upon success
+				* @param bin filled with the content of the file (empty upon failure)
+				* @return returns true if the file was read in full
 				*/
-				std::vector<uint8_t> getBigFile(
-					mongo::DBClientBase *worker,
-					const std::string &database,
-					const std::string &collection,
-					const std::string &fileName);
+				static bool getBigFile(
+					mongo::DBClientBase  *worker,
+					const std::string    &database,
+					const std::string    &collection,
+					const std::string    &fileName,
+					std::vector<uint8_t> &bin);
 
 				/**
 				 * Given a database and collection name, returns its namespace
@@ -728,12 +818,52 @@ namespace repo{
 					std::string                       &errMsg);
 
 				/**
-				* check if the bson object contains any big binary files
-				* if yes, store them in gridFS
+				* Retrieve the documents with the given unique IDs with a single $in query
+				* If the cursor dies midway, the query is issued again for the
+				* documents that were not retrieved yet.
+				* @param database database to query
+				* @param collection collection to query
+				* @param ids the unique IDs
+				* @param projection fields to return (empty for whole documents)
+				* @param docs the documents retrieved are appended to this
+				* @return returns true if the query completed
+				*/
+				bool findByUniqueIDs(
+					const std::string &database,
+					const std::string &collection,
+					const std::vector<mongo::BSONElement> &ids,
+					const mongo::BSONObj &projection,
+					std::vector<repo::core::model::RepoBSON> &docs);
+
+				/**
+				* Run a query and hand the results to the consumer in batches
+				* Documents are read off the cursor by a separate thread, one server
+				* batch at a time, so the next batch is in flight while the consumer
+				* processes the current one.
+				* @param database database to query
+				* @param collection collection to query
+				* @param query the query
+				* @param projection fields to return (empty for whole documents)
+				* @param consumer called with each batch of results, in order
+				* @param retrieved number of documents retrieved
+				* @return returns true if the query completed and the consumer accepted every batch
+				*/
+				bool streamQuery(
+					const std::string &database,
+					const std::string &collection,
+					const mongo::Query &query,
+					const mongo::BSONObj &projection,
+					const BSONBatchConsumer &consumer,
+					uint64_t &retrieved);
+
+				/**
+				* check if the bson objects contain any big binary files
+				* if yes, store them in gridFS. Files named after their content
+				* (mesh geometry) are skipped if they are stored already
 				* @param worker the worker to operate with
 				* @param database database to store in
 				* @param collection collection to store in
-				* @param obj the bson object to work with
+				* @param objs the bson objects to work with
 				* @param errMsg error message when failed
 				* @return returns true upon success
 				*/
@@ -741,9 +871,23 @@ namespace repo{
 					mongo::DBClientBase *worker,
 					const std::string &database,
 					const std::string &collection,
-					const repo::core::model::RepoBSON &obj,
+					const std::vector<const repo::core::model::RepoBSON*> &objs,
 					std::string &errMsg);
 
+				/**
+				* Find which of the given files exist in gridFS, in as few queries as possible
+				* @param worker the worker to operate with
+				* @param database database to look in
+				* @param collection collection (gridFS prefix) to look in
+				* @param fileNames names of the files
+				* @return returns the names of the files found
+				*/
+				std::unordered_set<std::string> findGridFSFiles(
+					mongo::DBClientBase            *worker,
+					const std::string              &database,
+					const std::string              &collection,
+					const std::vector<std::string> &fileNames);
+
 				/**
 				* Compares two strings.
 				* @param string 1
@@ -17,23 +17,70 @@
 
 #include "repo_bson.h"
 
+#include <algorithm>
+#include <atomic>
+#include <boost/thread.hpp>
 #include <mongo/client/dbclient.h>
 
 using namespace repo::core::model;
 
+struct RepoBSON::LazyBigFiles
+{
+	struct File
+	{
+		std::string fileName;
+		std::shared_ptr<const std::vector<uint8_t>> data; //set once loaded, never replaced afterwards
+		boost::mutex mutex;
+	};
+
+	BigFileLoader loader;
+	std::unordered_map<std::string, std::shared_ptr<File>> files; //field name -> file
+
+	const std::vector<uint8_t>* resolve(File &file, const bool &fetch = true) const
+	{
+		boost::mutex::scoped_lock lock(file.mutex);
+		if (!file.data && fetch)
+		{
+			//Leave it unloaded on failure so the next access retries
+			auto data = std::make_shared<std::vector<uint8_t>>();
+			if (loader(file.fileName, *data))
+				file.data = data;
+		}
+		//The content is kept alive by the file, which outlives this call
+		return file.data.get();
+	}
+};
+
 RepoBSON::RepoBSON(
 	const mongo::BSONObj &obj,
-	const std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> &binMapping)
-	: mongo::BSONObj(obj),
-	bigFiles(binMapping)
+	const BigFileLoader &loader)
+	: mongo::BSONObj(obj)
 {
-	std::vector<std::pair<std::string, std::string>> existingFiles;
+	auto fileList = getFileList();
+	if (fileList.size())
+	{
+		auto lazy = std::make_shared<LazyBigFiles>();
+		lazy->loader = loader;
+		for (const auto &pair : fileList)
+		{
+			auto file = std::make_shared<LazyBigFiles::File>();
+			file->fileName = pair.second;
+			lazy->files[pair.first] = file;
+		}
+		lazyFiles = lazy;
+	}
+}
 
-	if (bigFiles.size() > 0)
+RepoBSON::RepoBSON(
+	const mongo::BSONObj &obj,
+	std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> binMapping)
+	: mongo::BSONObj(obj)
+{
+	if (binMapping.size() > 0)
 	{
 		mongo::BSONObjBuilder builder, arrbuilder;
 
-		for (const auto & pair : bigFiles)
+		for (const auto & pair : binMapping)
 		{
 			//append field name :file name
 			arrbuilder << pair.first << pair.second.first;
@@ -48,7 +95,7 @@ RepoBSON::RepoBSON(
 		builder.appendElementsUnique(obj);
 
 		*this = builder.obj();
-		bigFiles = binMapping;
+		bigFiles = std::move(binMapping);
 	}
 }
 
@@ -75,11 +122,12 @@ RepoBSON RepoBSON::cloneAndAddFields(
 	return RepoBSON(builder.obj());
 }
 
-RepoBSON RepoBSON::cloneAndShrink() const
+RepoBSON RepoBSON::cloneAndShrink(const std::string &fileNamePrefix) const
 {
 	std::set<std::string> fields;
-	std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t>>> rawFiles(bigFiles.begin(), bigFiles.end());
-	std::string uniqueIDStr = hasField(REPO_LABEL_ID) ? getUUIDField(REPO_LABEL_ID).toString() : repo::lib::RepoUUID::createUUID().toString();
+	std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t>>> rawFiles = getFilesMapping();
+	std::string uniqueIDStr = !fileNamePrefix.empty() ? fileNamePrefix :
+		hasField(REPO_LABEL_ID) ? getUUIDField(REPO_LABEL_ID).toString() : repo::lib::RepoUUID::createUUID().toString();
 
 	getFieldNames(fields);
 
@@ -143,11 +191,10 @@ std::vector<uint8_t> RepoBSON::getBigBinary(
 	const std::string &key) const
 {
 	std::vector<uint8_t> binary;
-	const auto &it = bigFiles.find(key);
 
-	if (it != bigFiles.end())
+	if (const std::vector<uint8_t> *file = findBigFile(key))
 	{
-		binary = it->second.second;
+		binary = *file;
 	}
 	else
 	{
@@ -157,6 +204,96 @@ std::vector<uint8_t> RepoBSON::getBigBinary(
 	return binary;
 }
 
+RepoBSON RepoBSON::cloneWithBigFiles(
+	const mongo::BSONObj &obj) const
+{
+	RepoBSON result(obj, bigFiles);
+	result.lazyFiles = lazyFiles;
+	return result;
+}
+
+const std::vector<uint8_t>* RepoBSON::findBigFile(
+	const std::string &field,
+	const bool        &fetch) const
+{
+	const auto &it = bigFiles.find(field);
+	if (it != bigFiles.end())
+		return &it->second.second;
+
+	if (lazyFiles)
+	{
+		const auto &lazyIt = lazyFiles->files.find(field);
+		if (lazyIt != lazyFiles->files.end())
+			return lazyFiles->resolve(*lazyIt->second, fetch);
+	}
+
+	return nullptr;
+}
+
+bool RepoBSON::hasLazyFile(
+	const std::string &field) const
+{
+	if (!lazyFiles) return false;
+	return field.empty() ? lazyFiles->files.size() > 0
+		: lazyFiles->files.find(field) != lazyFiles->files.end();
+}
+
+std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t> > > RepoBSON::getFilesMapping() const
+{
+	auto mapping = bigFiles;
+	if (lazyFiles)
+	{
+		for (const auto &pair : lazyFiles->files)
+		{
+			if (mapping.find(pair.first) == mapping.end())
+			{
+				if (const std::vector<uint8_t> *file = lazyFiles->resolve(*pair.second))
+					mapping[pair.first] = { pair.second->fileName, *file };
+				else
+					repoError << "Failed to fetch external file " << pair.second->fileName << " for field " << pair.first;
+			}
+		}
+	}
+	return mapping;
+}
+
+void RepoBSON::prefetchBigFiles() const
+{
+	prefetchBigFiles({ this }, 1);
+}
+
+void RepoBSON::prefetchBigFiles(
+	const std::vector<const RepoBSON*> &bsons,
+	const uint32_t &nThreads)
+{
+	std::vector<std::pair<const LazyBigFiles*, LazyBigFiles::File*>> toFetch;
+	for (const auto &bson : bsons)
+	{
+		if (bson && bson->lazyFiles)
+		{
+			for (const auto &pair : bson->lazyFiles->files)
+				toFetch.push_back({ bson->lazyFiles.get(), pair.second.get() });
+		}
+	}
+
+	if (!toFetch.size()) return;
+
+	repoTrace << "Prefetching " << toFetch.size() << " external files...";
+	std::atomic<size_t> next(0);
+	auto fetch = [&]()
+	{
+		for (size_t i = next++; i < toFetch.size(); i = next++)
+			toFetch[i].first->resolve(*toFetch[i].second);
+	};
+
+	const uint32_t nWorkers = std::max<uint32_t>(1, std::min<uint32_t>(nThreads, toFetch.size()));
+	boost::thread_group workers;
+	for (uint32_t i = 1; i < nWorkers; ++i)
+		workers.create_thread(fetch);
+	fetch();
+	workers.join_all();
+}
+
 std::vector<std::pair<std::string, std::string>> RepoBSON::getFileList() const
 {
 	std::vector<std::pair<std::string, std::string>> fileList;
@@ -34,12 +34,15 @@
 #endif
 
 #include <mongo/bson/bson.h>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 
 #include "../../../lib/repo_log.h"
 #include "../../../repo_bouncer_global.h"
 #include "../repo_model_global.h"
 #include "../../../lib/datastructure/repo_uuid.h"
+#include "../../../lib/datastructure/repo_array_view.h"
 #include "repo_bson_element.h"
 
 #define REPO_BSON_MAX_BYTE_SIZE 16770000 //max size is 16MB,but leave a bit for buffer
@@ -53,6 +56,11 @@ namespace repo {
 			class REPO_API_EXPORT RepoBSON : public mongo::BSONObj
 			{
 			public:
+				/**
+				* Fetches the content of an external (GridFS) file given its name
+				* into data, returns true upon success (the file may be empty)
+				*/
+				typedef std::function<bool(const std::string &fileName, std::vector<uint8_t> &data)> BigFileLoader;
 
 				/**
 				* Default empty constructor.
@@ -64,7 +72,7 @@ namespace repo {
 				* @param mongo BSON object
 				*/
 				RepoBSON(const mongo::BSONObj &obj,
-					const std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> &binMapping =
+					std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> binMapping =
 					std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>>());
 
 				/**
@@ -73,6 +81,14 @@ namespace repo {
 				*/
 				RepoBSON(mongo::BSONObjBuilder &builder) : mongo::BSONObj(builder.obj()) {}
 
+				/**
+				* Constructor from Mongo BSON object, where the external files
+				* listed in it are only fetched when they are first accessed.
+				* @param obj mongo BSON object
+				* @param loader function to fetch an external file
+				*/
+				RepoBSON(const mongo::BSONObj &obj, const BigFileLoader &loader);
+
 				/**
 				* Constructor from raw data buffer.
 				* @param rawData raw data
@@ -100,11 +116,13 @@ namespace repo {
 				/**
 				* Override the swap operator to perform the swap just like mongo bson
 				* but also carry over the mapping information
+				* Virtual so that derived classes caching decoded fields can refresh them
 				*/
-				void swap(RepoBSON otherCopy)
+				virtual void swap(RepoBSON otherCopy)
 				{
 					mongo::BSONObj::swap(otherCopy);
-					bigFiles = otherCopy.bigFiles;
+					bigFiles.swap(otherCopy.bigFiles);
+					lazyFiles.swap(otherCopy.lazyFiles);
 				}
 
 				/**
@@ -139,11 +157,12 @@ namespace repo {
 					if (!hasField(field) || getField(field).type() == ElementType::STRING)
 					{
 						//Try to get it from file mapping.
-						std::vector<uint8_t> bin = getBigBinary(field);
-						if (bin.size() > 0)
+						const std::vector<uint8_t> *file = findBigFile(field);
+						if (file && file->size() > 0)
 						{
+							const std::vector<uint8_t> &bin = *file;
 							vec.resize(bin.size() / sizeof(T));
-							memcpy(vec.data(), &bin[0], bin.size());
+							memcpy(vec.data(), &bin[0], vec.size() * sizeof(T));
 							success = true;
 						}
 						else
@@ -178,6 +197,47 @@ namespace repo {
 					return success;
 				}
 
+				/**
+				* get a read only view of a binary field, interpreted as an array of T
+				* No data is copied: the view points directly into the bson buffer
+				* (or the big files mapping) and is only valid as long as this object
+				* is alive and unmodified.
+				* @param field field name
+				* @return returns a view over the data, empty view if the field is not found
+				*/
+				template <class T>
+				repo::lib::RepoArrayView<T> getBinaryFieldAsView(
+					const std::string &field) const
+				{
+					if (!hasField(field) || getField(field).type() == ElementType::STRING)
+					{
+						//Try to get it from file mapping.
+						if (const std::vector<uint8_t> *file = findBigFile(field))
+						{
+							const std::vector<uint8_t> &bin = *file;
+							return repo::lib::RepoArrayView<T>((const T*)bin.data(), bin.size() / sizeof(T));
+						}
+						repoError << "Trying to retrieve binary from a field that doesn't exist(" << field << ")";
+					}
+					else
+					{
+						RepoBSONElement bse = getField(field);
+						if (bse.type() == ElementType::BINARY && bse.binDataType() == mongo::BinDataGeneral)
+						{
+							int length;
+							const char *binData = bse.binData(length);
+							if (length > 0)
+								return repo::lib::RepoArrayView<T>((const T*)binData, length / sizeof(T));
+						}
+						else
+						{
+							repoError << "RepoBSON::getBinaryFieldAsView : bson element type is not BinDataGeneral!";
+						}
+					}
+
+					return repo::lib::RepoArrayView<T>();
+				}
+
 				/**
 				* Overload of getField function to retreve repo::lib::RepoUUID
 				* @param label name of the field
@@ -247,7 +307,7 @@ namespace repo {
 				*/
 				bool hasBinField(const std::string &label) const
 				{
-					return hasField(label) || bigFiles.find(label) != bigFiles.end();
+					return hasField(label) || bigFiles.find(label) != bigFiles.end() || hasLazyFile(label);
 				}
 
 				virtual RepoBSON cloneAndAddFields(
@@ -262,9 +322,10 @@ namespace repo {
 				/**
 				* Clone and attempt the shrink the bson by offloading binary files to big
 				* file storage
+				* @param fileNamePrefix prefix of the offloaded file names (unique ID if empty)
 				* @return returns the shrunk BSON
 				*/
-				RepoBSON cloneAndShrink() const;
+				RepoBSON cloneAndShrink(const std::string &fileNamePrefix = std::string()) const;
 
 				std::vector<uint8_t> getBigBinary(const std::string &key) const;
 
@@ -277,12 +338,10 @@ namespace repo {
 
 				/**
 				* Get the mapping files from the bson object
+				* This fetches any external files not yet loaded.
 				* @return returns the map of external (gridFS) files
 				*/
-				std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t> > > getFilesMapping() const
-				{
-					return bigFiles;
-				}
+				std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t> > > getFilesMapping() const;
 
 				/**
 				* Check if this bson object has oversized files
@@ -290,12 +349,55 @@ namespace repo {
 				*/
 				bool hasOversizeFiles() const
 				{
-					return bigFiles.size() > 0;
+					return bigFiles.size() > 0 || hasLazyFile();
 				}
 
+				/**
+				* Fetch all external files of this bson that are not loaded yet
+				*/
+				void prefetchBigFiles() const;
+
+				/**
+				* Fetch all external files of the given bsons that are not loaded yet
+				* @param bsons bsons to fetch the files of
+				* @param nThreads number of files fetched concurrently
+				*/
+				static void prefetchBigFiles(
+					const std::vector<const RepoBSON*> &bsons,
+					const uint32_t &nThreads);
+
+				/**
+				* Find the content of an external file
+				* Fetching a file takes a database connection of its own, callers
+				* holding one should not fetch (see prefetchBigFiles)
+				* @param field field name
+				* @param fetch fetch the file if it is not loaded yet
+				* @return returns a pointer to the content, nullptr if not found or not loaded
+				*/
+				const std::vector<uint8_t>* findBigFile(
+					const std::string &field,
+					const bool        &fetch = true) const;
+
 			protected:
+				/**
+				* Create a bson from the given object, carrying over the external
+				* files of this bson without fetching the ones not loaded yet
+				* @param obj the new content of the bson
+				* @return returns a bson with obj as content and this bson's external files
+				*/
+				RepoBSON cloneWithBigFiles(const mongo::BSONObj &obj) const;
+
+				/**
+				* @param field field name (empty for any field)
+				* @return returns true if the field is an external file that is fetched on demand
+				*/
+				bool hasLazyFile(const std::string &field = std::string()) const;
 
 				std::unordered_map< std::string, std::pair<std::string, std::vector<uint8_t> > > bigFiles;
+
+			private:
+				struct LazyBigFiles;
+				std::shared_ptr<const LazyBigFiles> lazyFiles; //shared between copies
 			}; // end
 		}// end namespace model
 	} // end namespace core
@@ -75,7 +75,7 @@ template<> void repo::core::model::RepoBSONBuilder::append < repo::lib::RepoUUID
 				)
 		{
 			RepoBSONBuilder rows;
-			auto data = mat.getData();
+			const float *data = mat.getRawData();
 			for (uint32_t i = 0; i < 4; ++i)
 			{
 				RepoBSONBuilder columns;
@@ -262,7 +262,7 @@ MetadataNode RepoBSONFactory::makeMetaDataNode(
 
 MeshNode RepoBSONFactory::makeMeshNode(
 	const std::vector<repo::lib::RepoVector3D>                  &vertices,
-	const std::vector<repo_face_t>                    &faces,
+	const repo::lib::RepoFaceBuffer                   &faces,
 	const std::vector<repo::lib::RepoVector3D>                  &normals,
 	const std::vector<std::vector<float>>             &boundingBox,
 	const std::vector<std::vector<repo::lib::RepoVector2D>>   &uvChannels,
@@ -284,6 +284,12 @@ MeshNode RepoBSONFactory::makeMeshNode(
 	}
 	std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> binMapping;
 
+	//Identical geometry yields the same hash, external binaries are named after it so they can be shared
+	std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> uvViews(uvChannels.begin(), uvChannels.end());
+	const std::string sha256 = MeshNode::hashGeometry(vertices, faces.serialised(), normals, colors, uvViews);
+	builder << REPO_NODE_MESH_LABEL_SHA256 << sha256;
+	bytesize += sha256.size();
+
 	if (boundingBox.size() > 0)
 	{
 		RepoBSONBuilder arrayBuilder;
@@ -320,11 +326,13 @@ MeshNode RepoBSONFactory::makeMeshNode(
 
 	if (vertices.size() > 0)
 	{
+		builder << REPO_NODE_MESH_LABEL_VERTICES_COUNT << (uint32_t)(vertices.size());
+
 		uint64_t verticesByteCount = vertices.size() * sizeof(vertices[0]);
 
 		if (verticesByteCount + bytesize >= REPO_BSON_MAX_BYTE_SIZE)
 		{
-			std::string bName = uniqueID.toString() + "_vertices";
+			std::string bName = MeshNode::getGeometryFileName(sha256, REPO_NODE_MESH_LABEL_VERTICES);
 			//inclusion of this binary exceeds the maximum, store separately
 			binMapping[REPO_NODE_MESH_LABEL_VERTICES] =
 				std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
@@ -349,27 +357,14 @@ MeshNode RepoBSONFactory::makeMeshNode(
 
 		// In API LEVEL 1, faces are stored as
 		// [n1, v1, v2, ..., n2, v1, v2...]
-		std::vector<repo_face_t>::iterator faceIt;
-
-		std::vector<uint32_t> facesLevel1;
-		for (auto &face : faces){
-			auto nIndices = face.size();
-			if (!nIndices)
-			{
-				repoWarning << "number of indices in this face is 0!";
-			}
-			facesLevel1.push_back(nIndices);
-			for (uint32_t ind = 0; ind < nIndices; ind++)
-			{
-				facesLevel1.push_back(face[ind]);
-			}
-		}
+		// which is how RepoFaceBuffer holds them already
+		const std::vector<uint32_t> &facesLevel1 = faces.serialised();
 
 		uint64_t facesByteCount = facesLevel1.size() * sizeof(facesLevel1[0]);
 
 		if (facesByteCount + bytesize >= REPO_BSON_MAX_BYTE_SIZE)
 		{
-			std::string bName = uniqueID.toString() + "_faces";
+			std::string bName = MeshNode::getGeometryFileName(sha256, REPO_NODE_MESH_LABEL_FACES);
 			//inclusion of this binary exceeds the maximum, store separately
 			binMapping[REPO_NODE_MESH_LABEL_FACES] =
 				std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
@@ -396,7 +391,7 @@ MeshNode RepoBSONFactory::makeMeshNode(
 
 		if (normalsByteCount + bytesize >= REPO_BSON_MAX_BYTE_SIZE)
 		{
-			std::string bName = uniqueID.toString() + "_normals";
+			std::string bName = MeshNode::getGeometryFileName(sha256, REPO_NODE_MESH_LABEL_NORMALS);
 			//inclusion of this binary exceeds the maximum, store separately
 			binMapping[REPO_NODE_MESH_LABEL_NORMALS] =
 				std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
@@ -416,12 +411,6 @@ MeshNode RepoBSONFactory::makeMeshNode(
 		}
 	}
 
-	//if (!vertexHash.empty())
-	//{
-	//	// TODO: Fix this call - needs to be fixed as int conversion is overloaded
-	//	//builder << REPO_NODE_LABEL_SHA256 << (long unsigned int)(vertexHash);
-	//}
-
 	//--------------------------------------------------------------------------
 	// Vertex colors
 	if (colors.size())
@@ -430,7 +419,7 @@ MeshNode RepoBSONFactory::makeMeshNode(
 
 		if (colorsByteCount + bytesize >= REPO_BSON_MAX_BYTE_SIZE)
 		{
-			std::string bName = uniqueID.toString() + "_colors";
+			std::string bName = MeshNode::getGeometryFileName(sha256, REPO_NODE_MESH_LABEL_COLORS);
 			//inclusion of this binary exceeds the maximum, store separately
 			binMapping[REPO_NODE_MESH_LABEL_COLORS] =
 				std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
@@ -457,23 +446,18 @@ MeshNode RepoBSONFactory::makeMeshNode(
 		builder << REPO_NODE_MESH_LABEL_UV_CHANNELS_COUNT << (uint32_t)(uvChannels.size());
 
 		std::vector<repo::lib::RepoVector2D> concatenated;
+		concatenated.reserve(uvChannels.size() * uvChannels[0].size());
 
-		for (auto it = uvChannels.begin(); it != uvChannels.end(); ++it)
+		for (const auto &channel : uvChannels)
 		{
-			std::vector<repo::lib::RepoVector2D> channel = *it;
-
-			std::vector<repo::lib::RepoVector2D>::iterator cit;
-			for (cit = channel.begin(); cit != channel.end(); ++cit)
-			{
-				concatenated.push_back(*cit);
-			}
+			concatenated.insert(concatenated.end(), channel.begin(), channel.end());
 		}
 
 		uint64_t uvByteCount = concatenated.size() * sizeof(concatenated[0]);
 
 		if (uvByteCount + bytesize >= REPO_BSON_MAX_BYTE_SIZE)
 		{
-			std::string bName = uniqueID.toString() + "_uv";
+			std::string bName = MeshNode::getGeometryFileName(sha256, REPO_NODE_MESH_LABEL_UV_CHANNELS);
 			//inclusion of this binary exceeds the maximum, store separately
 			binMapping[REPO_NODE_MESH_LABEL_UV_CHANNELS] =
 				std::pair<std::string, std::vector<uint8_t>>(bName, std::vector<uint8_t>());
@@ -24,9 +24,18 @@
 using namespace repo::core::model;
 
 RepoNode::RepoNode(RepoBSON bson,
-	const std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> &binMapping) : RepoBSON(bson, binMapping){
-	if (binMapping.size() == 0)
-		bigFiles = bson.getFilesMapping();
+	const std::unordered_map<std::string, std::pair<std::string, std::vector<uint8_t>>> &binMapping) :
+	//Without a new mapping, copy the bson as is so external files that are yet to be fetched stay that way
+	RepoBSON(binMapping.size() ? RepoBSON(bson, binMapping) : bson),
+	uniqueID(getUUIDField(REPO_NODE_LABEL_ID)),
+	sharedID(getUUIDField(REPO_NODE_LABEL_SHARED_ID))
+{
+}
+
+RepoNode::RepoNode() : RepoBSON(),
+	uniqueID(repo::lib::RepoUUID::createUUID()),
+	sharedID(repo::lib::RepoUUID::createUUID())
+{
 }
 
 RepoNode::~RepoNode()
@@ -60,7 +69,7 @@ RepoNode RepoNode::cloneAndAddParent(
 
 	builder.appendElementsUnique(*this);
 
-	return RepoNode(builder.obj(), bigFiles);
+	return RepoNode(cloneWithBigFiles(builder.obj()));
 }
 
 RepoNode RepoNode::cloneAndAddParent(
@@ -81,7 +90,7 @@ RepoNode RepoNode::cloneAndAddParent(
 
 	builder.appendElementsUnique(*this);
 
-	return RepoNode(builder.obj(), bigFiles);
+	return RepoNode(cloneWithBigFiles(builder.obj()));
 }
 
 RepoNode RepoNode::cloneAndRemoveParent(
@@ -115,7 +124,7 @@ RepoNode RepoNode::cloneAndRemoveParent(
 		builder.appendElementsUnique(removeField(REPO_NODE_LABEL_PARENTS));
 	}
 
-	return RepoNode(builder.obj(), bigFiles);
+	return RepoNode(cloneWithBigFiles(builder.obj()));
 }
 
 RepoNode RepoNode::cloneAndAddFields(
@@ -132,7 +141,7 @@ RepoNode RepoNode::cloneAndAddFields(
 
 	builder.appendElementsUnique(*this);
 
-	return RepoNode(builder.obj(), bigFiles);
+	return RepoNode(cloneWithBigFiles(builder.obj()));
 }
 
 std::vector<repo::lib::RepoUUID> RepoNode::getParentIDs() const
@@ -164,4 +173,16 @@ NodeType RepoNode::getTypeAsEnum() const
 		enumType = NodeType::TRANSFORMATION;
 
 	return enumType;
-}
\ No newline at end of file
+}
+
+void RepoNode::swap(RepoBSON otherCopy)
+{
+	RepoBSON::swap(otherCopy);
+	updateCachedIDs();
+}
+
+void RepoNode::updateCachedIDs()
+{
+	uniqueID = getUUIDField(REPO_NODE_LABEL_ID);
+	sharedID = getUUIDField(REPO_NODE_LABEL_SHARED_ID);
+}
@@ -47,7 +47,7 @@ namespace repo{
 				/**
 				* Empty Constructor
 				*/
-				RepoNode() : RepoBSON() {};
+				RepoNode();
 
 				/**
 				* Default Deconstructor
@@ -65,6 +65,13 @@ namespace repo{
 				*/
 				virtual bool positionDependant() { return false; }
 
+				/**
+				* Swap the content of this node with the given bson
+				* and refresh the cached identity fields
+				* @param otherCopy bson to swap with
+				*/
+				virtual void swap(RepoBSON otherCopy);
+
 				/*
 				*	------------- Delusional modifiers --------------
 				*   These are like "setters" but not. We are actually
@@ -107,7 +114,7 @@ namespace repo{
 				virtual RepoNode cloneAndApplyTransformation(
 					const repo::lib::RepoMatrix &matrix) const
 				{
-					return RepoNode(copy(), bigFiles);
+					return RepoNode(cloneWithBigFiles(copy()));
 				}
 
 				/**
@@ -165,7 +172,7 @@ namespace repo{
 				* Get the shared ID from the object
 				* @return returns the shared ID of the object
 				*/
-				repo::lib::RepoUUID getSharedID() const { return getUUIDField(REPO_NODE_LABEL_SHARED_ID); }
+				repo::lib::RepoUUID getSharedID() const { return sharedID; }
 
 				/**
 				* Get the type of node
@@ -186,7 +193,7 @@ namespace repo{
 				* Get the unique ID from the object
 				* @return returns the unique ID of the object
 				*/
-				repo::lib::RepoUUID getUniqueID() const{ return getUUIDField(REPO_NODE_LABEL_ID); }
+				repo::lib::RepoUUID getUniqueID() const{ return uniqueID; }
 
 				/**
 				* Get the list of parent IDs
@@ -200,19 +207,17 @@ namespace repo{
 				//! Returns true if the node is the same, false otherwise.
 				bool operator==(const RepoNode& other) const
 				{
-					return getUniqueID() == other.getUniqueID() && getSharedID() == other.getSharedID();
+					return uniqueID == other.uniqueID && sharedID == other.sharedID;
 				}
 
 				//! Returns true if the other node is greater than this one, false otherwise.
 				bool operator<(const RepoNode& other) const
 				{
-					repo::lib::RepoUUID sharedID = getSharedID();
-
-					if (sharedID == other.getSharedID()){
-						return getUniqueID() < other.getUniqueID();
+					if (sharedID == other.sharedID){
+						return uniqueID < other.uniqueID;
 					}
 					else{
-						return sharedID < other.getSharedID();
+						return sharedID < other.sharedID;
 					}
 				}
 
@@ -235,18 +240,23 @@ namespace repo{
 				//! Returns true if the other node is greater than this one, false otherwise.
 				bool operator>(const RepoNode& other) const
 				{
-					repo::lib::RepoUUID sharedID = getSharedID();
-
-					if (sharedID == other.getSharedID()){
-						return getUniqueID() > other.getUniqueID();
+					if (sharedID == other.sharedID){
+						return uniqueID > other.uniqueID;
 					}
 					else{
-						return sharedID > other.getSharedID();
+						return sharedID > other.sharedID;
 					}
 				}
 
 			protected:
 
+				/**
+				* Decode the unique and shared ID from the bson into
+				* the cached fields. Must be called whenever the
+				* underlying bson changes.
+				*/
+				void updateCachedIDs();
+
 				/*
 				*	------------- node fields --------------
 				*/
@@ -254,6 +264,13 @@ namespace repo{
 				//FIXME: Convenience fields, should these really exist?
 
 				std::string type; //!< Compulsory type of this document.
+
+				/*
+				* Identity fields decoded once on construction so comparisons
+				* and lookups do not need to parse the bson
+				*/
+				repo::lib::RepoUUID uniqueID; //!< cached REPO_NODE_LABEL_ID
+				repo::lib::RepoUUID sharedID; //!< cached REPO_NODE_LABEL_SHARED_ID
 			};
 			/*!
 			* Comparator definition to enable std::set to store pointers to abstract nodes
@@ -22,6 +22,7 @@
 #include "repo_node_mesh.h"
 
 #include "../../../lib/repo_log.h"
+#include "../../../lib/repo_sha256.h"
 #include "repo_bson_builder.h"
 using namespace repo::core::model;
 
@@ -43,46 +44,27 @@ MeshNode::~MeshNode()
 RepoNode MeshNode::cloneAndApplyTransformation(
 	const repo::lib::RepoMatrix &matrix) const
 {
-	std::vector<repo::lib::RepoVector3D> vertices = getVertices();
-	std::vector<repo::lib::RepoVector3D> normals = getNormals();
+	auto vertices = getVerticesView();
+	auto normals = getNormalsView();
 
-	auto newBigFiles = bigFiles;
+	//The transformed binaries replace the originals, so every external file has to be fetched
+	auto newBigFiles = getFilesMapping();
 
 	RepoBSONBuilder builder;
 	std::vector<repo::lib::RepoVector3D> resultVertice;
 	std::vector<repo::lib::RepoVector3D> newBbox;
 	if (vertices.size())
 	{
-		resultVertice.reserve(vertices.size());
-		for (const repo::lib::RepoVector3D &v : vertices)
+		if (!matrix.isAffine())
 		{
-			resultVertice.push_back(matrix * v);
-			if (newBbox.size())
-			{
-				if (resultVertice.back().x < newBbox[0].x)
-					newBbox[0].x = resultVertice.back().x;
-
-				if (resultVertice.back().y < newBbox[0].y)
-					newBbox[0].y = resultVertice.back().y;
-
-				if (resultVertice.back().z < newBbox[0].z)
-					newBbox[0].z = resultVertice.back().z;
-
-				if (resultVertice.back().x > newBbox[1].x)
-					newBbox[1].x = resultVertice.back().x;
+			repoWarning << "Potentially incorrect transformation : does not expect the last row to have values!";
+			repoWarning << matrix.toString();
+		}
 
-				if (resultVertice.back().y > newBbox[1].y)
-					newBbox[1].y = resultVertice.back().y;
+		resultVertice.resize(vertices.size());
+		newBbox.resize(2);
+		matrix.transformPositions(vertices.data(), resultVertice.data(), vertices.size(), newBbox[0], newBbox[1]);
 
-				if (resultVertice.back().z > newBbox[1].z)
-					newBbox[1].z = resultVertice.back().z;
-			}
-			else
-			{
-				newBbox.push_back(resultVertice.back());
-				newBbox.push_back(resultVertice.back());
-			}
-		}
 		if (newBigFiles.find(REPO_NODE_MESH_LABEL_VERTICES) != newBigFiles.end())
 		{
 			const uint64_t verticesByteCount = resultVertice.size() * sizeof(repo::lib::RepoVector3D);
@@ -92,26 +74,11 @@ RepoNode MeshNode::cloneAndApplyTransformation(
 		else
 			builder.appendBinary(REPO_NODE_MESH_LABEL_VERTICES, resultVertice.data(), resultVertice.size() * sizeof(repo::lib::RepoVector3D));
 
+		std::vector<repo::lib::RepoVector3D> resultNormals;
 		if (normals.size())
 		{
-			auto matInverse = matrix.invert();
-			auto worldMat = matInverse.transpose();
-
-			std::vector<repo::lib::RepoVector3D> resultNormals;
-			resultNormals.reserve(normals.size());
-
-			auto data = worldMat.getData();
-			data[3] = data[7] = data[11] = 0;
-			data[12] = data[13] = data[14] = 0;
-
-			repo::lib::RepoMatrix multMat(data);
-
-			for (const repo::lib::RepoVector3D &v : normals)
-			{
-				auto transformedNormal = multMat * v;
-				transformedNormal.normalize();
-				resultNormals.push_back(transformedNormal);
-			}
+			resultNormals.resize(normals.size());
+			matrix.transformNormals(normals.data(), resultNormals.data(), normals.size());
 
 			if (newBigFiles.find(REPO_NODE_MESH_LABEL_NORMALS) != newBigFiles.end())
 			{
@@ -146,12 +113,19 @@ RepoNode MeshNode::cloneAndApplyTransformation(
 		outlineBuilder.appendArray("3", outline3);
 		builder.appendArray(REPO_NODE_MESH_LABEL_OUTLINE, outlineBuilder.obj());
 
+		//New geometry, new hash. External files are renamed accordingly so they are not confused with the originals
+		const std::string sha256 = hashGeometry(resultVertice, getFacesView().serialised(), resultNormals,
+			getColorsView(), getUVChannelsSeparatedView());
+		builder << REPO_NODE_MESH_LABEL_SHA256 << sha256;
+		for (auto &file : newBigFiles)
+			file.second.first = getGeometryFileName(sha256, file.first);
+
 		return MeshNode(builder.appendElementsUnique(*this), newBigFiles);
 	}
 	else
 	{
 		repoError << "Unable to apply transformation: Cannot find vertices within a mesh!";
-		return  RepoNode(this->copy(), bigFiles);
+		return  RepoNode(cloneWithBigFiles(this->copy()));
 	}
 }
 
@@ -183,7 +157,42 @@ MeshNode MeshNode::cloneAndUpdateMeshMapping(
 	//append the rest of the mesh onto this new bson
 	builder.appendElementsUnique(*this);
 
-	return MeshNode(builder.obj(), bigFiles);
+	return MeshNode(cloneWithBigFiles(builder.obj()));
+}
+
+std::string MeshNode::getSHA256() const
+{
+	if (hasField(REPO_NODE_MESH_LABEL_SHA256))
+		return getStringField(REPO_NODE_MESH_LABEL_SHA256);
+
+	return hashGeometry(getVerticesView(), getFacesView().serialised(), getNormalsView(),
+		getColorsView(), getUVChannelsSeparatedView());
+}
+
+std::string MeshNode::hashGeometry(
+	const repo::lib::RepoArrayView<repo::lib::RepoVector3D> &vertices,
+	const repo::lib::RepoArrayView<uint32_t> &serialisedFaces,
+	const repo::lib::RepoArrayView<repo::lib::RepoVector3D> &normals,
+	const repo::lib::RepoArrayView<repo_color4d_t> &colors,
+	const std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> &uvChannels)
+{
+	repo::lib::RepoSHA256 sha;
+	//Prefix every array with its size so the boundaries between them are part of the hash
+	auto addArray = [&sha](const void *data, const uint64_t &byteCount)
+	{
+		sha.update(&byteCount, sizeof(byteCount));
+		if (byteCount)
+			sha.update(data, byteCount);
+	};
+
+	addArray(vertices.data(), vertices.size() * sizeof(repo::lib::RepoVector3D));
+	addArray(serialisedFaces.data(), serialisedFaces.size() * sizeof(uint32_t));
+	addArray(normals.data(), normals.size() * sizeof(repo::lib::RepoVector3D));
+	addArray(colors.data(), colors.size() * sizeof(repo_color4d_t));
+	for (const auto &channel : uvChannels)
+		addArray(channel.data(), channel.size() * sizeof(repo::lib::RepoVector2D));
+
+	return sha.hexDigest();
 }
 
 std::vector<repo::lib::RepoVector3D> MeshNode::getBoundingBox() const
@@ -279,6 +288,25 @@ uint32_t MeshNode::getMFormat() const
 	return vBit | fBit | nBit | cBit | uvBits;
 }
 
+uint32_t MeshNode::getNumFaces() const
+{
+	if (hasBinField(REPO_NODE_MESH_LABEL_FACES) && hasField(REPO_NODE_MESH_LABEL_FACES_COUNT))
+		return getField(REPO_NODE_MESH_LABEL_FACES_COUNT).numberInt();
+
+	return 0;
+}
+
+uint32_t MeshNode::getNumVertices() const
+{
+	if (!hasBinField(REPO_NODE_MESH_LABEL_VERTICES))
+		return 0;
+
+	if (hasField(REPO_NODE_MESH_LABEL_VERTICES_COUNT))
+		return getField(REPO_NODE_MESH_LABEL_VERTICES_COUNT).numberInt();
+
+	return getVerticesView().size();
+}
+
 std::vector<repo_mesh_mapping_t> MeshNode::getMeshMapping() const
 {
 	std::vector<repo_mesh_mapping_t> mappings;
@@ -342,75 +370,81 @@ std::vector<repo::lib::RepoVector2D> MeshNode::getUVChannels() const
 std::vector<std::vector<repo::lib::RepoVector2D>> MeshNode::getUVChannelsSeparated() const
 {
 	std::vector<std::vector<repo::lib::RepoVector2D>> channels;
-
-	std::vector<repo::lib::RepoVector2D> serialisedChannels = getUVChannels();
-
-	if (serialisedChannels.size())
+	for (const auto &channel : getUVChannelsSeparatedView())
 	{
-		//get number of channels and split the serialised.
-		uint32_t nChannels = getField(REPO_NODE_MESH_LABEL_UV_CHANNELS_COUNT).numberInt();
-		uint32_t vecPerChannel = serialisedChannels.size() / nChannels;
-		channels.reserve(nChannels);
-		for (uint32_t i = 0; i < nChannels; i++)
-		{
-			channels.push_back(std::vector<repo::lib::RepoVector2D>());
-			channels[i].reserve(vecPerChannel);
-
-			uint32_t offset = i*vecPerChannel;
-			channels[i].insert(channels[i].begin(), serialisedChannels.begin() + offset,
-				serialisedChannels.begin() + offset + vecPerChannel);
-		}
+		channels.push_back(channel.toVector());
 	}
 	return channels;
 }
 
-std::vector<uint32_t> MeshNode::getFacesSerialized() const
+repo::lib::RepoFaceBuffer MeshNode::getFaces() const
 {
-	std::vector <uint32_t> serializedFaces;
-	if (hasBinField(REPO_NODE_MESH_LABEL_FACES))
-		getBinaryFieldAsVector(REPO_NODE_MESH_LABEL_FACES, serializedFaces);
-
-	return serializedFaces;
+	return repo::lib::RepoFaceBuffer(getFacesView());
 }
 
-std::vector<repo_face_t> MeshNode::getFaces() const
+repo::lib::RepoFaceStreamView MeshNode::getFacesView() const
 {
-	std::vector<repo_face_t> faces;
+	repo::lib::RepoFaceStreamView faces;
 
 	if (hasBinField(REPO_NODE_MESH_LABEL_FACES) && hasField(REPO_NODE_MESH_LABEL_FACES_COUNT))
 	{
-		std::vector <uint32_t> serializedFaces = std::vector<uint32_t>();
-		int32_t facesCount = getField(REPO_NODE_MESH_LABEL_FACES_COUNT).numberInt();
-		faces.reserve(facesCount);
-
-		getBinaryFieldAsVector(REPO_NODE_MESH_LABEL_FACES, serializedFaces);
-
-		// Retrieve numbers of vertices for each face and subsequent
-		// indices into the vertex array.
 		// In API level 1, mesh is represented as
 		// [n1, v1, v2, ..., n2, v1, v2...]
+		auto serializedFaces = getBinaryFieldAsView<uint32_t>(REPO_NODE_MESH_LABEL_FACES);
+		faces = repo::lib::RepoFaceStreamView(serializedFaces, getField(REPO_NODE_MESH_LABEL_FACES_COUNT).numberInt());
+	}
+
+	return faces;
+}
+
+repo::lib::RepoArrayView<repo_color4d_t> MeshNode::getColorsView() const
+{
+	if (hasBinField(REPO_NODE_MESH_LABEL_COLORS))
+		return getBinaryFieldAsView<repo_color4d_t>(REPO_NODE_MESH_LABEL_COLORS);
+
+	return repo::lib::RepoArrayView<repo_color4d_t>();
+}
+
+repo::lib::RepoArrayView<repo::lib::RepoVector3D> MeshNode::getNormalsView() const
+{
+	if (hasBinField(REPO_NODE_MESH_LABEL_NORMALS))
+		return getBinaryFieldAsView<repo::lib::RepoVector3D>(REPO_NODE_MESH_LABEL_NORMALS);
+
+	return repo::lib::RepoArrayView<repo::lib::RepoVector3D>();
+}
+
+repo::lib::RepoArrayView<repo::lib::RepoVector2D> MeshNode::getUVChannelsView() const
+{
+	if (hasField(REPO_NODE_MESH_LABEL_UV_CHANNELS_COUNT))
+		return getBinaryFieldAsView<repo::lib::RepoVector2D>(REPO_NODE_MESH_LABEL_UV_CHANNELS);
 
-		int mNumIndicesIndex = 0;
-		while (serializedFaces.size() > mNumIndicesIndex)
+	return repo::lib::RepoArrayView<repo::lib::RepoVector2D>();
+}
+
+std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> MeshNode::getUVChannelsSeparatedView() const
+{
+	std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> channels;
+	auto serialisedChannels = getUVChannelsView();
+	if (serialisedChannels.size())
+	{
+		uint32_t nChannels = getField(REPO_NODE_MESH_LABEL_UV_CHANNELS_COUNT).numberInt();
+		uint32_t vecPerChannel = serialisedChannels.size() / nChannels;
+		channels.reserve(nChannels);
+		for (uint32_t i = 0; i < nChannels; i++)
 		{
-			int mNumIndices = serializedFaces[mNumIndicesIndex];
-			if (serializedFaces.size() > mNumIndicesIndex + mNumIndices)
-			{
-				repo_face_t face;
-				face.resize(mNumIndices);
-				for (int i = 0; i < mNumIndices; ++i)
-					face[i] = serializedFaces[mNumIndicesIndex + 1 + i];
-				faces.push_back(face);
-				mNumIndicesIndex += mNumIndices + 1;
-			}
-			else
-			{
-				repoError << "Cannot copy all faces. Buffer size is smaller than expected!";
-			}
+			channels.push_back(serialisedChannels.subView(i*vecPerChannel, vecPerChannel));
 		}
 	}
+	return channels;
+}
 
-	return faces;
+repo::lib::RepoArrayView<repo::lib::RepoVector3D> MeshNode::getVerticesView() const
+{
+	if (hasBinField(REPO_NODE_MESH_LABEL_VERTICES))
+		return getBinaryFieldAsView<repo::lib::RepoVector3D>(REPO_NODE_MESH_LABEL_VERTICES);
+
+	repoWarning << "Could not find any vertices within mesh node (" << getUniqueID() << ")";
+	return repo::lib::RepoArrayView<repo::lib::RepoVector3D>();
 }
 
 RepoBSON MeshNode::meshMappingAsBSON(const repo_mesh_mapping_t  &mapping)
@@ -441,25 +475,20 @@ bool MeshNode::sEqual(const RepoNode &other) const
 
 	MeshNode otherMesh = MeshNode(other);
 
-	std::vector<repo::lib::RepoVector3D> vertices, vertices2, normals, normals2;
-	std::vector<repo::lib::RepoVector2D> uvChannels, uvChannels2;
-	std::vector<uint32_t> facesSerialized, facesSerialized2;
-	std::vector<repo_color4d_t> colors, colors2;
-
-	vertices = getVertices();
-	vertices2 = otherMesh.getVertices();
+	auto vertices = getVerticesView();
+	auto vertices2 = otherMesh.getVerticesView();
 
-	normals = getNormals();
-	normals2 = otherMesh.getNormals();
+	auto normals = getNormalsView();
+	auto normals2 = otherMesh.getNormalsView();
 
-	uvChannels = getUVChannels();
-	uvChannels2 = otherMesh.getUVChannels();
+	auto uvChannels = getUVChannelsView();
+	auto uvChannels2 = otherMesh.getUVChannelsView();
 
-	facesSerialized = getFacesSerialized();
-	facesSerialized2 = otherMesh.getFacesSerialized();
+	auto facesSerialized = getFacesView().serialised();
+	auto facesSerialized2 = otherMesh.getFacesView().serialised();
 
-	colors = getColors();
-	colors2 = otherMesh.getColors();
+	auto colors = getColorsView();
+	auto colors2 = otherMesh.getColorsView();
 
 	//check all the sizes match first, as comparing the content will be costly
 	bool success = vertices.size() == vertices2.size()
@@ -492,7 +521,7 @@ bool MeshNode::sEqual(const RepoNode &other) const
 
 		if (success && facesSerialized.size())
 		{
-			success &= !memcmp(facesSerialized.data(), facesSerialized.data(), facesSerialized.size() * sizeof(*facesSerialized.data()));
+			success &= !memcmp(facesSerialized.data(), facesSerialized2.data(), facesSerialized.size() * sizeof(*facesSerialized.data()));
 		}
 	}
 
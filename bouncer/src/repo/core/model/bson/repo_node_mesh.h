@@ -19,10 +19,14 @@
 */
 
 #pragma once
+#include <algorithm>
+#include <cctype>
+
 #include "repo_node.h"
 
 #include "../../../repo_bouncer_global.h"
 #include "../../../lib/datastructure/repo_structs.h"
+#include "../../../lib/datastructure/repo_array_view.h"
 
 namespace repo {
 	namespace core {
@@ -94,6 +98,21 @@ namespace repo {
 				*/
 				uint32_t getMFormat() const;
 
+				/**
+				* Get the number of faces within this mesh
+				* This is read from the stored count, the faces are not fetched
+				* @return returns the number of faces
+				*/
+				uint32_t getNumFaces() const;
+
+				/**
+				* Get the number of vertices within this mesh
+				* This is read from the stored count, the vertices are only
+				* fetched for nodes written before the count was recorded
+				* @return returns the number of vertices
+				*/
+				uint32_t getNumVertices() const;
+
 				/**
 				* Get the type of node
 				* @return returns the type as a string
@@ -174,9 +193,61 @@ namespace repo {
 				std::vector<repo_color4d_t> getColors() const;
 
 				/**
-				* Retrieve a vector of faces from the bson object
+				* Get the hash of the geometry of this mesh
+				* Meshes with identical geometry have the same hash. The hash stored
+				* within the node is returned if there is one, it is computed otherwise.
+				* @return returns the SHA-256 digest as a hex string
+				*/
+				std::string getSHA256() const;
+
+				/**
+				* Hash the geometry of a mesh: vertices, faces, normals, colors and uvs
+				* (bounding box and outline are derived from these)
+				* @return returns the SHA-256 digest as a hex string
+				*/
+				static std::string hashGeometry(
+					const repo::lib::RepoArrayView<repo::lib::RepoVector3D> &vertices,
+					const repo::lib::RepoArrayView<uint32_t> &serialisedFaces,
+					const repo::lib::RepoArrayView<repo::lib::RepoVector3D> &normals,
+					const repo::lib::RepoArrayView<repo_color4d_t> &colors,
+					const std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> &uvChannels);
+
+				/**
+				* Name of the external file holding a field of a mesh
+				* The name is derived from the geometry hash, so meshes with identical
+				* geometry refer to the same stored file.
+				* @param sha256 geometry hash of the mesh
+				* @param field field name
+				* @return returns the file name
+				*/
+				static std::string getGeometryFileName(
+					const std::string &sha256,
+					const std::string &field)
+				{
+					return sha256 + "_" + field;
+				}
+
+				/**
+				* Check if a name of an external file is derived from a geometry hash
+				* (see getGeometryFileName), such files hold the same content wherever
+				* the name is found
+				* @param fileName name of the file
+				* @return returns true if the name is made of a hash and a field name
 				*/
-				std::vector<repo_face_t> getFaces() const;
+				static bool isGeometryFileName(
+					const std::string &fileName)
+				{
+					const size_t hashLength = 64;
+					if (fileName.size() <= hashLength + 1 || fileName[hashLength] != '_')
+						return false;
+					return std::all_of(fileName.begin(), fileName.begin() + hashLength,
+						[](const char &c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+				}
+
+				/**
+				* Retrieve a copy of the faces from the bson object
+				*/
+				repo::lib::RepoFaceBuffer getFaces() const;
 
 				std::vector<repo_mesh_mapping_t> getMeshMapping() const;
 
@@ -200,6 +271,45 @@ namespace repo {
 				*/
 				std::vector<repo::lib::RepoVector3D> getVertices() const;
 
+				/**
+				* ------------- Zero copy accessors ---------------
+				* These return read only views pointing directly into
+				* the bson buffer (or the big files mapping).
+				* The views are only valid as long as this node is alive
+				* and unmodified, take a copy (toVector()) otherwise.
+				*/
+
+				/**
+				* Retrieve a view of the colors within this mesh
+				*/
+				repo::lib::RepoArrayView<repo_color4d_t> getColorsView() const;
+
+				/**
+				* Retrieve a view of the faces within this mesh,
+				* iterating over it yields the indices of each face.
+				*/
+				repo::lib::RepoFaceStreamView getFacesView() const;
+
+				/**
+				* Retrieve a view of the normals within this mesh
+				*/
+				repo::lib::RepoArrayView<repo::lib::RepoVector3D> getNormalsView() const;
+
+				/**
+				* Retrieve a view of all UV channels (serialised) within this mesh
+				*/
+				repo::lib::RepoArrayView<repo::lib::RepoVector2D> getUVChannelsView() const;
+
+				/**
+				* Retrieve a view for each UV channel within this mesh
+				*/
+				std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> getUVChannelsSeparatedView() const;
+
+				/**
+				* Retrieve a view of the vertices within this mesh
+				*/
+				repo::lib::RepoArrayView<repo::lib::RepoVector3D> getVerticesView() const;
+
 			private:
 				/**
 				* Given a mesh mapping, convert it into a bson object
@@ -207,11 +317,6 @@ namespace repo {
 				* @return return a bson object containing the mapping
 				*/
 				RepoBSON meshMappingAsBSON(const repo_mesh_mapping_t  &mapping);
-
-				/**
-				* Retrieve a vector of faces (serialised) from the bson object
-				*/
-				std::vector<uint32_t> getFacesSerialized() const;
 			};
 		} //namespace model
 	} //namespace core
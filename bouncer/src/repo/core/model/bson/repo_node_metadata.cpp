@@ -53,7 +53,7 @@ MetadataNode MetadataNode::cloneAndAddMetadata(
 
 	bsonBuilder << REPO_NODE_LABEL_METADATA << metaBuilder.obj();
 	bsonBuilder.appendElementsUnique(*this);
-	return MetadataNode(bsonBuilder.obj(), bigFiles);
+	return MetadataNode(cloneWithBigFiles(bsonBuilder.obj()));
 }
 
 bool MetadataNode::sEqual(const RepoNode &other) const
@@ -42,7 +42,7 @@ RevisionNode RevisionNode::cloneAndUpdateStatus(
 	switch (status)
 	{
 	case UploadStatus::COMPLETE:
-		return RepoNode(removeField(REPO_NODE_REVISION_LABEL_INCOMPLETE), bigFiles);
+		return RepoNode(cloneWithBigFiles(removeField(REPO_NODE_REVISION_LABEL_INCOMPLETE)));
 	case UploadStatus::UNKNOWN:
 		repoError << "Cannot set the status flag to Unknown state!";
 		return *this;
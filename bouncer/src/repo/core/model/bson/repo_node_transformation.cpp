@@ -46,7 +46,7 @@ RepoNode TransformationNode::cloneAndApplyTransformation(
 	
 	auto currentTrans = getTransMatrix(false);
 	auto resultTrans = currentTrans * matrix;
-	auto resultData = resultTrans.getData();
+	const float *resultData = resultTrans.getRawData();
 
 	RepoBSONBuilder rows;
 	for (uint32_t i = 0; i < 4; ++i)
@@ -63,7 +63,7 @@ RepoNode TransformationNode::cloneAndApplyTransformation(
 
 	builder.appendElementsUnique(*this);
 
-	return TransformationNode(RepoBSON(builder.obj(), bigFiles));
+	return TransformationNode(cloneWithBigFiles(builder.obj()));
 }
 
 TransformationNode TransformationNode::cloneAndResetMatrix() const
@@ -84,7 +84,7 @@ TransformationNode TransformationNode::cloneAndResetMatrix() const
 
 	builder.appendElementsUnique(*this);
 
-	return TransformationNode(RepoBSON(builder.obj(), bigFiles));
+	return TransformationNode(cloneWithBigFiles(builder.obj()));
 }
 
 std::vector<std::vector<float>> TransformationNode::identityMat()
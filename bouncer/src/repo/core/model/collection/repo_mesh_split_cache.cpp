@@ -0,0 +1,50 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_mesh_split_cache.h"
+
+using namespace repo::core::model;
+
+void MeshSplitCache::clear()
+{
+	boost::mutex::scoped_lock lock(mutex);
+	splits.clear();
+}
+
+std::shared_ptr<const MeshSplit> MeshSplitCache::find(
+	const repo::lib::RepoUUID &meshID,
+	const size_t              &vertThreshold) const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	auto it = splits.find({ meshID, vertThreshold });
+	return it == splits.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const MeshSplit> MeshSplitCache::insert(
+	const repo::lib::RepoUUID              &meshID,
+	const size_t                           &vertThreshold,
+	const std::shared_ptr<const MeshSplit> &split)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return splits.insert({ { meshID, vertThreshold }, split }).first->second;
+}
+
+size_t MeshSplitCache::size() const
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return splits.size();
+}
@@ -0,0 +1,99 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Mesh split cache - keeps the result of splitting a mesh into sub meshes
+* under a vertex limit, so every web format exported from the same scene
+* can reuse it instead of splitting the mesh again.
+*/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "../bson/repo_node_mesh.h"
+
+namespace repo{
+	namespace core{
+		namespace model{
+			/**
+			* Result of splitting a mesh into sub meshes
+			*/
+			struct MeshSplit
+			{
+				std::shared_ptr<MeshNode> remappedMesh; //mesh with the buffers and mappings of the sub meshes
+				std::vector<uint16_t> serialisedFaces; //faces of the remapped mesh as a triangle index buffer
+				std::vector<std::vector<float>> idMapBuf; //id map array of every sub mesh
+				std::vector<std::vector<repo_mesh_mapping_t>> matMap; //original mappings within every sub mesh
+				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping; //original mapping to sub mesh indices
+				uint64_t orgCacheMisses = 0; //vertex cache misses drawing the faces in their original order
+				uint64_t cacheMisses = 0; //vertex cache misses drawing serialisedFaces
+			};
+
+			class REPO_API_EXPORT MeshSplitCache
+			{
+			public:
+				MeshSplitCache() {}
+				~MeshSplitCache() {}
+
+				/**
+				* Remove every cached split
+				*/
+				void clear();
+
+				/**
+				* Find the split of a mesh
+				* @param meshID unique ID of the mesh
+				* @param vertThreshold vertex limit of the split
+				* @return returns the split, nullptr if it is not cached
+				*/
+				std::shared_ptr<const MeshSplit> find(
+					const repo::lib::RepoUUID &meshID,
+					const size_t              &vertThreshold) const;
+
+				/**
+				* Add the split of a mesh into the cache
+				* If the mesh already has a split cached for this threshold,
+				* the cached one is kept
+				* @param meshID unique ID of the mesh
+				* @param vertThreshold vertex limit of the split
+				* @param split split to add
+				* @return returns the split held by the cache
+				*/
+				std::shared_ptr<const MeshSplit> insert(
+					const repo::lib::RepoUUID              &meshID,
+					const size_t                           &vertThreshold,
+					const std::shared_ptr<const MeshSplit> &split);
+
+				/**
+				* Get the number of cached splits
+				* @return returns the number of cached splits
+				*/
+				size_t size() const;
+
+			private:
+				std::map<std::pair<repo::lib::RepoUUID, size_t>, std::shared_ptr<const MeshSplit>> splits;
+				mutable boost::mutex mutex;
+			};
+		} //namespace model
+	} //namespace core
+} //namespace repo
@@ -22,12 +22,19 @@
 
 #include <boost/assign.hpp>
 #include <boost/bind.hpp>
+#include <boost/chrono.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/copy.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
+#include <memory>
 
 #include "../../../lib/repo_log.h"
+#include "../../handler/repo_commit_pipeline.h"
 #include "../bson/repo_bson_builder.h"
 #include "../bson/repo_bson_factory.h"
 
@@ -548,6 +555,12 @@ bool RepoScene::commit(
 		return false;
 	}
 
+	if (loadProfile != LoadProfile::FULL)
+	{
+		errMsg = "Cannot commit to the database - Scene was only partially loaded.";
+		return false;
+	}
+
 	if (success &= commitProjectSettings(handler, errMsg, userName))
 	{
 		repoInfo << "Commited project settings, commiting revision...";
@@ -783,24 +796,45 @@ bool RepoScene::commitNodes(
 	repoGraphInstance &g = isStashGraph ? stashGraph : graph;
 	std::string ext = isStashGraph ? stashExt : sceneExt;
 
-	size_t count = 0;
-	size_t total = nodesToCommit.size();
+	const std::string collection = projectName + "." + ext;
+	const size_t total = nodesToCommit.size();
 
 	repoInfo << "Committing " << total << " nodes...";
 
-	for (const repo::lib::RepoUUID &id : nodesToCommit)
+	//Batches are written concurrently, one pooled connection per writer.
+	//The pipeline is finished before returning so the jobs may refer to locals.
+	repo::core::handler::CommitPipeline pipeline(handler);
+	std::atomic<size_t> committed(0);
+	auto batch = std::make_shared<std::vector<RepoBSON>>();
+	batch->reserve(std::min(commitBatchSize, total));
+	auto flushBatch = [&]()
 	{
-		if (++count % 500 == 0 || count == total - 1)
+		if (batch->size())
 		{
-			repoInfo << "Committing " << count << " of " << total;
+			pipeline.push([&, batch](
+				repo::core::handler::AbstractDatabaseHandler *handler, std::string &errMsg)
+			{
+				bool batchSuccess = handler->insertManyDocuments(databaseName, collection, *batch, errMsg);
+				repoInfo << "Committed " << (committed += batch->size()) << " of " << total;
+				return batchSuccess;
+			});
+			batch = std::make_shared<std::vector<RepoBSON>>();
+			batch->reserve(std::min(commitBatchSize, total));
 		}
+	};
 
+	for (const repo::lib::RepoUUID &id : nodesToCommit)
+	{
 		const repo::lib::RepoUUID uniqueID = gType == GraphType::OPTIMIZED ? id : g.sharedIDtoUniqueID[id];
 		RepoNode *node = g.nodesByUniqueID[uniqueID];
 		if (node->objsize() > handler->documentSizeLimit())
 		{
 			//Try to extract binary data out of the bson to shrink it.
-			RepoNode shrunkNode = node->cloneAndShrink();
+			//Mesh binaries are named after the geometry hash so identical meshes share their files
+			std::string filePrefix;
+			if (const MeshNode *mesh = dynamic_cast<const MeshNode*>(node))
+				filePrefix = mesh->getSHA256();
+			RepoNode shrunkNode = node->cloneAndShrink(filePrefix);
 			if (shrunkNode.objsize() > handler->documentSizeLimit())
 			{
 				success = false;
@@ -808,14 +842,26 @@ bool RepoScene::commitNodes(
 			}
 			else
 			{
+				//Nodes with GridFS files are committed on their own to avoid copying their binaries
 				node->swap(shrunkNode);
-				success &= handler->insertDocument(databaseName, projectName + "." + ext, *node, errMsg);
+				pipeline.push([&, node](
+					repo::core::handler::AbstractDatabaseHandler *handler, std::string &errMsg)
+				{
+					return handler->insertDocument(databaseName, collection, *node, errMsg);
+				});
 			}
 		}
 		else
-			success &= handler->insertDocument(databaseName, projectName + "." + ext, *node, errMsg);
+		{
+			batch->push_back(*node);
+			if (batch->size() >= commitBatchSize)
+				flushBatch();
+		}
 	}
 
+	flushBatch();
+	success &= pipeline.finish(errMsg);
+
 	return success;
 }
 
@@ -860,6 +906,11 @@ bool RepoScene::commitStash(
 		errMsg += "Revision node not found, make sure the default scene graph is commited";
 		return false;
 	}
+	else if (loadProfile == LoadProfile::TREE || loadProfile == LoadProfile::METADATA)
+	{
+		errMsg += "Cannot commit stash graph - the scene was loaded without its geometry";
+		return false;
+	}
 	else
 	{
 		rev = revNode->getUniqueID();
@@ -976,6 +1027,38 @@ std::vector<RepoNode*> RepoScene::getParentNodesFiltered(
 	return results;
 }
 
+std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> RepoScene::getMeshInstanceCounts(
+	const GraphType &gType) const
+{
+	//Number of paths from the root to a node, memoised by shared ID
+	std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> pathCounts;
+	if (const RepoNode *root = getRoot(gType))
+		pathCounts[root->getSharedID()] = 1;
+
+	std::function<uint32_t(const RepoNode*)> countPaths = [&](const RepoNode *node) -> uint32_t
+	{
+		const repo::lib::RepoUUID sharedID = node->getSharedID();
+		auto it = pathCounts.find(sharedID);
+		if (it != pathCounts.end())
+			return it->second;
+
+		pathCounts[sharedID] = 0; //do not loop forever on a malformed graph
+		uint32_t count = 0;
+		for (const repo::lib::RepoUUID &parentID : node->getParentIDs())
+		{
+			if (const RepoNode *parent = getNodeBySharedID(gType, parentID))
+				count += countPaths(parent);
+		}
+		return pathCounts[sharedID] = count;
+	};
+
+	std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> instances;
+	for (const RepoNode *mesh : getAllMeshes(gType))
+		instances[mesh->getUniqueID()] = countPaths(mesh);
+
+	return instances;
+}
+
 std::string RepoScene::getBranchName() const
 {
 	std::string branchName("master");
@@ -991,105 +1074,114 @@ std::string RepoScene::getBranchName() const
 	return branchName;
 }
 
-std::vector<repo::lib::RepoVector3D> RepoScene::getSceneBoundingBox() const
+static void expandBoundingBox(
+	std::vector<repo::lib::RepoVector3D> &bbox,
+	const repo::lib::RepoVector3D *points,
+	const size_t &n)
+{
+	if (!n) return;
+	if (bbox.size() < 2)
+	{
+		bbox = { points[0], points[0] };
+	}
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const auto &p = points[i];
+		if (p.x < bbox[0].x) bbox[0].x = p.x;
+		if (p.y < bbox[0].y) bbox[0].y = p.y;
+		if (p.z < bbox[0].z) bbox[0].z = p.z;
+
+		if (p.x > bbox[1].x) bbox[1].x = p.x;
+		if (p.y > bbox[1].y) bbox[1].y = p.y;
+		if (p.z > bbox[1].z) bbox[1].z = p.z;
+	}
+}
+
+std::vector<repo::lib::RepoVector3D> RepoScene::getSceneBoundingBox(
+	const bool &exact) const
 {
 	std::vector<repo::lib::RepoVector3D> bbox;
 	GraphType gType = stashGraph.rootNode ? GraphType::OPTIMIZED : GraphType::DEFAULT;
 
-	std::vector<float> identity = {
-		1, 0, 0, 0,
-		0, 1, 0, 0,
-		0, 0, 1, 0,
-		0, 0, 0, 1, };
-
-	getSceneBoundingBoxInternal(gType, gType == GraphType::OPTIMIZED ? stashGraph.rootNode : graph.rootNode, identity, bbox);
+	getSceneBoundingBoxInternal(gType, gType == GraphType::OPTIMIZED ? stashGraph.rootNode : graph.rootNode, exact, bbox);
 	return bbox;
 }
 
 void RepoScene::getSceneBoundingBoxInternal(
 	const GraphType            &gType,
 	const RepoNode             *node,
-	const repo::lib::RepoMatrix   &mat,
+	const bool                 &exact,
 	std::vector<repo::lib::RepoVector3D> &bbox) const
 {
-	if (node)
+	if (!node) return;
+
+	//World matrices are accumulated once per transformation visited,
+	//nodes on the stack refer to the matrix of their parent by index
+	std::vector<repo::lib::RepoMatrix> worldMats = { repo::lib::RepoMatrix() };
+	std::vector<std::pair<const RepoNode*, size_t>> toVisit = { { node, 0 } };
+	std::vector<repo::lib::RepoVector3D> transformed;
+
+	while (toVisit.size())
 	{
-		switch (node->getTypeAsEnum())
+		const RepoNode *current = toVisit.back().first;
+		const size_t matIdx = toVisit.back().second;
+		toVisit.pop_back();
+
+		switch (current->getTypeAsEnum())
 		{
 		case NodeType::TRANSFORMATION:
 		{
-			const TransformationNode *trans = dynamic_cast<const TransformationNode*>(node);
-			auto matTransformed = mat * trans->getTransMatrix(false);
+			const TransformationNode *trans = dynamic_cast<const TransformationNode*>(current);
+			worldMats.push_back(worldMats[matIdx] * trans->getTransMatrix(false));
+			const size_t childMatIdx = worldMats.size() - 1;
 
 			for (const auto & child : getChildrenAsNodes(gType, trans->getSharedID()))
 			{
-				getSceneBoundingBoxInternal(gType, child, matTransformed, bbox);
+				toVisit.push_back({ child, childMatIdx });
 			}
 			break;
 		}
 		case NodeType::MESH:
 		{
-			const MeshNode *mesh = dynamic_cast<const MeshNode*>(node);
-			//FIXME: can we figure this out from the existing bounding box?
-			MeshNode transedMesh = mesh->cloneAndApplyTransformation(mat);
-			auto newmBBox = transedMesh.getBoundingBox();
+			const MeshNode *mesh = dynamic_cast<const MeshNode*>(current);
+			const auto &mat = worldMats[matIdx];
+			if (!mat.isAffine())
+			{
+				repoWarning << "Potentially incorrect transformation : does not expect the last row to have values!";
+				repoWarning << mat.toString();
+			}
+			auto meshBBox = exact ? std::vector<repo::lib::RepoVector3D>() : mesh->getBoundingBox();
 
-			if (bbox.size())
+			if (meshBBox.size() >= 2)
 			{
-				if (newmBBox[0].x < bbox[0].x)
-					bbox[0].x = newmBBox[0].x;
-				if (newmBBox[0].y < bbox[0].y)
-					bbox[0].y = newmBBox[0].y;
-				if (newmBBox[0].z < bbox[0].z)
-					bbox[0].z = newmBBox[0].z;
-
-				if (newmBBox[1].x > bbox[1].x)
-					bbox[1].x = newmBBox[1].x;
-				if (newmBBox[1].y > bbox[1].y)
-					bbox[1].y = newmBBox[1].y;
-				if (newmBBox[1].z > bbox[1].z)
-					bbox[1].z = newmBBox[1].z;
+				//The transformed box of the 8 corners encloses the transformed mesh
+				const repo::lib::RepoVector3D &bmin = meshBBox[0], &bmax = meshBBox[1];
+				repo::lib::RepoVector3D corners[8] = {
+					{ bmin.x, bmin.y, bmin.z }, { bmax.x, bmin.y, bmin.z },
+					{ bmin.x, bmax.y, bmin.z }, { bmax.x, bmax.y, bmin.z },
+					{ bmin.x, bmin.y, bmax.z }, { bmax.x, bmin.y, bmax.z },
+					{ bmin.x, bmax.y, bmax.z }, { bmax.x, bmax.y, bmax.z } };
+				mat.transformPositions(corners, corners, 8);
+				expandBoundingBox(bbox, corners, 8);
 			}
 			else
 			{
-				//no bbox yet
-				bbox.push_back(newmBBox[0]);
-				bbox.push_back(newmBBox[1]);
+				auto vertices = mesh->getVerticesView();
+				transformed.resize(vertices.size());
+				mat.transformPositions(vertices.data(), transformed.data(), vertices.size());
+				expandBoundingBox(bbox, transformed.data(), transformed.size());
 			}
-
 			break;
 		}
 		case NodeType::REFERENCE:
 		{
-			repoGraphInstance g = gType == GraphType::DEFAULT ? graph : stashGraph;
-			auto refSceneIt = graph.referenceToScene.find(node->getSharedID());
+			auto refSceneIt = graph.referenceToScene.find(current->getSharedID());
 			if (refSceneIt != graph.referenceToScene.end())
 			{
 				const RepoScene *refScene = refSceneIt->second;
-				const std::vector<repo::lib::RepoVector3D> refSceneBbox = refScene->getSceneBoundingBox();
-
-				if (bbox.size())
-				{
-					if (refSceneBbox[0].x < bbox[0].x)
-						bbox[0].x = refSceneBbox[0].x;
-					if (refSceneBbox[0].y < bbox[0].y)
-						bbox[0].y = refSceneBbox[0].y;
-					if (refSceneBbox[0].z < bbox[0].z)
-						bbox[0].z = refSceneBbox[0].z;
-
-					if (refSceneBbox[1].x > bbox[1].x)
-						bbox[1].x = refSceneBbox[1].x;
-					if (refSceneBbox[1].y > bbox[1].y)
-						bbox[1].y = refSceneBbox[1].y;
-					if (refSceneBbox[1].z > bbox[1].z)
-						bbox[1].z = refSceneBbox[1].z;
-				}
-				else
-				{
-					//no bbox yet
-					bbox.push_back(refSceneBbox[0]);
-					bbox.push_back(refSceneBbox[1]);
-				}
+				const std::vector<repo::lib::RepoVector3D> refSceneBbox = refScene->getSceneBoundingBox(exact);
+				expandBoundingBox(bbox, refSceneBbox.data(), refSceneBbox.size());
 			}
 			break;
 		}
@@ -1209,13 +1301,24 @@ bool RepoScene::loadScene(
 	}
 
 	//Get the relevant nodes from the scene graph using the unique IDs stored in this revision node
+	//Nodes are added as the batches arrive, the next batch is fetched in the meantime
 	RepoBSON idArray = revNode->getObjectField(REPO_NODE_REVISION_LABEL_CURRENT_UNIQUE_IDS);
-	std::vector<RepoBSON> nodes = handler->findAllByUniqueIDs(
-		databaseName, projectName + "." + sceneExt, idArray);
+	size_t nNodes = 0;
+	if (!handler->findAllByUniqueIDs(databaseName, projectName + "." + sceneExt, idArray,
+		[&](std::vector<RepoBSON> &nodes)
+	{
+		nNodes += nodes.size();
+		success &= populate(GraphType::DEFAULT, nodes, errMsg);
+		return true;
+	}, getLoadProjection()))
+	{
+		errMsg += "Failed to retrieve the nodes of the scene";
+		return false;
+	}
 
-	repoInfo << "# of nodes in this unoptimised scene = " << nodes.size();
+	repoInfo << "# of nodes in this unoptimised scene = " << nNodes;
 
-	return populate(GraphType::DEFAULT, handler, nodes, errMsg);
+	return loadReferenceScenes(GraphType::DEFAULT, handler, errMsg) && success;
 }
 
 bool RepoScene::loadStash(
@@ -1237,20 +1340,52 @@ bool RepoScene::loadStash(
 	RepoBSONBuilder builder;
 	builder.append(REPO_NODE_STASH_REF, revNode->getUniqueID());
 
-	std::vector<RepoBSON> nodes = handler->findAllByCriteria(databaseName, projectName + "." + stashExt, builder.obj());
-	if (success = nodes.size())
+	//Nodes are added as the batches arrive, the next batch is fetched in the meantime
+	size_t nNodes = 0;
+	if (!handler->findAllByCriteria(databaseName, projectName + "." + stashExt, builder.obj(),
+		[&](std::vector<RepoBSON> &nodes)
+	{
+		nNodes += nodes.size();
+		success &= populate(GraphType::OPTIMIZED, nodes, errMsg);
+		return true;
+	}, getLoadProjection()))
+	{
+		//A partially loaded stash would pass for a complete one
+		errMsg += "Failed to fetch the stash graph from the database";
+		return false;
+	}
+
+	if (nNodes)
 	{
-		repoInfo << "# of nodes in this stash scene = " << nodes.size();
-		success = populate(GraphType::OPTIMIZED, handler, nodes, errMsg);
+		repoInfo << "# of nodes in this stash scene = " << nNodes;
+		success = loadReferenceScenes(GraphType::OPTIMIZED, handler, errMsg) && success;
 	}
 	else
 	{
 		errMsg += "stash is empty";
+		success = false;
 	}
 
 	return  success;
 }
 
+void RepoScene::prefetchBinaries(
+	const GraphType &gType,
+	const uint32_t  &nThreads)
+{
+	const repoGraphInstance &g = gType == GraphType::OPTIMIZED ? stashGraph : graph;
+	std::vector<const RepoBSON*> nodes;
+	nodes.reserve(g.nodesByUniqueID.size());
+	for (const auto &pair : g.nodesByUniqueID)
+	{
+		if (pair.second && pair.second->hasOversizeFiles())
+			nodes.push_back(pair.second);
+	}
+
+	repoTrace << "Prefetching binaries of " << nodes.size() << " nodes...";
+	RepoBSON::prefetchBigFiles(nodes, nThreads);
+}
+
 void RepoScene::modifyNode(
 	const GraphType                   &gtype,
 	RepoNode                          *nodeToChange,
@@ -1380,19 +1515,15 @@ void RepoScene::removeNode(
 
 bool RepoScene::populate(
 	const GraphType &gtype,
-	repo::core::handler::AbstractDatabaseHandler *handler,
-	std::vector<RepoBSON> nodes,
+	const std::vector<RepoBSON> &nodes,
 	std::string &errMsg)
 {
 	bool success = true;
 
 	repoGraphInstance &g = gtype == GraphType::OPTIMIZED ? stashGraph : graph;
 
-	std::unordered_map<repo::lib::RepoUUID, RepoNode *, repo::lib::RepoUUIDHasher> nodesBySharedID;
-	for (std::vector<RepoBSON>::const_iterator it = nodes.begin();
-		it != nodes.end(); ++it)
+	for (const auto &obj : nodes)
 	{
-		RepoBSON obj = *it;
 		RepoNode *node = NULL;
 
 		std::string nodeType = obj.getField(REPO_NODE_LABEL_TYPE).str();
@@ -1441,38 +1572,118 @@ bool RepoScene::populate(
 		success &= addNodeToMaps(gtype, node, errMsg);
 	} //Node Iteration
 
+	return success;
+}
+
+RepoBSON RepoScene::getLoadProjection() const
+{
+	RepoBSONBuilder builder;
+	switch (loadProfile)
+	{
+	case LoadProfile::FULL:
+		break;
+	case LoadProfile::GEOMETRY:
+		builder << REPO_NODE_LABEL_METADATA << 0;
+		break;
+	case LoadProfile::METADATA:
+		builder << REPO_NODE_LABEL_METADATA << 1;
+		//fall through, metadata comes on top of the tree
+	case LoadProfile::TREE:
+		for (const auto &field : { REPO_NODE_LABEL_ID, REPO_NODE_LABEL_SHARED_ID, REPO_NODE_LABEL_PARENTS,
+			REPO_NODE_LABEL_NAME, REPO_NODE_LABEL_TYPE, REPO_NODE_STASH_REF,
+			REPO_NODE_REFERENCE_LABEL_OWNER, REPO_NODE_REFERENCE_LABEL_PROJECT,
+			REPO_NODE_REFERENCE_LABEL_REVISION_ID, REPO_NODE_REFERENCE_LABEL_UNIQUE })
+		{
+			builder << field << 1;
+		}
+		break;
+	}
+	return builder.obj();
+}
+
+RepoScene* RepoScene::loadReferenceScene(
+	const ReferenceNode *reference,
+	repo::core::handler::AbstractDatabaseHandler *handler,
+	std::string &errMsg) const
+{
+	const auto start = boost::chrono::steady_clock::now();
+
+	//construct a new RepoScene with the information from reference node
+	std::string spDbName = reference->getDatabaseName();
+	if (spDbName.empty()) spDbName = databaseName;
+	RepoScene *refg = new RepoScene(spDbName, reference->getProjectName(), sceneExt, revExt);
+	refg->setLoadProfile(loadProfile);
+	if (reference->useSpecificRevision())
+		refg->setRevision(reference->getRevisionID());
+	else
+		refg->setBranch(reference->getRevisionID());
+
+	//Try to load the stash first, if fail, try scene.
+	if (!(refg->loadStash(handler, errMsg) || refg->loadScene(handler, errMsg)))
+	{
+		delete refg;
+		refg = nullptr;
+	}
+
+	const auto elapsed = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - start);
+	repoInfo << "Reference scene " << spDbName << "." << reference->getProjectName()
+		<< (refg ? " loaded in " : " failed to load after ") << elapsed.count() << "ms";
+
+	return refg;
+}
+
+bool RepoScene::loadReferenceScenes(
+	const GraphType &gtype,
+	repo::core::handler::AbstractDatabaseHandler *handler,
+	std::string &errMsg)
+{
+	bool success = true;
+
+	repoGraphInstance &g = gtype == GraphType::OPTIMIZED ? stashGraph : graph;
+
 	//deal with References
-	RepoNodeSet::iterator refIt;
 	//Make sure it is propagated into the repoScene if it exists in revision node
 
 	if (g.references.size()) worldOffset.clear();
-	if (!ignoreReferenceNodes)
+	if (!ignoreReferenceNodes && g.references.size())
 	{
+		std::vector<const ReferenceNode*> references;
 		for (const auto &node : g.references)
-		{
-			ReferenceNode* reference = (ReferenceNode*)node;
-
-			//construct a new RepoScene with the information from reference node and append this g to the Scene
-			std::string spDbName = reference->getDatabaseName();
-			if (spDbName.empty()) spDbName = databaseName;
-			RepoScene *refg = new RepoScene(spDbName, reference->getProjectName(), sceneExt, revExt);
-			if (reference->useSpecificRevision())
-				refg->setRevision(reference->getRevisionID());
-			else
-				refg->setBranch(reference->getRevisionID());
+			references.push_back((const ReferenceNode*)node);
 
-			//Try to load the stash first, if fail, try scene.
-			if (refg->loadStash(handler, errMsg) || refg->loadScene(handler, errMsg))
+		//Load the referenced scenes concurrently, each load takes its connections from the handler's pool
+		std::vector<RepoScene*> refScenes(references.size(), nullptr);
+		std::vector<std::string> refErrors(references.size());
+		std::atomic<size_t> next(0);
+		auto loadReferences = [&]()
+		{
+			for (size_t i = next++; i < references.size(); i = next++)
+				refScenes[i] = loadReferenceScene(references[i], handler, refErrors[i]);
+		};
+
+		const uint32_t nThreads = std::max<uint32_t>(1,
+			std::min<uint32_t>(handler ? handler->connectionLimit() : 1, references.size()));
+		repoInfo << "Loading " << references.size() << " referenced scenes with " << nThreads << " threads...";
+		boost::thread_group loaders;
+		for (uint32_t i = 1; i < nThreads; ++i)
+			loaders.create_thread(loadReferences);
+		loadReferences();
+		loaders.join_all();
+
+		//Gather the results in order so the outcome does not depend on which load finished first
+		for (size_t i = 0; i < references.size(); ++i)
+		{
+			if (refScenes[i])
 			{
-				g.referenceToScene[reference->getSharedID()] = refg;
-				auto refOffset = refg->getWorldOffset();
+				g.referenceToScene[references[i]->getSharedID()] = refScenes[i];
 				if (!worldOffset.size())
 				{
-					worldOffset = refOffset;
+					worldOffset = refScenes[i]->getWorldOffset();
 				}
 			}
 			else {
-				repoWarning << "Failed to load reference node for ref ID" << reference->getUniqueID() << ": " << errMsg;
+				errMsg += refErrors[i];
+				repoWarning << "Failed to load reference node for ref ID" << references[i]->getUniqueID() << ": " << refErrors[i];
 			}
 		}
 	}
@@ -1554,7 +1765,7 @@ void RepoScene::validateScene()
 	for (const auto &meshNode : graph.meshes)
 	{
 		auto mesh = dynamic_cast<const MeshNode*>(meshNode);
-		for (const auto face : mesh->getFaces())
+		for (const auto face : mesh->getFacesView())
 		{
 			if (invalidMesh = (face.size() != 3))
 				break;
@@ -58,6 +58,7 @@ namespace repo{
 				static const uint16_t REPO_SCENE_TEXTURE_BIT = 0x0001;
 				static const uint16_t REPO_SCENE_ENTITIES_BIT = 0x0002;
 				static const uint16_t REPO_SCENE_INVALID_MESH_BIT = 0x0003;
+				static const size_t REPO_SCENE_DEFAULT_COMMIT_BATCH_SIZE = 1000;
 			public:
 
 				/**
@@ -66,6 +67,16 @@ namespace repo{
 				*/
 				enum class GraphType { DEFAULT, OPTIMIZED };
 
+				/**
+				* Which fields of the nodes are retrieved when loading a scene
+				* FULL - whole nodes
+				* TREE - only what is needed to walk the graph (IDs, parents, name, type and reference details)
+				* GEOMETRY - whole nodes except the content of metadata nodes
+				* METADATA - TREE and the content of metadata nodes
+				* Scenes loaded with anything but FULL cannot be committed.
+				*/
+				enum class LoadProfile { FULL, TREE, GEOMETRY, METADATA };
+
 				/**
 				* Used for loading scene graphs from database
 				* Constructor - instantiates a new scene graph representation.
@@ -157,6 +168,24 @@ namespace repo{
 					ignoreReferenceNodes = true;
 				}
 
+				/**
+				* Set which fields of the nodes are retrieved by loadScene() and loadStash()
+				* Referenced scenes are loaded with the same profile.
+				* @param profile the load profile
+				*/
+				void setLoadProfile(const LoadProfile &profile)
+				{
+					loadProfile = profile;
+				}
+
+				/**
+				* @return returns the profile the nodes are loaded with
+				*/
+				LoadProfile getLoadProfile() const
+				{
+					return loadProfile;
+				}
+
 				/**
 				* Check if default scene graph is missing texture
 				* @return returns true if missing textures
@@ -248,6 +277,7 @@ namespace repo{
 
 				/**
 				* Clears the contents within the Stash (if there is one)
+				* This also drops the mesh splits cached for it
 				*/
 				void clearStash();
 
@@ -450,6 +480,16 @@ namespace repo{
 				*/
 				void setDatabaseAndProjectName(std::string newDatabaseName, std::string newProjectName);
 
+				/**
+				* Set the maximum number of nodes sent to the database
+				* in a single insert when committing
+				* @param size number of nodes per batch (0 is treated as 1)
+				*/
+				void setCommitBatchSize(const size_t &size)
+				{
+					commitBatchSize = size ? size : 1;
+				}
+
 				/**
 				* Set project revision
 				* @param uuid of the revision.
@@ -534,6 +574,17 @@ namespace repo{
 					repo::core::handler::AbstractDatabaseHandler *handler,
 					std::string &errMsg);
 
+				/**
+				* Fetch the external (GridFS) binaries of every node in the graph
+				* Binaries of loaded nodes are otherwise fetched on first access,
+				* one at a time.
+				* @param gType graph to fetch the binaries of
+				* @param nThreads number of binaries fetched concurrently
+				*/
+				void prefetchBinaries(
+					const GraphType &gType,
+					const uint32_t  &nThreads);
+
 				/**
 				* Update revision status, if the scene is revisioned
 				* This will also update the record within the database
@@ -649,6 +700,16 @@ namespace repo{
 					const RepoNode  *node,
 					const NodeType  &type) const;
 
+				/**
+				* Get the number of instances of every mesh within the graph.
+				* A mesh with several parents (shared geometry) is instanced once
+				* for every path from the root node to it.
+				* @param gType graphType
+				* @return returns a map of mesh unique ID to its number of instances
+				*/
+				std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher>
+					getMeshInstanceCounts(const GraphType &gType) const;
+
 				/**
 				* Get Scene from reference node
 				*/
@@ -766,9 +827,13 @@ namespace repo{
 
 				/**
 				* Get a bounding box for the entire scene
+				* By default this is derived from the bounding box stored within
+				* each mesh, which is conservative but does not touch the vertices.
+				* @param exact if true, compute the box from every transformed vertex
 				* @return returns bounding box for the whole graph.
 				*/
-				std::vector<repo::lib::RepoVector3D> getSceneBoundingBox() const;
+				std::vector<repo::lib::RepoVector3D> getSceneBoundingBox(
+					const bool &exact = false) const;
 
 				/**
 				* Get all ID of nodes which are added since last revision
@@ -1036,30 +1101,61 @@ namespace repo{
 					std::string &errMsg);
 
 				/**
-				* Recursive function to find the scene's bounding box
+				* Find the bounding box of the sub graph starting at the given node
 				* @param gtype type of graph to navigate
-				* @param node current node
-				* @param mat transformation matrix
+				* @param node node to start from
+				* @param exact compute the box from the vertices instead of the mesh bounding boxes
 				* @param bbox boudning box (to return/update)
 				*/
 				void getSceneBoundingBoxInternal(
 					const GraphType            &gType,
 					const RepoNode             *node,
-					const repo::lib::RepoMatrix   &mat,
+					const bool                 &exact,
 					std::vector<repo::lib::RepoVector3D> &bbox) const;
 
+				/**
+				* Get the projection to retrieve nodes with, according to the load profile
+				* @return returns a mongo projection (empty for whole nodes)
+				*/
+				RepoBSON getLoadProjection() const;
+
+				/**
+				* Load the scene referenced by a reference node
+				* @param reference the reference node
+				* @param handler database handler to use for retrieval
+				* @param errMsg error message when this function returns nullptr
+				* @return returns the loaded scene, nullptr if it failed to load
+				*/
+				RepoScene* loadReferenceScene(
+					const ReferenceNode *reference,
+					repo::core::handler::AbstractDatabaseHandler *handler,
+					std::string &errMsg) const;
+
+				/**
+				* Load the scenes referenced by the reference nodes within the graph
+				* and place them within the federation's world coordinates
+				* The scenes are loaded concurrently, up to one per pooled connection.
+				* @param gtype which graph to load the references of
+				* @param handler database handler to use for retrieval
+				* @param errMsg error message when this function returns false
+				* @return returns true upon success
+				*/
+				bool loadReferenceScenes(
+					const GraphType &gtype,
+					repo::core::handler::AbstractDatabaseHandler *handler,
+					std::string &errMsg);
+
 				/**
 				* populate the collections (cameras, meshes etc) with the given nodes
+				* This can be called repeatedly as the nodes are retrieved.
 				* @param gtype which graph to populate
-				* @param handler database handler to use for retrieval
 				* @param nodes the nodes to populate with
 				* @param errMsg error message when this function returns false
 				* @return returns true if scene graph populated with no errors
 				*/
 				bool populate(
 					const GraphType &gtype,
-					repo::core::handler::AbstractDatabaseHandler *handler,
-					std::vector<RepoBSON> nodes,
+					const std::vector<RepoBSON> &nodes,
 					std::string &errMsg);
 
 				/**
@@ -1147,6 +1243,8 @@ namespace repo{
 				repoGraphInstance stashGraph; //current state of the optimized graph, given the branch/revision
 				uint16_t status; //health of the scene, 0 denotes healthy
 				bool ignoreReferenceNodes = false;
+				LoadProfile loadProfile = LoadProfile::FULL;
+				size_t commitBatchSize = REPO_SCENE_DEFAULT_COMMIT_BATCH_SIZE;
 			};
 		}//namespace graph
 	}//namespace manipulator
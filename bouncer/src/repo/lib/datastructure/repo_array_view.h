@@ -0,0 +1,151 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Read only, non owning views over contiguous buffers.
+* A view does not copy the data it points to - it is only valid
+* for as long as the buffer it was created from is alive and unmodified.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace repo{
+	namespace lib{
+		template <class T>
+		class RepoArrayView
+		{
+		public:
+			typedef const T* const_iterator;
+
+			RepoArrayView() : ptr(nullptr), count(0) {}
+
+			RepoArrayView(const T *ptr, const size_t &count) : ptr(ptr), count(count) {}
+
+			RepoArrayView(const std::vector<T> &vec) : ptr(vec.data()), count(vec.size()) {}
+
+			const T* data() const { return ptr; }
+
+			size_t size() const { return count; }
+
+			bool empty() const { return count == 0; }
+
+			const_iterator begin() const { return ptr; }
+
+			const_iterator end() const { return ptr + count; }
+
+			const T& operator[](const size_t &idx) const { return ptr[idx]; }
+
+			const T& back() const { return ptr[count - 1]; }
+
+			/**
+			* Return a sub view of this view
+			* @param offset starting element
+			* @param n number of elements (clamped to the end of the view)
+			* @return returns a view on the requested range
+			*/
+			RepoArrayView<T> subView(const size_t &offset, const size_t &n) const
+			{
+				if (offset >= count) return RepoArrayView<T>();
+				return RepoArrayView<T>(ptr + offset, offset + n > count ? count - offset : n);
+			}
+
+			/**
+			* Copy the content of the view into a vector
+			* @return returns a vector with a copy of the data
+			*/
+			std::vector<T> toVector() const
+			{
+				return std::vector<T>(begin(), end());
+			}
+
+		private:
+			const T *ptr;
+			size_t count;
+		};
+
+		/**
+		* View over a serialised faces buffer in the form of
+		* [n1, v1, v2, ..., n2, v1, v2...]
+		* Iterating over it yields a RepoArrayView of indices per face
+		* without allocating any memory.
+		*/
+		class RepoFaceStreamView
+		{
+		public:
+			class const_iterator
+			{
+			public:
+				const_iterator(const uint32_t *pos, const uint32_t *end) : pos(pos), last(end) {}
+
+				RepoArrayView<uint32_t> operator*() const
+				{
+					size_t n = *pos;
+					//Truncate a corrupted face rather than reading beyond the buffer
+					if (n >= (size_t)(last - pos)) n = last - pos - 1;
+					return RepoArrayView<uint32_t>(pos + 1, n);
+				}
+
+				const_iterator& operator++()
+				{
+					size_t n = *pos;
+					pos = n >= (size_t)(last - pos) ? last : pos + n + 1;
+					return *this;
+				}
+
+				bool operator==(const const_iterator &other) const { return pos == other.pos; }
+				bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+
+			private:
+				const uint32_t *pos;
+				const uint32_t *last;
+			};
+
+			RepoFaceStreamView() : nFaces(0) {}
+
+			/**
+			* @param stream the serialised faces buffer
+			* @param nFaces number of faces within the stream
+			*/
+			RepoFaceStreamView(const RepoArrayView<uint32_t> &stream, const size_t &nFaces)
+				: stream(stream), nFaces(nFaces) {}
+
+			const_iterator begin() const { return const_iterator(stream.begin(), stream.end()); }
+
+			const_iterator end() const { return const_iterator(stream.end(), stream.end()); }
+
+			/**
+			* @return returns the number of faces
+			*/
+			size_t size() const { return nFaces; }
+
+			bool empty() const { return stream.empty(); }
+
+			/**
+			* @return returns the underlying serialised buffer
+			*/
+			const RepoArrayView<uint32_t>& serialised() const { return stream; }
+
+		private:
+			RepoArrayView<uint32_t> stream;
+			size_t nFaces;
+		};
+	}
+}
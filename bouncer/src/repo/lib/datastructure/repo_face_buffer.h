@@ -0,0 +1,210 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Contiguous buffer of faces.
+* Faces are stored in one flat buffer, each prefixed by its number of indices:
+* [n1, v1, v2, ..., n2, v1, v2...]
+* This is identical to how faces are serialised within a mesh node,
+* so no conversion is required to read or write them.
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include "repo_array_view.h"
+
+namespace repo{
+	namespace lib{
+		class RepoFaceBuffer
+		{
+		public:
+			typedef RepoFaceStreamView::const_iterator const_iterator;
+
+			RepoFaceBuffer() : nFaces(0), polygonSize(0) {}
+
+			/**
+			* Construct a face buffer from a vector of faces
+			* @param faces faces to copy
+			*/
+			RepoFaceBuffer(const std::vector<std::vector<uint32_t>> &faces) : nFaces(0), polygonSize(0)
+			{
+				reserve(faces.size(), faces.size() ? faces[0].size() : 3);
+				for (const auto &face : faces)
+					push_back(face);
+			}
+
+			/**
+			* Construct a face buffer by copying the faces within a view
+			* @param faces faces to copy
+			*/
+			explicit RepoFaceBuffer(const RepoFaceStreamView &faces) : nFaces(0), polygonSize(0)
+			{
+				append(faces);
+			}
+
+			/**
+			* Reserve memory for the given number of faces
+			* @param n number of faces
+			* @param indicesPerFace expected number of indices per face
+			*/
+			void reserve(const size_t &n, const size_t &indicesPerFace = 3)
+			{
+				stream.reserve(n * (indicesPerFace + 1));
+			}
+
+			/**
+			* Add a face to the buffer
+			* @param face container of indices (anything with size(), begin() and end())
+			*/
+			template <class Container>
+			void push_back(const Container &face)
+			{
+				startFace(face.size());
+				for (const auto &idx : face)
+				{
+					//Negative indices wrap around and fail this too
+					assert(static_cast<uint64_t>(idx) <= std::numeric_limits<uint32_t>::max());
+					stream.push_back(static_cast<uint32_t>(idx));
+				}
+				++nFaces;
+			}
+
+			void push_back(std::initializer_list<uint32_t> face)
+			{
+				push_back<std::initializer_list<uint32_t>>(face);
+			}
+
+			/**
+			* Add a triangle to the buffer
+			*/
+			void addTriangle(const uint32_t &i0, const uint32_t &i1, const uint32_t &i2)
+			{
+				startFace(3);
+				stream.push_back(i0);
+				stream.push_back(i1);
+				stream.push_back(i2);
+				++nFaces;
+			}
+
+			/**
+			* Append all the faces within a view to the buffer
+			* @param faces faces to append
+			* @param indexOffset value to add to every index appended
+			*/
+			void append(const RepoFaceStreamView &faces, const uint32_t &indexOffset = 0)
+			{
+				stream.reserve(stream.size() + faces.serialised().size());
+				for (const auto face : faces)
+				{
+					startFace(face.size());
+					for (const auto &idx : face)
+						stream.push_back(idx + indexOffset);
+					++nFaces;
+				}
+			}
+
+			/**
+			* Get a face within the buffer, in constant time
+			* @param idx index of the face
+			* @return returns a view of the indices of this face
+			*/
+			RepoArrayView<uint32_t> operator[](const size_t &idx) const
+			{
+				if (polygonSize)
+				{
+					return RepoArrayView<uint32_t>(stream.data() + idx * (polygonSize + 1) + 1, polygonSize);
+				}
+
+				const uint32_t *face = stream.data() + offsets[idx];
+				return RepoArrayView<uint32_t>(face + 1, *face);
+			}
+
+			const_iterator begin() const { return view().begin(); }
+
+			const_iterator end() const { return view().end(); }
+
+			void clear()
+			{
+				stream.clear();
+				offsets.clear();
+				nFaces = 0;
+				polygonSize = 0;
+			}
+
+			bool empty() const { return nFaces == 0; }
+
+			/**
+			* @return returns the number of faces
+			*/
+			size_t size() const { return nFaces; }
+
+			/**
+			* @return returns the number of indices per face if all faces
+			*         have the same number of indices, 0 otherwise
+			*/
+			uint32_t getPolygonSize() const { return polygonSize; }
+
+			/**
+			* @return returns the serialised buffer
+			*/
+			const std::vector<uint32_t>& serialised() const { return stream; }
+
+			/**
+			* @return returns a read only view on the buffer
+			*/
+			RepoFaceStreamView view() const { return RepoFaceStreamView(stream, nFaces); }
+
+			operator RepoFaceStreamView() const { return view(); }
+
+		private:
+			/**
+			* Write the size of the next face into the stream and keep track
+			* of where faces start once they no longer have the same size
+			* @param n number of indices of the face
+			*/
+			void startFace(const size_t &n)
+			{
+				assert(n <= std::numeric_limits<uint32_t>::max());
+				if (!nFaces)
+				{
+					polygonSize = static_cast<uint32_t>(n);
+				}
+				else if (polygonSize && polygonSize != n)
+				{
+					//Every face so far has polygonSize indices
+					offsets.reserve(nFaces + 1);
+					for (size_t i = 0; i < nFaces; ++i)
+						offsets.push_back(i * (polygonSize + 1));
+					polygonSize = 0;
+				}
+
+				if (!polygonSize)
+					offsets.push_back(stream.size());
+				stream.push_back(static_cast<uint32_t>(n));
+			}
+
+			std::vector<uint32_t> stream;
+			std::vector<size_t> offsets; //start of every face within stream, only kept once face sizes are mixed
+			size_t nFaces;
+			uint32_t polygonSize;
+		};
+	}
+}
@@ -17,24 +17,30 @@
 
 
 #include "repo_matrix.h"
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 using namespace repo::lib;
 
+static const float identityMat[16] = { 1, 0, 0, 0,
+	0, 1, 0, 0,
+	0, 0, 1, 0,
+	0, 0, 0, 1 };
+
 RepoMatrix::RepoMatrix()
 {
-	data = { 1, 0, 0, 0,
-		0, 1, 0, 0,
-		0, 0, 1, 0,
-		0, 0, 0, 1 };
+	std::copy(identityMat, identityMat + 16, data);
+}
+
+RepoMatrix::RepoMatrix(const float *mat)
+{
+	std::copy(mat, mat + 16, data);
 }
 
 RepoMatrix::RepoMatrix(const std::vector<float> &mat)
 {
-	data = { 1, 0, 0, 0,
-		0, 1, 0, 0,
-		0, 0, 1, 0,
-		0, 0, 0, 1 };
+	std::copy(identityMat, identityMat + 16, data);
 
 	for (int i = 0; i < mat.size(); ++i)
 	{
@@ -46,19 +52,17 @@ RepoMatrix::RepoMatrix(const std::vector<float> &mat)
 
 RepoMatrix::RepoMatrix(const std::vector<std::vector<float>> &mat)
 {
-
-	data = { 1, 0, 0, 0,
-		0, 1, 0, 0,
-		0, 0, 1, 0,
-		0, 0, 0, 1 };
+	std::copy(identityMat, identityMat + 16, data);
 
 	int counter = 0;
 	for (const auto &row : mat)
 	{
 		for (const auto col : row)
+		{
+			if (counter >= 16) break;
 			data[counter++] = col;
+		}
 	}
-	if (data.size() > 16) data.resize(16);
 }
 
 
@@ -102,15 +106,22 @@ float RepoMatrix::determinant() const
 bool RepoMatrix::equals(const RepoMatrix &other) const
 {
 
-	auto otherData = other.getData();
+	const float *otherData = other.getRawData();
 	bool equal = true;
-	for (int i = 0; i < data.size(); ++i)
+	for (int i = 0; i < 16; ++i)
 	{
 		if (!(equal &= data[i] == otherData[i])) break;
 	}
 	return equal;
 }
 
+bool RepoMatrix::isAffine(const float &eps) const
+{
+	const float threshold = fabs(eps);
+	return fabs(data[12]) <= threshold && fabs(data[13]) <= threshold
+		&& fabs(data[14]) <= threshold && fabs(data[15] - 1) <= threshold;
+}
+
 bool RepoMatrix::isIdentity(const float &eps) const
 {
 	//  00 01 02 03
@@ -121,7 +132,7 @@ bool RepoMatrix::isIdentity(const float &eps) const
 	bool iden = true;
 	float threshold = fabs(eps);
 
-	for (size_t i = 0; i < data.size(); ++i)
+	for (size_t i = 0; i < 16; ++i)
 	{
 		if (i % 5)
 		{
@@ -140,8 +151,7 @@ bool RepoMatrix::isIdentity(const float &eps) const
 
 RepoMatrix RepoMatrix::invert() const
 {
-	std::vector<float> result;
-	result.resize(16);
+	float result[16] = { 0 };
 
 	const float det = determinant();
 	if (det == 0)
@@ -185,7 +195,7 @@ RepoMatrix RepoMatrix::invert() const
 std::string RepoMatrix::toString() const
 {
 	std::stringstream ss;
-	for (int i = 0; i < data.size(); ++i)
+	for (int i = 0; i < 16; ++i)
 	{
 		ss << " " << data[i];
 		if (i % 4 == 3)
@@ -199,8 +209,8 @@ std::string RepoMatrix::toString() const
 
 RepoMatrix RepoMatrix::transpose() const
 {
-	std::vector<float> result(data.begin(), data.end());
-
+	float result[16];
+	std::copy(data, data + 16, result);
 
 	/*
 	00 01 02 03             00 04 08 12
@@ -225,3 +235,103 @@ RepoMatrix RepoMatrix::transpose() const
 
 	return RepoMatrix(result);
 }
+
+/**
+* Transform positions by the affine part of a row major matrix, handing every
+* result to the visitor as well. The matrix is hoisted into locals and the
+* visitor is inlined, so the loop can be kept in registers/vectorised
+*/
+template <class Visitor>
+static inline void transformAffine(
+	const float                   *data,
+	const repo::lib::RepoVector3D *in,
+	repo::lib::RepoVector3D       *out,
+	const size_t                  &n,
+	Visitor                       &visit)
+{
+	const float m0 = data[0], m1 = data[1], m2 = data[2], m3 = data[3];
+	const float m4 = data[4], m5 = data[5], m6 = data[6], m7 = data[7];
+	const float m8 = data[8], m9 = data[9], m10 = data[10], m11 = data[11];
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const float x = in[i].x, y = in[i].y, z = in[i].z;
+		const float tx = m0 * x + m1 * y + m2 * z + m3;
+		const float ty = m4 * x + m5 * y + m6 * z + m7;
+		const float tz = m8 * x + m9 * y + m10 * z + m11;
+		out[i].x = tx;
+		out[i].y = ty;
+		out[i].z = tz;
+		visit(tx, ty, tz);
+	}
+}
+
+void RepoMatrix::transformPositions(
+	const repo::lib::RepoVector3D *in,
+	repo::lib::RepoVector3D       *out,
+	const size_t                  &n) const
+{
+	auto ignore = [](const float &x, const float &y, const float &z) {};
+	transformAffine(data, in, out, n, ignore);
+}
+
+void RepoMatrix::transformPositions(
+	const repo::lib::RepoVector3D *in,
+	repo::lib::RepoVector3D       *out,
+	const size_t                  &n,
+	repo::lib::RepoVector3D       &min,
+	repo::lib::RepoVector3D       &max) const
+{
+	if (!n) return;
+
+	//Keep the bounds in locals, writing through the references would stop the loop from being vectorised
+	float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+	float maxX = std::numeric_limits<float>::lowest(), maxY = maxX, maxZ = maxX;
+	auto expand = [&](const float &x, const float &y, const float &z)
+	{
+		minX = x < minX ? x : minX;
+		minY = y < minY ? y : minY;
+		minZ = z < minZ ? z : minZ;
+		maxX = x > maxX ? x : maxX;
+		maxY = y > maxY ? y : maxY;
+		maxZ = z > maxZ ? z : maxZ;
+	};
+	transformAffine(data, in, out, n, expand);
+
+	min = repo::lib::RepoVector3D(minX, minY, minZ);
+	max = repo::lib::RepoVector3D(maxX, maxY, maxZ);
+}
+
+void RepoMatrix::transformNormals(
+	const repo::lib::RepoVector3D *in,
+	repo::lib::RepoVector3D       *out,
+	const size_t                  &n) const
+{
+	//Normals are transformed by the inverse transpose, without translation
+	const RepoMatrix normalMat = invert().transpose();
+	const float *nm = normalMat.getRawData();
+	const float m0 = nm[0], m1 = nm[1], m2 = nm[2];
+	const float m4 = nm[4], m5 = nm[5], m6 = nm[6];
+	const float m8 = nm[8], m9 = nm[9], m10 = nm[10];
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		const float x = in[i].x, y = in[i].y, z = in[i].z;
+		const float tx = m0 * x + m1 * y + m2 * z;
+		const float ty = m4 * x + m5 * y + m6 * z;
+		const float tz = m8 * x + m9 * y + m10 * z;
+		const float length = std::sqrt(tx * tx + ty * ty + tz * tz);
+		if (length > 0)
+		{
+			out[i].x = tx / length;
+			out[i].y = ty / length;
+			out[i].z = tz / length;
+		}
+		else
+		{
+			out[i].x = tx;
+			out[i].y = ty;
+			out[i].z = tz;
+		}
+	}
+}
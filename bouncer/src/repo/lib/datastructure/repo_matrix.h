@@ -23,12 +23,18 @@
 
 namespace repo{
 	namespace lib{
+		/**
+		* 4x4 matrix, stored in row major order.
+		* The data is held inline (no heap allocation) and 16 byte aligned.
+		*/
 		class REPO_API_EXPORT RepoMatrix
 		{
 		public:
 
 			RepoMatrix();
 
+			explicit RepoMatrix(const float *mat);
+
 			RepoMatrix(const std::vector<float> &mat);
 
 			RepoMatrix(const std::vector<std::vector<float>> &mat);
@@ -37,19 +43,80 @@ namespace repo{
 
 			bool equals(const RepoMatrix &other) const;
 
-			std::vector<float> getData() const { return data; }
+			/**
+			* Get a copy of the matrix as a vector (row major)
+			* Use getRawData() for access without copying
+			*/
+			std::vector<float> getData() const { return std::vector<float>(data, data + 16); }
+
+			/**
+			* Get a pointer to the 16 floats of this matrix (row major)
+			*/
+			const float* getRawData() const { return data; }
 
 			RepoMatrix invert() const;
 
 			bool isIdentity(const float &eps = 10e-5) const;
 
+			/**
+			* Check if the matrix is an affine transformation
+			* (its last row is 0, 0, 0, 1)
+			* @param eps tolerance of the comparison
+			* @return returns true if the matrix is affine
+			*/
+			bool isAffine(const float &eps = 1e-5) const;
+
 			std::string toString() const;
 
 			RepoMatrix transpose() const;
 
+			/**
+			* Transform an array of positions by this matrix (as an affine transformation)
+			* The last row is ignored, callers should check isAffine() once per mesh
+			* in and out may point to the same array
+			* @param in positions to transform
+			* @param out array to write the results into (at least n long)
+			* @param n number of positions
+			*/
+			void transformPositions(
+				const repo::lib::RepoVector3D *in,
+				repo::lib::RepoVector3D       *out,
+				const size_t                  &n) const;
+
+			/**
+			* Transform an array of positions by this matrix (as an affine transformation)
+			* and compute the bounding box of the results in the same pass
+			* The last row is ignored, callers should check isAffine() once per mesh
+			* in and out may point to the same array
+			* @param in positions to transform
+			* @param out array to write the results into (at least n long)
+			* @param n number of positions
+			* @param min minimum corner of the bounding box (untouched if n is 0)
+			* @param max maximum corner of the bounding box (untouched if n is 0)
+			*/
+			void transformPositions(
+				const repo::lib::RepoVector3D *in,
+				repo::lib::RepoVector3D       *out,
+				const size_t                  &n,
+				repo::lib::RepoVector3D       &min,
+				repo::lib::RepoVector3D       &max) const;
+
+			/**
+			* Transform an array of normals by the inverse transpose of this matrix
+			* and normalise them.
+			* in and out may point to the same array
+			* @param in normals to transform
+			* @param out array to write the results into (at least n long)
+			* @param n number of normals
+			*/
+			void transformNormals(
+				const repo::lib::RepoVector3D *in,
+				repo::lib::RepoVector3D       *out,
+				const size_t                  &n) const;
+
 		private:
-			std::vector<float> data;
-			  
+			alignas(16) float data[16];
+
 		};
 
 
@@ -63,7 +130,7 @@ namespace repo{
 		inline repo::lib::RepoVector3D operator*(const RepoMatrix &matrix, const repo::lib::RepoVector3D &vec)
 		{
 			repo::lib::RepoVector3D result;
-			auto mat = matrix.getData();
+			const float *mat = matrix.getRawData();
 			/*
 			00 01 02 03
 			04 05 06 07
@@ -90,11 +157,10 @@ namespace repo{
 
 		inline RepoMatrix operator*(const RepoMatrix &matrix1, const RepoMatrix &matrix2)
 		{
-			std::vector<float> result;
-			result.resize(16);
+			alignas(16) float result[16];
 
-			auto mat1 = matrix1.getData();
-			auto mat2 = matrix2.getData();
+			const float *mat1 = matrix1.getRawData();
+			const float *mat2 = matrix2.getRawData();
 
 			for (int i = 0; i < 4; ++i)
 			{
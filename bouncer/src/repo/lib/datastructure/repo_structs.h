@@ -22,6 +22,7 @@
 #include "../../repo_bouncer_global.h"
 #include "repo_uuid.h"
 #include "repo_vector.h"
+#include "repo_face_buffer.h"
 
 typedef struct {
 	std::unordered_map<std::string, std::vector<uint8_t>> geoFiles; //files where geometery are stored
@@ -24,6 +24,7 @@ using namespace repo::lib;
 
 #include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -116,7 +117,11 @@ RepoUUID RepoUUID::fromBSONElement(const repo::core::model::RepoBSONElement &ele
 
 RepoUUID RepoUUID::createUUID()
 {
+	//The generator holds state and is not thread safe, IDs are created from many threads
+	//when scenes are optimised and exported in parallel
 	static boost::uuids::random_generator gen;
+	static boost::mutex genMutex;
+	boost::mutex::scoped_lock lock(genMutex);
 	return RepoUUID(gen());
 }
 
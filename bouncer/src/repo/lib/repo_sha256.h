@@ -0,0 +1,88 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* SHA-256 hashing (FIPS 180-4), used to address content such as mesh geometry.
+* Data can be fed in any number of pieces, the digest is the same as hashing
+* the concatenation of all of them.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../repo_bouncer_global.h"
+
+namespace repo{
+	namespace lib{
+		class REPO_API_EXPORT RepoSHA256
+		{
+		public:
+			RepoSHA256();
+
+			/**
+			* Add data to the hash
+			* @param data pointer to the data
+			* @param size number of bytes
+			*/
+			void update(const void *data, const size_t &size);
+
+			/**
+			* Add the content of a vector to the hash
+			* @param vec vector of plain data
+			*/
+			template <class T>
+			void update(const std::vector<T> &vec)
+			{
+				if (vec.size())
+					update(vec.data(), vec.size() * sizeof(T));
+			}
+
+			/**
+			* Finish hashing and return the digest
+			* No more data can be added after this is called.
+			* @return returns the digest as a lower case hex string (64 characters)
+			*/
+			std::string hexDigest();
+
+			/**
+			* Hash a single buffer
+			* @param data pointer to the data
+			* @param size number of bytes
+			* @return returns the digest as a lower case hex string
+			*/
+			static std::string hash(const void *data, const size_t &size)
+			{
+				RepoSHA256 sha;
+				sha.update(data, size);
+				return sha.hexDigest();
+			}
+
+		private:
+			void processBlock(const uint8_t *block);
+
+			uint32_t state[8];
+			uint8_t buffer[64];
+			size_t bufferSize;
+			uint64_t totalSize;
+			bool finished;
+			std::string digest;
+		};
+	}
+}
@@ -15,59 +15,116 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 /**
-* A (attempt to be) thread safe stack essentially that would push/pop items as required
-* Incredibly weird, I know.
+* A thread safe pool of items that would push/pop items as required.
+* pop() blocks until an item is available. Waiting threads are served
+* in the order they arrived and woken up as soon as an item is pushed.
 */
 
 #pragma once
 
-#include <stack>
+#include <algorithm>
+#include <deque>
+#include <vector>
 
+#include <boost/chrono.hpp>
 #include <boost/thread.hpp>
-#include <boost/date_time.hpp>
 #include "repo_log.h"
 
 namespace repo{
 	namespace lib{
+		struct RepoStackStats
+		{
+			uint64_t pops = 0;         //number of items handed out
+			uint64_t waits = 0;        //number of pops that had to wait for an item
+			uint64_t timeouts = 0;     //number of pops that gave up waiting
+			double totalWaitMs = 0;    //total time spent waiting
+			double maxWaitMs = 0;      //longest single wait
+			size_t highWaterMark = 0;  //maximum number of items handed out at once
+			size_t maxWaiting = 0;     //maximum number of threads waiting at once
+		};
+
 		template <class T>
 		class RepoStack
 		{
 		public:
+			/**
+			* @param maxRetry pop() gives up after waiting msTimeOut * (maxRetry + 1)
+			*        milliseconds. A negative value waits indefinitely
+			* @param msTimeOut see maxRetry
+			*/
 			RepoStack(
 				const int32_t &maxRetry = -1,
 				const uint32_t &msTimeOut = 50)
 				: maxRetry(maxRetry)
-				, msTimeOut(msTimeOut){}
+				, msTimeOut(msTimeOut)
+				, inUse(0){}
 			~RepoStack(){}
 
 			void push(T*& item) {
-				boost::mutex::scoped_lock lock(pushMutex);
+				boost::mutex::scoped_lock lock(mutex);
 				stack.push_back(item);
+				if (inUse) --inUse;
+				if (!waiters.empty())
+					waiters.front()->notify_one();
 			}
+
 			T* pop() {
-				//order potentially matters. Think before shuffling!
-				boost::mutex::scoped_lock popLock(popMutex); //stopping anyone from popping
-				boost::mutex::scoped_lock pushLock(pushMutex); //stopping anyone from pushing
+				typedef boost::chrono::steady_clock clock;
+				boost::mutex::scoped_lock lock(mutex);
 
-				uint8_t count = 0;
-				while (stack.empty())
+				if (!waiters.empty() || stack.empty())
 				{
-					//stack is empty. Release the push lock and try again in 50ms
-					pushLock.unlock();
-					boost::this_thread::sleep(boost::posix_time::milliseconds(msTimeOut * (count + 1 * 10)));
-					pushLock.lock();
-					if (maxRetry >= 0 && count++ > maxRetry) break;
-				}
+					//Queue up behind anyone already waiting
+					const auto start = clock::now();
+					const auto deadline = start + boost::chrono::milliseconds((uint64_t)msTimeOut * (maxRetry + 1));
+					boost::condition_variable waiter;
+					waiters.push_back(&waiter);
+					++stats.waits;
+					if (waiters.size() > stats.maxWaiting)
+						stats.maxWaiting = waiters.size();
 
-				if (!stack.empty())
-				{
-					T* item = (T*)stack.back();
-					stack.pop_back();
-					return item;
+					bool timedOut = false;
+					while (waiters.front() != &waiter || stack.empty())
+					{
+						if (maxRetry < 0)
+							waiter.wait(lock);
+						else if (waiter.wait_until(lock, deadline) == boost::cv_status::timeout
+							&& (waiters.front() != &waiter || stack.empty()))
+						{
+							timedOut = true;
+							break;
+						}
+					}
+
+					waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+
+					const double waitMs = boost::chrono::duration<double, boost::milli>(clock::now() - start).count();
+					stats.totalWaitMs += waitMs;
+					if (waitMs > stats.maxWaitMs)
+						stats.maxWaitMs = waitMs;
+
+					if (timedOut)
+					{
+						++stats.timeouts;
+						//Pass on the turn in case an item came in as we gave up
+						if (!waiters.empty() && !stack.empty())
+							waiters.front()->notify_one();
+						repoTrace << "Given up. returning nullptr";
+						return nullptr;
+					}
 				}
 
-				repoTrace << "Given up. returning nullptr";
-				return nullptr;
+				T* item = stack.back();
+				stack.pop_back();
+				++stats.pops;
+				if (++inUse > stats.highWaterMark)
+					stats.highWaterMark = inUse;
+
+				//Wake up the next in line if there are more items
+				if (!waiters.empty() && !stack.empty())
+					waiters.front()->notify_one();
+
+				return item;
 			}
 
 			/**
@@ -76,19 +133,29 @@ namespace repo{
 			*/
 			std::vector<T*> empty()
 			{
-				boost::mutex::scoped_lock popLock(popMutex); //stopping anyone from popping
-				boost::mutex::scoped_lock pushLock(pushMutex); //stopping anyone from pushing
-				std::vector<T*> clone = stack;
-				stack.clear();
+				boost::mutex::scoped_lock lock(mutex);
+				std::vector<T*> clone;
+				clone.swap(stack);
 				return clone;
 			}
 
+			/**
+			* @return returns a snapshot of the usage statistics
+			*/
+			RepoStackStats getStats() const
+			{
+				boost::mutex::scoped_lock lock(mutex);
+				return stats;
+			}
+
 		private:
 			std::vector<T*> stack;
+			std::deque<boost::condition_variable*> waiters;
 			const int32_t maxRetry;
 			const uint32_t msTimeOut;
-			mutable boost::mutex pushMutex;
-			mutable boost::mutex popMutex;
+			size_t inUse;
+			RepoStackStats stats;
+			mutable boost::mutex mutex;
 		};
 	}
 }
@@ -51,8 +51,9 @@ const static std::string MP_LABEL_PROJECT = "model";
 
 AssetModelExport::AssetModelExport(
 	const repo::core::model::RepoScene *scene,
-	const bool vrEnabled
-	) : WebModelExport(scene),
+	const bool vrEnabled,
+	repo::core::model::MeshSplitCache *splitCache
+	) : WebModelExport(scene, splitCache),
 	generateVR(vrEnabled)
 {
 	//Considering all newly imported models should have a stash graph, we only need to support stash graph?
@@ -85,12 +86,12 @@ repo_web_buffers_t AssetModelExport::getAllFilesExportedAsBuffer() const
 bool AssetModelExport::generateJSONMapping(
 	const repo::core::model::MeshNode  *mesh,
 	const repo::core::model::RepoScene *scene,
-	const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping)
+	const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping,
+	repo::lib::PropertyTree &jsonTree) const
 {
 	bool success;
 	if (success = mesh)
 	{
-		repo::lib::PropertyTree jsonTree;
 		std::vector<repo_mesh_mapping_t> mappings = mesh->getMeshMapping();
 		std::sort(mappings.begin(), mappings.end(),
 			[](repo_mesh_mapping_t const& a, repo_mesh_mapping_t const& b) { return a.vertFrom < b.vertFrom; });
@@ -132,10 +133,6 @@ bool AssetModelExport::generateJSONMapping(
 		}
 
 		jsonTree.addArrayObjects(MP_LABEL_MAPPING, mappingTrees);
-
-		std::string jsonFileName = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + mesh->getUniqueID().toString() + "_unity.json.mpc";
-
-		jsonTrees[jsonFileName] = jsonTree;
 	}
 	else
 	{
@@ -151,42 +148,49 @@ bool AssetModelExport::generateTreeRepresentation(
 	bool success;
 	if (success = scene->hasRoot(gType))
 	{
-		auto meshes = scene->getAllMeshes(gType);
+		auto meshes = getOrderedMeshes();
 
-		std::vector<std::string> assetFiles, vrAssetFiles, jsons;
-		for (const repo::core::model::RepoNode* node : meshes)
+		//Each job fills in the slots of its own mesh, they are combined in mesh order afterwards
+		std::vector<std::shared_ptr<repo::core::model::MeshNode>> splitMeshes(meshes.size());
+		std::vector<std::vector<uint16_t>> faceBufs(meshes.size());
+		std::vector<std::vector<std::vector<float>>> idMapBufs(meshes.size());
+		std::vector<std::vector<std::vector<repo_mesh_mapping_t>>> subMeshMappings(meshes.size());
+		std::vector<repo::lib::PropertyTree> mappingTrees(meshes.size());
+
+		success = processMeshesInParallel(meshes,
+			[&](const size_t &index, const repo::core::model::MeshNode *mesh)
 		{
-			auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
-			if (!mesh)
-			{
-				repoError << "Failed to cast a Repo Node of type mesh into a MeshNode(" << node->getUniqueID() << "). Skipping...";
-			}
-			std::string textureID = scene->getTextureIDForMesh(gType, mesh->getSharedID());
+			auto split = getMeshSplit(mesh, SRC_MAX_VERTEX_LIMIT);
+			if (!split)
+				return false;
 
-			repo::manipulator::modelutility::MeshMapReorganiser *reSplitter =
-				new repo::manipulator::modelutility::MeshMapReorganiser(mesh, SRC_MAX_VERTEX_LIMIT);
+			faceBufs[index] = split->serialisedFaces;
+			idMapBufs[index] = split->idMapBuf;
+			subMeshMappings[index] = split->matMap;
+			bool jobSuccess = generateJSONMapping(mesh, scene, split->splitMapping, mappingTrees[index]);
+			splitMeshes[index] = split->remappedMesh;
+			return jobSuccess;
+		});
 
-			if (success = !std::make_shared<repo::core::model::MeshNode>(reSplitter->getRemappedMesh())->isEmpty())
-			{
-				reorganisedMeshes.push_back(std::make_shared<repo::core::model::MeshNode>(reSplitter->getRemappedMesh()));
-				serialisedFaceBuf.push_back(reSplitter->getSerialisedFaces());
-				idMapBuf.push_back(reSplitter->getIDMapArrays());
-				meshMappings.push_back(reSplitter->getMappingsPerSubMesh());
-				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping = reSplitter->getSplitMapping();
-				std::string fNamePrefix = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + mesh->getUniqueID().toString();
-				if (generateVR)
-					vrAssetFiles.push_back(fNamePrefix + "_win64.unity3d");
-				assetFiles.push_back(fNamePrefix + ".unity3d");
-				jsons.push_back(fNamePrefix + "_unity.json.mpc");
-
-				success &= generateJSONMapping(mesh, scene, reSplitter->getSplitMapping());
-				delete reSplitter;
-			}
-			else
-			{
-				repoError << "Failed to generate a remapped mesh for mesh with ID : " << mesh->getUniqueID();
-				break;
-			}
+		if (success)
+			reportVertexCacheEfficiency();
+
+		std::vector<std::string> assetFiles, vrAssetFiles, jsons;
+		for (size_t i = 0; i < meshes.size(); ++i)
+		{
+			if (!splitMeshes[i]) continue;
+
+			reorganisedMeshes.push_back(splitMeshes[i]);
+			serialisedFaceBuf.push_back(std::move(faceBufs[i]));
+			idMapBuf.push_back(std::move(idMapBufs[i]));
+			meshMappings.push_back(std::move(subMeshMappings[i]));
+
+			std::string fNamePrefix = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + meshes[i]->getUniqueID().toString();
+			if (generateVR)
+				vrAssetFiles.push_back(fNamePrefix + "_win64.unity3d");
+			assetFiles.push_back(fNamePrefix + ".unity3d");
+			jsons.push_back(fNamePrefix + "_unity.json.mpc");
+			jsonTrees[jsons.back()] = std::move(mappingTrees[i]);
 		}
 
 		std::string assetListFile = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/revision/" + scene->getRevisionID().toString() + "/unityAssets.json";
@@ -39,9 +39,11 @@ namespace repo{
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
 				* @param whether the scene requires VR bundles
+				* @param splitCache cache of mesh splits shared with other exporters (optional)
 				*/
 				AssetModelExport(const repo::core::model::RepoScene *scene,
-					const bool vrEnabled = false);
+					const bool vrEnabled = false,
+					repo::core::model::MeshSplitCache *splitCache = nullptr);
 
 				/**
 				* Default Destructor
@@ -75,19 +77,21 @@ namespace repo{
 
 				/**
 				* Generate JSON mapping for multipart meshes
-				* And add it into the object
 				* @param mesh mesh to generate with
 				* @param scene scene for reference
 				* @param splitMapping how the mapping is split after subMesh split
+				* @param jsonTree JSON mapping (output)
 				*/
 				bool generateJSONMapping(
 					const repo::core::model::MeshNode *mesh,
 					const repo::core::model::RepoScene *scene,
-					const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping);
+					const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping,
+					repo::lib::PropertyTree &jsonTree) const;
 
 				/**
 				* Create a tree representation for the graph
 				* This creates the header of the SRC
+				* Meshes are split and mapped in parallel
 				* @return returns true upon success
 				*/
 				bool generateTreeRepresentation();
@@ -419,7 +419,7 @@ aiMesh* AssimpModelExport::convertMesh(
 
 	assimpMesh->mName = aiString(meshNode->getName());
 
-	std::vector<repo_face_t> faces = meshNode->getFaces();
+	auto faces = meshNode->getFacesView();
 	//--------------------------------------------------------------------------
 	// Faces
 	if (faces.size())
@@ -428,9 +428,11 @@ aiMesh* AssimpModelExport::convertMesh(
 		if (assimpMesh->mFaces)
 		{
 			uint32_t i = 0;
-			for (const auto &face : faces)
+			for (const auto face : faces)
 			{
-				assimpMesh->mFaces[i].mIndices = (unsigned int*)face.data();
+				//aiFace owns (and deletes) its indices, so they have to be copied
+				assimpMesh->mFaces[i].mIndices = new unsigned int[face.size()];
+				std::copy(face.begin(), face.end(), assimpMesh->mFaces[i].mIndices);
 				assimpMesh->mFaces[i].mNumIndices = face.size();
 				i++;
 			}
@@ -25,7 +25,6 @@
 
 #include "../../../core/model/bson/repo_bson_factory.h"
 #include "../../../lib/repo_log.h"
-#include "../../modelutility/repo_mesh_map_reorganiser.h"
 #include "../../modelutility/spatialpartitioning/repo_spatial_partitioner_rdtree.h"
 #include "auxiliary/x3dom_constants.h"
 
@@ -189,8 +188,9 @@ static const std::string REPO_GLTF_LABEL_LOD = "lodRef";
 static const std::string REPO_LABEL_X3D_MATERIAL = "x3dmaterial";
 
 GLTFModelExport::GLTFModelExport(
-	const repo::core::model::RepoScene *scene
-	) : WebModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	repo::core::model::MeshSplitCache  *splitCache
+	) : WebModelExport(scene, splitCache)
 {
 	if (convertSuccess)
 	{
@@ -624,7 +624,7 @@ std::unordered_map<std::string, std::vector<uint8_t>> GLTFModelExport::getGLTFFi
 */
 bool GLTFModelExport::reIndexFaces(
 	const std::vector<std::vector<repo_mesh_mapping_t>> &matMap,
-	std::vector<uint16_t>                               &faces)
+	std::vector<uint16_t>                               &faces) const
 {
 	size_t verticesOffset = 0;
 	size_t verticesLastIndex = 0;
@@ -828,66 +828,100 @@ void GLTFModelExport::populateWithMaterials(
 std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLTFModelExport::populateWithMeshes(
 	repo::lib::PropertyTree           &tree)
 {
-	repo::core::model::RepoNodeSet meshes = scene->getAllMeshes(gType);
 	std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> splitSizes;
-	for (const auto &mesh : meshes)
+	auto meshes = getOrderedMeshes();
+
+	//Geometry of a multipart mesh after it has been split, reindexed and reordered
+	struct SplitMeshData
+	{
+		bool hasFaces = false;
+		std::vector<repo::lib::RepoVector3D> vertices;
+		std::vector<repo::lib::RepoVector3D> normals;
+		std::vector<uint16_t> faces;
+		std::vector<std::vector<float>> idMapBuf;
+		std::vector<std::vector<repo_mesh_mapping_t>> matMap;
+		std::vector<repo_mesh_mapping_t> mappings;
+		std::vector<std::vector<std::vector<uint16_t>>> lods;
+	};
+
+	auto needsSplit = [](const repo::core::model::MeshNode *node)
+	{
+		return node->getMeshMapping().size() > 1 || node->getVerticesView().size() > GLTF_MAX_VERTEX_LIMIT;
+	};
+
+	//Splitting and reordering is the bulk of the work and every mesh is independent, so it is done in parallel.
+	//Writing into the tree and the data buffers stays in mesh order as meshes share the revision buffer.
+	std::vector<SplitMeshData> splitData(meshes.size());
+	bool prepared = processMeshesInParallel(meshes,
+		[&](const size_t &index, const repo::core::model::MeshNode *node)
+	{
+		if (!needsSplit(node)) return true;
+
+		SplitMeshData &data = splitData[index];
+		//This is a multipart mesh node, the mesh may be too big for
+		//webGL, split the mesh into sub meshes
+		auto split = getMeshSplit(node, GLTF_MAX_VERTEX_LIMIT);
+		if (!split)
+			return false;
+
+		//The split is shared with other exporters, take copies of what is modified here
+		data.faces = split->serialisedFaces;
+		data.idMapBuf = split->idMapBuf;
+		data.matMap = split->matMap;
+		data.mappings = split->remappedMesh->getMeshMapping();
+		data.normals = split->remappedMesh->getNormals();
+		data.vertices = split->remappedMesh->getVertices();
+
+		if (!data.vertices.size())
+		{
+			repoError << "Mesh " << node->getUniqueID() << " has no vertices after remapping!";
+			return false;
+		}
+
+		if (!(data.hasFaces = data.faces.size()))
+		{
+			//If there is no faces, just ignore this.
+			repoWarning << "Mesh has no faces after remapping. Skipping...";
+			return true;
+		}
+		repoTrace << "Reindexing Faces...";
+		//reindex the face buffer also check validity of the indices
+		if (!reIndexFaces(data.matMap, data.faces))
+		{
+			return false;
+		}
+		repoTrace << "Reordering Faces...";
+		data.lods = reorderFaces(data.faces, data.vertices, data.matMap);
+		return true;
+	});
+
+	if (!prepared)
+		return splitSizes;
+
+	for (size_t meshIdx = 0; meshIdx < meshes.size(); ++meshIdx)
 	{
-		const repo::core::model::MeshNode *node = (const repo::core::model::MeshNode *)mesh;
+		const repo::core::model::MeshNode *node = meshes[meshIdx];
 		const std::vector<repo_mesh_mapping_t> mappings = node->getMeshMapping();
 
 		std::string meshUUID = node->getUniqueID().toString();
 
 		std::vector<repo::lib::RepoVector3D> normals;
-		std::vector<repo::lib::RepoVector3D> vertices = node->getVertices();
+		std::vector<repo::lib::RepoVector3D> vertices;
 		std::vector<std::vector<repo::lib::RepoVector2D>> UVs;
 
-		if (mappings.size() > 1 || vertices.size() > GLTF_MAX_VERTEX_LIMIT)
+		if (needsSplit(node))
 		{
-			//This is a multipart mesh node, the mesh may be too big for
-			//webGL, split the mesh into sub meshes
-			std::string bufferFileName = mesh->getUniqueID().toString();
-			repo::manipulator::modelutility::MeshMapReorganiser *reSplitter =
-				new repo::manipulator::modelutility::MeshMapReorganiser(node, GLTF_MAX_VERTEX_LIMIT);
-
-			repo::core::model::MeshNode splitMesh = reSplitter->getRemappedMesh();
-			if (splitMesh.isEmpty())
-			{
-				repoError << "Failed to generate remappings for mesh: " << mesh->getUniqueID();
-				splitSizes.clear();
-				delete reSplitter;
-				return splitSizes;
-			}
-			std::vector<uint16_t> newFaces = reSplitter->getSerialisedFaces();
-			std::vector<std::vector<float>> idMapBuf = reSplitter->getIDMapArrays();
-			std::vector<std::vector<repo_mesh_mapping_t>> matMap = reSplitter->getMappingsPerSubMesh();
-
-			delete reSplitter;
-
-			auto normals = splitMesh.getNormals();
-			auto vertices = splitMesh.getVertices();
-
-			if (!vertices.size())
-			{
-				repoError << "Mesh " << mesh->getUniqueID() << " has no vertices after remapping!";
-				splitSizes.clear();
-				return splitSizes;
-			}
-
-			if (!newFaces.size())
-			{
-				//If there is no faces, just ignore this.
-				repoWarning << "Mesh has no faces after remapping. Skipping...";
+			SplitMeshData &data = splitData[meshIdx];
+			if (!data.hasFaces)
 				continue;
-			}
-			repoTrace << "Reindexing Faces...";
-			//reindex the face buffer also check validity of the indices
-			if (!reIndexFaces(matMap, newFaces))
-			{
-				splitSizes.clear();
-				return splitSizes;
-			}
-			repoTrace << "Reordering Faces...";
-			auto lods = reorderFaces(newFaces, vertices, matMap);
+
+			std::string bufferFileName = meshUUID;
+			std::vector<uint16_t> newFaces = std::move(data.faces);
+			std::vector<std::vector<float>> idMapBuf = std::move(data.idMapBuf);
+			std::vector<std::vector<repo_mesh_mapping_t>> matMap = std::move(data.matMap);
+			auto normals = std::move(data.normals);
+			auto vertices = std::move(data.vertices);
+			auto lods = std::move(data.lods);
 #if defined(DEBUG) && defined(LODLIMIT)
 			for (size_t i = 0; i < matMap.size(); ++i)
 				for (size_t j = 0; j < matMap[i].size(); ++j)
@@ -920,7 +954,7 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				}
 #endif
 
-			auto newMappings = splitMesh.getMeshMapping();
+			auto newMappings = std::move(data.mappings);
 
 			splitSizes[node->getUniqueID()] = newMappings.size();
 
@@ -1078,7 +1112,7 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 			if (!name.empty())
 				tree.addToTree(label + "." + GLTF_LABEL_NAME, node->getName());
 
-			auto faces = node->getFaces();
+			auto faces = node->getFacesView();
 			std::vector<uint16_t> sFaces = serialiseFaces(faces);
 
 			bool hasMat = false;
@@ -1188,14 +1222,12 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 				}
 
 				//attributes
-				auto normals = node->getNormals();
 				if (normals.size())
 				{
 					std::string bufferName = meshId + "_" + GLTF_SUFFIX_NORMALS;
 					primitives[0].addToTree(GLTF_LABEL_ATTRIBUTES + "." + GLTF_LABEL_NORMAL, GLTF_PREFIX_ACCESSORS + "_" + bufferName);
 					addAccessors(bufferName, normBufferName, tree, normals, 0, normals.size(), meshId);
 				}
-				auto vertices = node->getVertices();
 				if (vertices.size())
 				{
 					std::string bufferName = meshId + "_" + GLTF_SUFFIX_POSITION;
@@ -1203,7 +1235,6 @@ std::unordered_map<repo::lib::RepoUUID, uint32_t, repo::lib::RepoUUIDHasher> GLT
 					addAccessors(bufferName, posBufferName, tree, vertices, 0, vertices.size(), meshId);
 				}
 
-				auto UVs = node->getUVChannelsSeparated();
 				if (UVs.size())
 				{
 					for (uint32_t i = 0; i < UVs.size(); ++i)
@@ -1276,7 +1307,7 @@ void GLTFModelExport::populateWithNodes(
 std::vector<std::vector<std::vector<uint16_t>>> GLTFModelExport::reorderFaces(
 	std::vector<uint16_t>                         &faces,
 	const std::vector<repo::lib::RepoVector3D>                    &vertices,
-	const std::vector<std::vector<repo_mesh_mapping_t>> &mapping)
+	const std::vector<std::vector<repo_mesh_mapping_t>> &mapping) const
 {
 	std::vector<std::vector<std::vector<uint16_t>>> lods;
 	for (size_t i = 0; i < mapping.size(); ++i)
@@ -1397,17 +1428,18 @@ std::vector<uint16_t> GLTFModelExport::reorderFaces(
 }
 
 std::vector<uint16_t> GLTFModelExport::serialiseFaces(
-	const std::vector<repo_face_t> &faces) const
+	const repo::lib::RepoFaceStreamView &faces) const
 {
 	std::vector<uint16_t> sFaces;
+	sFaces.reserve(faces.size() * 3);
 
-	for (uint32_t i = 0; i < faces.size(); ++i)
+	for (const auto face : faces)
 	{
-		if (faces[i].size() == 3)
+		if (face.size() == 3)
 		{
-			sFaces.push_back(faces[i][0]);
-			sFaces.push_back(faces[i][1]);
-			sFaces.push_back(faces[i][2]);
+			sFaces.push_back(face[0]);
+			sFaces.push_back(face[1]);
+			sFaces.push_back(face[2]);
 		}
 		else
 		{
@@ -36,8 +36,11 @@ namespace repo{
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param splitCache cache of mesh splits shared with other exporters (optional)
 				*/
-				GLTFModelExport(const repo::core::model::RepoScene *scene);
+				GLTFModelExport(
+					const repo::core::model::RepoScene *scene,
+					repo::core::model::MeshSplitCache  *splitCache = nullptr);
 
 				/**
 				* Default Destructor
@@ -245,7 +248,7 @@ namespace repo{
 				*/
 				bool reIndexFaces(
 					const std::vector<std::vector<repo_mesh_mapping_t>> &matMap,
-					std::vector<uint16_t>                               &faces);
+					std::vector<uint16_t>                               &faces) const;
 
 				/**
 				* Process children of nodes(Transformation)
@@ -298,7 +301,7 @@ namespace repo{
 				std::vector<std::vector<std::vector<uint16_t>>> reorderFaces(
 					std::vector<uint16_t>                               &faces,
 					const std::vector<repo::lib::RepoVector3D>                    &vertices,
-					const std::vector<std::vector<repo_mesh_mapping_t>> &mapping);
+					const std::vector<std::vector<repo_mesh_mapping_t>> &mapping) const;
 
 				/**
 				* Reorder a certain chunk of faces base on quantization
@@ -313,8 +316,13 @@ namespace repo{
 					const repo_mesh_mapping_t        &mapping,
 					std::vector<uint16_t>      &lods) const;
 
+				/**
+				* Serialise the given faces into a triangle index buffer
+				* @param faces view of the faces to serialise
+				* @return returns the serialised faces
+				*/
 				std::vector<uint16_t> serialiseFaces(
-					const std::vector<repo_face_t> &faces) const;
+					const repo::lib::RepoFaceStreamView &faces) const;
 
 				/**
 				* write buffered binary files into the tree
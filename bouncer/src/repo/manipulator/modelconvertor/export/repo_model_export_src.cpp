@@ -22,7 +22,6 @@
 #include "repo_model_export_src.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
 #include "../../../lib/repo_log.h"
-#include "../../modelutility/repo_mesh_map_reorganiser.h"
 
 using namespace repo::manipulator::modelconvertor;
 
@@ -100,8 +99,9 @@ const static std::string MP_LABEL_NUM_IDs = "numberOfIDs";
 const static std::string MP_LABEL_USAGE = "usage";
 
 SRCModelExport::SRCModelExport(
-	const repo::core::model::RepoScene *scene
-	) : WebModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	repo::core::model::MeshSplitCache  *splitCache
+	) : WebModelExport(scene, splitCache)
 {
 	//Considering all newly imported models should have a stash graph, we only need to support stash graph?
 	if (convertSuccess)
@@ -185,12 +185,13 @@ repo_web_buffers_t SRCModelExport::getAllFilesExportedAsBuffer() const
 bool SRCModelExport::generateJSONMapping(
 	const repo::core::model::MeshNode  *mesh,
 	const repo::core::model::RepoScene *scene,
-	const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping)
+	const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping,
+	std::string &jsonFileName,
+	repo::lib::PropertyTree &jsonTree) const
 {
 	bool success;
 	if (success = mesh)
 	{
-		repo::lib::PropertyTree jsonTree;
 		std::vector<repo_mesh_mapping_t> mappings = mesh->getMeshMapping();
 		std::sort(mappings.begin(), mappings.end(),
 			[](repo_mesh_mapping_t const& a, repo_mesh_mapping_t const& b) { return a.vertFrom < b.vertFrom; });
@@ -261,9 +262,7 @@ bool SRCModelExport::generateJSONMapping(
 
 		jsonTree.addArrayObjects(MP_LABEL_MAPPING, mappingTrees);
 
-		std::string jsonFileName = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + mesh->getUniqueID().toString() + ".json.mpc";
-
-		jsonTrees[jsonFileName] = jsonTree;
+		jsonFileName = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + mesh->getUniqueID().toString() + ".json.mpc";
 	}
 	else
 	{
@@ -279,59 +278,56 @@ bool SRCModelExport::generateTreeRepresentation(
 	bool success;
 	if (success = scene->hasRoot(gType))
 	{
-		auto meshes = scene->getAllMeshes(gType);
-		size_t index = 0;
-		//Every mesh is a new SRC file
-		fullDataBuffer.reserve(meshes.size());
-		for (const repo::core::model::RepoNode* node : meshes)
+		auto meshes = getOrderedMeshes();
+		//Every mesh is a new SRC file, each job fills in the slots of its own mesh
+		std::vector<std::string> fileNames(meshes.size());
+		std::vector<repo::lib::PropertyTree> srcTrees(meshes.size());
+		std::vector<std::vector<uint8_t>> dataBuffers(meshes.size());
+		std::vector<std::string> jsonFileNames(meshes.size());
+		std::vector<repo::lib::PropertyTree> mappingTrees(meshes.size());
+
+		success = processMeshesInParallel(meshes,
+			[&](const size_t &index, const repo::core::model::MeshNode *mesh)
 		{
-			auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
-			if (!mesh)
-			{
-				repoError << "Failed to cast a Repo Node of type mesh into a MeshNode(" << node->getUniqueID() << "). Skipping...";
-			}
 			std::string textureID = scene->getTextureIDForMesh(gType, mesh->getSharedID());
 
-			repo::manipulator::modelutility::MeshMapReorganiser *reSplitter =
-				new repo::manipulator::modelutility::MeshMapReorganiser(mesh, SRC_MAX_VERTEX_LIMIT);
-			repo::core::model::MeshNode splittedMesh = reSplitter->getRemappedMesh();
-			if (success = !(splittedMesh.isEmpty()))
+			auto split = getMeshSplit(mesh, SRC_MAX_VERTEX_LIMIT);
+			if (!split)
+				return false;
+			const repo::core::model::MeshNode &splittedMesh = *split->remappedMesh;
+
+			std::string ext = ".src";
+			bool sepX3d; //requires a separate x3d file if it is a multipart mesh
+			if (sepX3d = mesh->getMeshMapping().size() > 1)
 			{
-				std::vector<uint16_t> facebuf = reSplitter->getSerialisedFaces();
-				std::vector<std::vector<float>> idMapBuf = reSplitter->getIDMapArrays();
-				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMapping = reSplitter->getSplitMapping();
-				delete reSplitter;
-
-				std::string ext = ".src";
-				bool sepX3d; //requires a separate x3d file if it is a multipart mesh
-				if (sepX3d = mesh->getMeshMapping().size() > 1)
-				{
-					ext += ".mpc";
-				}
+				ext += ".mpc";
+			}
 
-				if (!textureID.empty())
-				{
-					ext += "?tex_uuid=" + textureID;
-				}
+			if (!textureID.empty())
+			{
+				ext += "?tex_uuid=" + textureID;
+			}
 
-				if (success = addMeshToExport(splittedMesh, index, facebuf, idMapBuf, ext))
-				{
-					++index;
-					if (sepX3d)
-					{
-						success &= generateJSONMapping(mesh, scene, splitMapping);
-					}
-				}
-				else
-				{
-					repoError << "Failed to export mesh " << splittedMesh.getUniqueID() << " into SRC format.";
-					break;
-				}
+			if (!addMeshToExport(splittedMesh, index, split->serialisedFaces, split->idMapBuf, ext,
+				fileNames[index], srcTrees[index], dataBuffers[index]))
+			{
+				repoError << "Failed to export mesh " << splittedMesh.getUniqueID() << " into SRC format.";
+				return false;
 			}
-			else
+
+			return !sepX3d || generateJSONMapping(mesh, scene, split->splitMapping, jsonFileNames[index], mappingTrees[index]);
+		});
+
+		if (success)
+		{
+			reportVertexCacheEfficiency();
+			fullDataBuffer.reserve(meshes.size());
+			for (size_t i = 0; i < meshes.size(); ++i)
 			{
-				repoError << "Failed to generate a remapped mesh for mesh with ID : " << mesh->getUniqueID();
-				break;
+				trees[fileNames[i]] = std::move(srcTrees[i]);
+				fullDataBuffer[fileNames[i]] = std::move(dataBuffers[i]);
+				if (!jsonFileNames[i].empty())
+					jsonTrees[jsonFileNames[i]] = std::move(mappingTrees[i]);
 			}
 		}
 	}
@@ -344,14 +340,18 @@ bool SRCModelExport::addMeshToExport(
 	const size_t                           &idx,
 	const std::vector<uint16_t>            &faceBuf,
 	const std::vector<std::vector<float>>  &idMapBuf,
-	const std::string                      &fileExt
-	)
+	const std::string                      &fileExt,
+	std::string                            &fname,
+	repo::lib::PropertyTree                &tree,
+	std::vector<uint8_t>                   &dataBuffer
+	) const
 {
 	std::vector<repo_mesh_mapping_t> mapping = mesh.getMeshMapping();
 
-	auto vertices = mesh.getVertices();
-	auto normals = mesh.getNormals();
-	auto uvs = mesh.getUVChannels();
+	//Read only views into the mesh, the data is only copied into the output buffer
+	auto vertices = mesh.getVerticesView();
+	auto normals = mesh.getNormalsView();
+	auto uvs = mesh.getUVChannelsView();
 
 	if (!vertices.size())
 	{
@@ -379,7 +379,6 @@ bool SRCModelExport::addMeshToExport(
 
 	std::string meshId = mesh.getUniqueID().toString();
 
-	repo::lib::PropertyTree tree;
 	size_t lastV = 0, lastF = 0;
 	repoTrace << "Looping Through submeshes (#submeshes : " << nSubMeshes << ")";
 	for (size_t subMeshIdx = 0; subMeshIdx < nSubMeshes; ++subMeshIdx)
@@ -607,7 +606,6 @@ bool SRCModelExport::addMeshToExport(
 		+ idMapBufFull.size() * sizeof(*idMapBufFull.data())
 		+ uvs.size() *sizeof(*uvs.data());
 
-	std::vector<uint8_t> dataBuffer;
 	dataBuffer.resize(bufferSize);
 
 	size_t bufferPtr = 0;
@@ -655,10 +653,7 @@ bool SRCModelExport::addMeshToExport(
 		repoTrace << "Written UVs: byte Size " << byteSize << " bufferPtr is " << bufferPtr;
 	}
 
-	std::string fname = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + meshId + fileExt;
-
-	trees[fname] = tree;
-	fullDataBuffer[fname] = dataBuffer;
+	fname = "/" + scene->getDatabaseName() + "/" + scene->getProjectName() + "/" + meshId + fileExt;
 
 	return true;
 }
\ No newline at end of file
@@ -37,8 +37,11 @@ namespace repo{
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param splitCache cache of mesh splits shared with other exporters (optional)
 				*/
-				SRCModelExport(const repo::core::model::RepoScene *scene);
+				SRCModelExport(
+					const repo::core::model::RepoScene *scene,
+					repo::core::model::MeshSplitCache  *splitCache = nullptr);
 
 				/**
 				* Default Destructor
@@ -62,30 +65,40 @@ namespace repo{
 				* @param faceBuf face buffer with only the face indices
 				* @param idMapBuf idMapping for each sub meshes
 				* @param fileExt file extension required for this SRC file (*.src/.src.mpc/.src?<query>)
+				* @param fname file name of the SRC file (output)
+				* @param tree header of the SRC file (output)
+				* @param dataBuffer data buffer of the SRC file (output)
 				*/
 				bool addMeshToExport(
 					const repo::core::model::MeshNode &mesh,
 					const size_t &idx,
 					const std::vector<uint16_t> &faceBuf,
 					const std::vector<std::vector<float>>  &idMapBuf,
-					const std::string                      &fileExt
-					);
+					const std::string                      &fileExt,
+					std::string                            &fname,
+					repo::lib::PropertyTree                &tree,
+					std::vector<uint8_t>                   &dataBuffer
+					) const;
 
 				/**
 				* Generate JSON mapping for multipart meshes
-				* And add it into the object
 				* @param mesh mesh to generate with
 				* @param scene scene for reference
 				* @param splitMapping how the mapping is split after subMesh split
+				* @param jsonFileName file name of the JSON mapping (output)
+				* @param jsonTree JSON mapping (output)
 				*/
 				bool generateJSONMapping(
 					const repo::core::model::MeshNode *mesh,
 					const repo::core::model::RepoScene *scene,
-					const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping);
+					const std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> &splitMapping,
+					std::string &jsonFileName,
+					repo::lib::PropertyTree &jsonTree) const;
 
 				/**
 				* Create a tree representation for the graph
 				* This creates the header of the SRC
+				* Every mesh becomes its own SRC file, so meshes are exported in parallel
 				* @return returns true upon success
 				*/
 				bool generateTreeRepresentation();
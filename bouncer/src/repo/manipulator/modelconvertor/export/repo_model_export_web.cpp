@@ -22,14 +22,24 @@
 #include "repo_model_export_web.h"
 #include "../../../lib/repo_log.h"
 #include "../../../core/model/bson/repo_bson_factory.h"
+#include "../../modelutility/repo_mesh_map_reorganiser.h"
+#include "../../modelutility/repo_vertex_cache_optimiser.h"
 
+#include <algorithm>
+#include <atomic>
 #include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
 
 using namespace repo::manipulator::modelconvertor;
 
 WebModelExport::WebModelExport(
-	const repo::core::model::RepoScene *scene
-	) : AbstractModelExport(scene)
+	const repo::core::model::RepoScene *scene,
+	repo::core::model::MeshSplitCache  *splitCache
+	) : AbstractModelExport(scene),
+	splitCache(splitCache),
+	nSplitFaces(0),
+	orgCacheMisses(0),
+	cacheMisses(0)
 {
 	//We don't cache reference scenes
 	if (convertSuccess = scene && !scene->getAllReferences(repo::core::model::RepoScene::GraphType::DEFAULT).size())
@@ -114,6 +124,99 @@ std::unordered_map<std::string, std::vector<uint8_t>> WebModelExport::getJSONFil
 	return fileBuffers;
 }
 
+std::vector<const repo::core::model::MeshNode*> WebModelExport::getOrderedMeshes() const
+{
+	std::vector<const repo::core::model::MeshNode*> meshes;
+	for (const auto &node : scene->getAllMeshes(gType))
+	{
+		auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
+		if (mesh)
+			meshes.push_back(mesh);
+		else
+			repoError << "Failed to cast a Repo Node of type mesh into a MeshNode(" << node->getUniqueID() << "). Skipping...";
+	}
+
+	std::sort(meshes.begin(), meshes.end(),
+		[](const repo::core::model::MeshNode *a, const repo::core::model::MeshNode *b)
+	{ return a->getUniqueID() < b->getUniqueID(); });
+
+	return meshes;
+}
+
+std::shared_ptr<const repo::core::model::MeshSplit> WebModelExport::getMeshSplit(
+	const repo::core::model::MeshNode *mesh,
+	const size_t                      &vertThreshold)
+{
+	std::shared_ptr<const repo::core::model::MeshSplit> split;
+	if (splitCache)
+		split = splitCache->find(mesh->getUniqueID(), vertThreshold);
+
+	if (!split)
+	{
+		repo::manipulator::modelutility::MeshMapReorganiser reSplitter(mesh, vertThreshold);
+		std::shared_ptr<const repo::core::model::MeshSplit> newSplit = reSplitter.releaseMeshSplit();
+		if (!newSplit || newSplit->remappedMesh->isEmpty())
+		{
+			repoError << "Failed to generate a remapped mesh for mesh with ID : " << mesh->getUniqueID();
+			return nullptr;
+		}
+
+		split = splitCache ? splitCache->insert(mesh->getUniqueID(), vertThreshold, newSplit) : newSplit;
+	}
+
+	nSplitFaces += split->serialisedFaces.size() / 3;
+	orgCacheMisses += split->orgCacheMisses;
+	cacheMisses += split->cacheMisses;
+	return split;
+}
+
+void WebModelExport::reportVertexCacheEfficiency() const
+{
+	const uint64_t nFaces = nSplitFaces;
+	if (nFaces && cacheMisses)
+	{
+		repoInfo << "Vertex cache ACMR (" << REPO_VERTEX_CACHE_SIZE << " entries) over " << nFaces << " faces: "
+			<< (float)orgCacheMisses / nFaces << " -> " << (float)cacheMisses / nFaces;
+	}
+}
+
+bool WebModelExport::processMeshesInParallel(
+	const std::vector<const repo::core::model::MeshNode*> &meshes,
+	const std::function<bool(const size_t &, const repo::core::model::MeshNode *)> &job) const
+{
+	std::atomic<size_t> nextMesh(0);
+	std::atomic<bool> success(true);
+	auto processMeshes = [&]()
+	{
+		size_t i;
+		//Stop picking up new meshes once one has failed, the export is void anyway
+		while (success && (i = nextMesh++) < meshes.size())
+		{
+			bool jobSuccess = false;
+			try{
+				jobSuccess = job(i, meshes[i]);
+			}
+			catch (std::exception &e)
+			{
+				repoError << "Failed to export mesh " << meshes[i]->getUniqueID() << ": " << e.what();
+			}
+
+			if (!jobSuccess)
+				success = false;
+		}
+	};
+
+	const size_t nThreads = std::min<size_t>(meshes.size(), std::max(1u, boost::thread::hardware_concurrency()));
+	repoTrace << "Exporting " << meshes.size() << " meshes with " << nThreads << " threads";
+	boost::thread_group workers;
+	for (size_t i = 1; i < nThreads; ++i)
+		workers.create_thread(processMeshes);
+	processMeshes();
+	workers.join_all();
+
+	return success;
+}
+
 std::string WebModelExport::getSupportedFormats()
 {
 	return ".src, .gltf";
@@ -21,12 +21,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "repo_model_export_abstract.h"
 #include "../../../lib/repo_property_tree.h"
 #include "../../../lib/datastructure/repo_structs.h"
 #include "../../../core/model/collection/repo_scene.h"
+#include "../../../core/model/collection/repo_mesh_split_cache.h"
 
 namespace repo{
 	namespace manipulator{
@@ -39,8 +44,12 @@ namespace repo{
 				/**
 				* Default Constructor, export model with default settings
 				* @param scene repo scene to convert
+				* @param splitCache cache of mesh splits shared with other exporters
+				*        of the scene, meshes are split without caching if not given
 				*/
-				WebModelExport(const repo::core::model::RepoScene *scene);
+				WebModelExport(
+					const repo::core::model::RepoScene *scene,
+					repo::core::model::MeshSplitCache  *splitCache = nullptr);
 
 				/**
 				* Default Destructor
@@ -84,6 +93,44 @@ namespace repo{
 				}
 
 			protected:
+				/**
+				* Get the meshes of the graph being exported, ordered by unique ID
+				* so the output does not depend on the order of the node set
+				* @return returns the meshes in order
+				*/
+				std::vector<const repo::core::model::MeshNode*> getOrderedMeshes() const;
+
+				/**
+				* Get the split of a mesh into sub meshes of at most vertThreshold vertices
+				* Splits are kept in the split cache given to the exporter, if any, so a
+				* mesh is only split once no matter how many exporters share the cache
+				* @param mesh mesh to split
+				* @param vertThreshold maximum number of vertices within a sub mesh
+				* @return returns the split, nullptr if the mesh failed to split
+				*/
+				std::shared_ptr<const repo::core::model::MeshSplit> getMeshSplit(
+					const repo::core::model::MeshNode *mesh,
+					const size_t                      &vertThreshold);
+
+				/**
+				* Log the average cache miss ratio (ACMR) of the faces of the meshes
+				* split so far, before and after they were ordered for the vertex cache
+				*/
+				void reportVertexCacheEfficiency() const;
+
+				/**
+				* Run a job on every mesh using a pool of threads
+				* A job must only write into the results of its own mesh (by index),
+				* the caller then combines them in mesh order. Jobs may create nodes,
+				* which relies on RepoUUID::createUUID being thread safe
+				* @param meshes meshes to process
+				* @param job job to run, given the index of the mesh, returns true upon success
+				* @return returns true if every job succeeded
+				*/
+				bool processMeshesInParallel(
+					const std::vector<const repo::core::model::MeshNode*> &meshes,
+					const std::function<bool(const size_t &, const repo::core::model::MeshNode *)> &job) const;
+
 				bool convertSuccess;
 				repo::core::model::RepoScene::GraphType gType;
 				std::unordered_map<std::string, repo::lib::PropertyTree> trees;
@@ -92,6 +139,11 @@ namespace repo{
 			private:
 				std::string sanitizeFileName(
 					const std::string &name) const;
+
+				repo::core::model::MeshSplitCache *splitCache;
+				std::atomic<uint64_t> nSplitFaces; //faces of the meshes split so far
+				std::atomic<uint64_t> orgCacheMisses; //vertex cache misses of those faces in their original order
+				std::atomic<uint64_t> cacheMisses; //vertex cache misses of those faces once reordered
 			};
 		} //namespace modelconvertor
 	} //namespace manipulator
@@ -149,7 +149,7 @@ bool IFCUtilsGeometry::generateGeometry(
 		return false;
 	}
 
-	std::vector<std::vector<repo_face_t>> allFaces;
+	std::vector<repo::lib::RepoFaceBuffer> allFaces;
 	std::vector<std::vector<double>> allVertices;
 	std::vector<std::vector<double>> allNormals;
 	std::vector<std::vector<double>> allUVs;
@@ -170,7 +170,6 @@ bool IFCUtilsGeometry::generateGeometry(
 	{
 		std::vector<repo::lib::RepoVector3D> vertices, normals;
 		std::vector<repo::lib::RepoVector2D> uvs;
-		std::vector<repo_face_t> faces;
 		std::vector<std::vector<float>> boundingBox;
 		for (int j = 0; j < allVertices[i].size(); j += 3)
 		{
@@ -258,7 +257,7 @@ void IFCUtilsGeometry::retrieveGeometryFromIterator(
 	IfcGeom::Iterator<double> &contextIterator,
 	const bool useMaterialNames,
 	std::vector < std::vector<double>> &allVertices,
-	std::vector<std::vector<repo_face_t>> &allFaces,
+	std::vector<repo::lib::RepoFaceBuffer> &allFaces,
 	std::vector < std::vector<double>> &allNormals,
 	std::vector < std::vector<double>> &allUVs,
 	std::vector<std::string> &allIds,
@@ -280,7 +279,7 @@ void IFCUtilsGeometry::retrieveGeometryFromIterator(
 			std::unordered_map<int, int> vertexCount;
 			std::unordered_map<int, std::vector<double>> post_vertices, post_normals, post_uvs;
 			std::unordered_map<int, std::string> post_materials;
-			std::unordered_map<int, std::vector<repo_face_t>> post_faces;
+			std::unordered_map<int, repo::lib::RepoFaceBuffer> post_faces;
 
 			auto matIndIt = ob_geo->geometry().material_ids().begin();
 
@@ -310,12 +309,12 @@ void IFCUtilsGeometry::retrieveGeometryFromIterator(
 					vertexCount[matInd] = 0;
 
 					std::unordered_map<int, std::vector<double>> post_vertices, post_normals, post_uvs;
-					std::unordered_map<int, std::vector<repo_face_t>> post_faces;
+					std::unordered_map<int, repo::lib::RepoFaceBuffer> post_faces;
 
 					post_vertices[matInd] = std::vector<double>();
 					post_normals[matInd] = std::vector<double>();
 					post_uvs[matInd] = std::vector<double>();
-					post_faces[matInd] = std::vector<repo_face_t>();
+					post_faces[matInd] = repo::lib::RepoFaceBuffer();
 
 					auto material = ob_geo->geometry().materials()[matInd];
 					std::string matName = useMaterialNames ? material.original_name() : material.name();
@@ -329,7 +328,7 @@ void IFCUtilsGeometry::retrieveGeometryFromIterator(
 					}
 				}
 
-				repo_face_t face;
+				uint32_t face[3];
 				for (int j = 0; j < 3; ++j)
 				{
 					auto vIndex = faces[iface + j];
@@ -352,10 +351,10 @@ void IFCUtilsGeometry::retrieveGeometryFromIterator(
 							}
 						}
 					}
-					face.push_back(indexMapping[matInd][vIndex]);
+					face[j] = indexMapping[matInd][vIndex];
 				}
 
-				post_faces[matInd].push_back(face);
+				post_faces[matInd].addTriangle(face[0], face[1], face[2]);
 
 				++matIndIt;
 			}
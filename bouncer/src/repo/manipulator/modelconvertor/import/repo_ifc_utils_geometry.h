@@ -119,7 +119,7 @@ namespace repo{
 					IfcGeom::Iterator<double> &contextIterator,
 					const bool useMaterialNames,
 					std::vector < std::vector<double>> &allVertices,
-					std::vector<std::vector<repo_face_t>> &allFaces,
+					std::vector<repo::lib::RepoFaceBuffer> &allFaces,
 					std::vector < std::vector<double>> &allNormals,
 					std::vector < std::vector<double>> &allUVs,
 					std::vector<std::string> &allIds,
@@ -147,7 +147,7 @@ repo::core::model::MeshNode* RepoModelImport::createMeshNode(const ptree &mesh,
 	//Avoid using assimp objects everywhere -> converting assimp objects into repo structs
 	std::vector<repo::lib::RepoVector3D> vertices;
 	std::vector<repo::lib::RepoVector3D> normals;
-	std::vector<repo_face_t> faces;
+	repo::lib::RepoFaceBuffer faces;
 
 	std::vector<std::vector<float> > boundingBox;
 
@@ -190,15 +190,10 @@ repo::core::model::MeshNode* RepoModelImport::createMeshNode(const ptree &mesh,
 
 			uint32_t *tmpIndices = (uint32_t*)(geomBuf + startEnd[0]);
 
+			faces.reserve(numIndices / 3);
 			for(int i = 0; i < numIndices; i += 3)
 			{
-				repo_face_t tmpFace;
-
-				tmpFace.push_back(tmpIndices[i]);
-				tmpFace.push_back(tmpIndices[i + 1]);
-				tmpFace.push_back(tmpIndices[i + 2]);
-
-				faces.push_back(tmpFace);
+				faces.addTriangle(tmpIndices[i], tmpIndices[i + 1], tmpIndices[i + 2]);
 			}
 		}
 	}
@@ -240,20 +235,7 @@ repo::core::model::MeshNode* RepoModelImport::createMeshNode(const ptree &mesh,
 
 	if (!trans.isIdentity())
 	{
-		repo::lib::RepoMatrix invTrans;
-
-		invTrans = trans.invert().transpose();
-
-		auto data = invTrans.getData();
-		data[3] = data[7] = data[11] = 0;
-		data[12] = data[13] = data[14] = 0;
-
-		repo::lib::RepoMatrix normTrans(data);
-
-		for(auto &n : normals)
-		{
-			n = normTrans * n;
-		}
+		trans.transformNormals(normals.data(), normals.data(), normals.size());
 	}
 
 	std::vector<float> minBBox;
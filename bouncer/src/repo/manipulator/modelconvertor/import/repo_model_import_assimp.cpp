@@ -385,7 +385,7 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 
 	//Avoid using assimp objects everywhere -> converting assimp objects into repo structs
 	std::vector<repo::lib::RepoVector3D> vertices;
-	std::vector<repo_face_t> faces;
+	repo::lib::RepoFaceBuffer faces;
 	std::vector<repo::lib::RepoVector3D> normals;
 	std::vector<std::vector<repo::lib::RepoVector2D>> uvChannels;
 	std::vector<repo_color4d_t> colors;
@@ -424,10 +424,10 @@ repo::core::model::MeshNode AssimpModelImport::createMeshRepoNode(
 	*/
 	if (assimpMesh->HasFaces())
 	{
+		faces.reserve(assimpMesh->mNumFaces, assimpMesh->mFaces[0].mNumIndices);
 		for (uint32_t i = 0; i < assimpMesh->mNumFaces; i++)
 		{
-			faces.push_back({ std::vector<uint32_t>(assimpMesh->mFaces[i].mIndices,
-				assimpMesh->mFaces[i].mIndices + assimpMesh->mFaces[i].mNumIndices) });
+			faces.push_back(repo::lib::RepoArrayView<uint32_t>(assimpMesh->mFaces[i].mIndices, assimpMesh->mFaces[i].mNumIndices));
 		}
 	}
 	/*
@@ -641,6 +641,7 @@ repo::core::model::RepoNodeSet AssimpModelImport::createTransformationNodesRecur
 	const std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode *, repo::lib::RepoUUIDHasher>    &meshToMat,
 	std::unordered_map<repo::core::model::RepoNode *, std::vector<repo::lib::RepoUUID>> &matParents,
 	repo::core::model::RepoNodeSet			                 &newMeshes,
+	std::unordered_map<unsigned int, repo::core::model::RepoNode*> &meshInstances,
 	repo::core::model::RepoNodeSet						     &metadata,
 	uint32_t                                               &count,
 	const std::vector<double>                                &worldOffset,
@@ -692,11 +693,22 @@ repo::core::model::RepoNodeSet AssimpModelImport::createTransformationNodesRecur
 			unsigned int meshIndex = assimpNode->mMeshes[i];
 			if (meshIndex < meshes.size())
 			{
+				auto instanceIt = meshInstances.find(meshIndex);
+				if (instanceIt != meshInstances.end())
+				{
+					//Mesh is already used by another node: reference it instead of copying the geometry
+					repo::core::model::RepoNode instanced = instanceIt->second->cloneAndAddParent(sharedId);
+					instanceIt->second->swap(instanced);
+					continue;
+				}
+
 				repo::core::model::RepoNode mesh = meshes[meshIndex];
 
 				if (!mesh.isEmpty())
 				{
-					newMeshes.insert(duplicateMesh(sharedId, mesh, meshToMat, matParents));
+					auto newMesh = duplicateMesh(sharedId, mesh, meshToMat, matParents);
+					meshInstances[meshIndex] = newMesh;
+					newMeshes.insert(newMesh);
 				}
 			}
 		}
@@ -735,7 +747,7 @@ repo::core::model::RepoNodeSet AssimpModelImport::createTransformationNodesRecur
 		{
 			repo::core::model::RepoNodeSet childMetadata;
 			repo::core::model::RepoNodeSet childSet = createTransformationNodesRecursive(assimpNode->mChildren[i],
-				cameras, meshes, meshToMat, matParents, newMeshes, childMetadata, ++count, worldOffset, myShareID);
+				cameras, meshes, meshToMat, matParents, newMeshes, meshInstances, childMetadata, ++count, worldOffset, myShareID);
 
 			transNodes.insert(childSet.begin(), childSet.end());
 			metadata.insert(childMetadata.begin(), childMetadata.end());
@@ -1012,8 +1024,9 @@ repo::core::model::RepoScene* AssimpModelImport::convertAiSceneToRepoScene()
 		// RootNode will be the first entry in transformations vector.
 
 		uint32_t count = 0;
+		std::unordered_map<unsigned int, repo::core::model::RepoNode*> meshInstances;
 		transformations = createTransformationNodesRecursive(assimpScene->mRootNode,
-			camerasMap, originalOrderMesh, meshToMat, matParents, meshes, metadata, count, sceneBbox[0]);
+			camerasMap, originalOrderMesh, meshToMat, matParents, meshes, meshInstances, metadata, count, sceneBbox[0]);
 
 		repoInfo << "Node Construction completed. (#transformations: " << transformations.size() << ", #Metadata" << metadata.size() << ")";
 
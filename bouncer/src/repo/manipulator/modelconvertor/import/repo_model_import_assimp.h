@@ -143,6 +143,9 @@ namespace repo{
 				* @param cameras a map of camera name to camera objects
 				* @param meshes A vector fo mesh nodes in its original ASSIMP object order
 				* @param newMeshes newly produced meshes based on original ordered meshes
+				* @param meshInstances assimp mesh index to the mesh node created for it. A mesh
+				*                      referenced by several nodes is instanced (given several parents)
+				*                      rather than copied
 				* @param metadata a RepoNode Set to store metadata nodes generated within this function
 				* @param map keeps track of the mapping between assimp pointer and repoNode
 				* @param parent a vector of parents to this node (optional)
@@ -155,6 +158,7 @@ namespace repo{
 					const std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode *, repo::lib::RepoUUIDHasher>    &meshToMat,
 					std::unordered_map<repo::core::model::RepoNode *, std::vector<repo::lib::RepoUUID>> &matParents,
 					repo::core::model::RepoNodeSet                                       &newMeshes,
+					std::unordered_map<unsigned int, repo::core::model::RepoNode*>       &meshInstances,
 					repo::core::model::RepoNodeSet						                 &metadata,
 					uint32_t                                                             &count,
 					const std::vector<double>                                            &worldOffset,
@@ -164,6 +168,7 @@ namespace repo{
 				/**
 				* Duplicate the given mesh and assign a new parent
 				* Also create a new unique ID and shared ID for the mesh
+				* This is done once per assimp mesh, further instances only add a parent
 				* @return returns a pointer to the newly constructed mesh
 				*/
 				repo::core::model::RepoNode* duplicateMesh(
@@ -89,6 +89,15 @@ bool IFCOptimzer::removeTransformationsWithNames(
 				auto children = scene->getChildrenAsNodes(defaultG, transNode->getSharedID());
 				auto trans = transNode->getTransMatrix(false);
 
+				//Baking the transformation into a shared (instanced) child would move its other instances too
+				if (!transNode->isIdentity() && std::any_of(children.begin(), children.end(),
+					[](const repo::core::model::RepoNode *child) {
+					return child && child->positionDependant() && child->getParentIDs().size() > 1; }))
+				{
+					repoTrace << "Keeping " << name << " " << transSharedID << " as it has instanced children";
+					continue;
+				}
+
 				//Remove self from child
 				for (auto &child : children)
 				{
@@ -23,14 +23,49 @@
 #include "../../core/model/bson/repo_bson_factory.h"
 #include "../../core/model/bson/repo_bson_builder.h"
 
+#include <algorithm>
+#include <atomic>
+#include <boost/thread.hpp>
+
 using namespace repo::manipulator::modeloptimizer;
 
 auto defaultGraph = repo::core::model::RepoScene::GraphType::DEFAULT;
 
 static const size_t  REPO_MP_MAX_FACE_COUNT = 500000;
 
-MultipartOptimizer::MultipartOptimizer() :
-AbstractOptimizer()
+//Bits of the mesh format (see MeshNode::getMFormat())
+static const uint32_t REPO_MP_NORMALS_BIT = 1 << 2;
+static const uint32_t REPO_MP_COLORS_BIT = 1 << 3;
+static const uint32_t REPO_MP_UV_SHIFT = 4;
+
+/**
+* Append the groupings to the list of groups, ordered by key
+* so the resulting list does not depend on the hashing order
+*/
+template <class Key, class Hasher>
+static void appendGroupsInOrder(
+	const std::unordered_map<Key, std::vector<std::set<repo::lib::RepoUUID>>, Hasher> &groupings,
+	std::vector<const std::set<repo::lib::RepoUUID>*> &groups)
+{
+	std::vector<Key> keys;
+	keys.reserve(groupings.size());
+	for (const auto &grouping : groupings)
+		keys.push_back(grouping.first);
+	std::sort(keys.begin(), keys.end());
+
+	for (const auto &key : keys)
+	{
+		for (const auto &group : groupings.at(key))
+			groups.push_back(&group);
+	}
+}
+
+MultipartOptimizer::MultipartOptimizer(
+	const size_t &maxSuperMeshSize,
+	const size_t &maxMergeMemory) :
+AbstractOptimizer(),
+maxSuperMeshSize(maxSuperMeshSize),
+maxMergeMemory(maxMergeMemory)
 {
 }
 
@@ -69,11 +104,12 @@ bool MultipartOptimizer::collectMeshData(
 	repo::lib::RepoMatrix                       &mat,
 	std::vector<repo::lib::RepoVector3D>                &vertices,
 	std::vector<repo::lib::RepoVector3D>                &normals,
-	std::vector<repo_face_t>                  &faces,
+	repo::lib::RepoFaceBuffer                 &faces,
 	std::vector<std::vector<repo::lib::RepoVector2D>> &uvChannels,
 	std::vector<repo_color4d_t>               &colors,
 	std::vector<repo_mesh_mapping_t>          &meshMapping,
-	std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>    &matIDMap
+	const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>    &matIDMap,
+	bool                                      &nonAffine
 	)
 {
 	bool success = false;
@@ -86,11 +122,15 @@ bool MultipartOptimizer::collectMeshData(
 			auto trans = (repo::core::model::TransformationNode *) node;
 			mat = mat * trans->getTransMatrix(false);
 			auto children = scene->getChildrenAsNodes(defaultGraph, trans->getSharedID());
+			//Merge in a fixed order so the super mesh does not depend on how the scene was populated
+			std::sort(children.begin(), children.end(),
+				[](const repo::core::model::RepoNode *a, const repo::core::model::RepoNode *b)
+			{ return a->getUniqueID() < b->getUniqueID(); });
 			for (const auto &child : children)
 			{
 				auto childMat = mat; //We don't want actually want to update the matrix with our children's transformation
 				success &= collectMeshData(scene, child, meshGroup, childMat,
-					vertices, normals, faces, uvChannels, colors, meshMapping, matIDMap);
+					vertices, normals, faces, uvChannels, colors, meshMapping, matIDMap, nonAffine);
 			}
 			break;
 		}
@@ -102,33 +142,25 @@ bool MultipartOptimizer::collectMeshData(
 			{
 				auto mesh = (repo::core::model::MeshNode *) node;
 
-				repo::core::model::MeshNode transformedMesh = mesh->cloneAndApplyTransformation(mat);
 				//this node is in the grouping, add it into the data buffers
 				repo_mesh_mapping_t meshMap;
-				repo::lib::RepoUUID matID = getMaterialID(scene, mesh);
-				repo::lib::RepoUUID newMatID;
-
-				if (matIDMap.find(matID) == matIDMap.end())
+				//IDs of the new materials are assigned before merging starts, the map is read only here
+				auto infoIt = meshInfo.find(meshUniqueID);
+				auto matIt = infoIt == meshInfo.end() ? matIDMap.end() : matIDMap.find(infoIt->second.materialID);
+				if (matIt == matIDMap.end())
 				{
-					newMatID = repo::lib::RepoUUID::createUUID();
-					matIDMap[matID] = newMatID;
+					repoError << "Material of mesh " << meshUniqueID << " has not been assigned a new ID";
+					return false;
 				}
-				else
-					newMatID = matIDMap[matID];
-				meshMap.material_id = newMatID;
+				meshMap.material_id = matIt->second;
 				meshMap.mesh_id = meshUniqueID;
-				auto bbox = transformedMesh.getBoundingBox();
-				if (bbox.size() >= 2)
-				{
-					meshMap.min = bbox[0];
-					meshMap.max = bbox[1];
-				}
 
-				std::vector<repo::lib::RepoVector3D> submVertices = transformedMesh.getVertices();
-				std::vector<repo::lib::RepoVector3D> submNormals = transformedMesh.getNormals();
-				std::vector<repo_face_t>   submFaces = transformedMesh.getFaces();
-				std::vector<repo_color4d_t> submColors = transformedMesh.getColors();
-				std::vector<std::vector<repo::lib::RepoVector2D>> submUVs = transformedMesh.getUVChannelsSeparated();
+				//views into the original mesh, its data is transformed straight into the merged buffers
+				auto submVertices = mesh->getVerticesView();
+				auto submNormals = mesh->getNormalsView();
+				auto submFaces = mesh->getFacesView();
+				auto submColors = mesh->getColorsView();
+				auto submUVs = mesh->getUVChannelsSeparatedView();
 
 				if (success = submVertices.size() && submFaces.size())
 				{
@@ -137,21 +169,20 @@ bool MultipartOptimizer::collectMeshData(
 					meshMap.triFrom = faces.size();
 					meshMap.triTo = faces.size() + submFaces.size();
 
+					vertices.resize(meshMap.vertTo);
+					nonAffine |= !mat.isAffine();
+					mat.transformPositions(submVertices.data(), &vertices[meshMap.vertFrom], submVertices.size(),
+						meshMap.min, meshMap.max);
+					faces.append(submFaces, meshMap.vertFrom);
+
 					meshMapping.push_back(meshMap);
 
-					vertices.insert(vertices.end(), submVertices.begin(), submVertices.end());
-					for (const auto face : submFaces)
+					if (submNormals.size())
 					{
-						repo_face_t offsetFace;
-						for (const auto idx : face)
-						{
-							offsetFace.push_back(meshMap.vertFrom + idx);
-						}
-						faces.push_back(offsetFace);
+						const size_t normalsFrom = normals.size();
+						normals.resize(normalsFrom + submNormals.size());
+						mat.transformNormals(submNormals.data(), &normals[normalsFrom], submNormals.size());
 					}
-
-					if (submNormals.size())
-						normals.insert(normals.end(), submNormals.begin(), submNormals.end());
 					if (submColors.size())
 						colors.insert(colors.end(), submColors.begin(), submColors.end());
 
@@ -171,7 +202,7 @@ bool MultipartOptimizer::collectMeshData(
 					else
 					{
 						//This shouldn't happen, if it does, then it means the mFormat isn't set correctly
-						repoError << "Unexpected transformedMesh format mismatch occured!";
+						repoError << "Unexpected mesh format mismatch occured!";
 					}
 				}
 				else
@@ -195,21 +226,51 @@ repo::core::model::MeshNode* MultipartOptimizer::createSuperMesh
 (
 const repo::core::model::RepoScene *scene,
 const std::set<repo::lib::RepoUUID>           &meshGroup,
-std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>  &matIDs)
+const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>  &matIDs)
 {
 	std::vector<repo::lib::RepoVector3D> vertices, normals;
-	std::vector<repo_face_t> faces;
+	repo::lib::RepoFaceBuffer faces;
 	std::vector<std::vector<repo::lib::RepoVector2D>> uvChannels;
 	std::vector<repo_color4d_t> colors;
 	std::vector<repo_mesh_mapping_t> meshMapping;
 
 	repo::core::model::MeshNode* resultMesh = nullptr;
 
-	std::vector<repo::core::model::MeshNode*> resultMeshes;
+	//Size the buffers up front from the cached statistics, so they are
+	//never reallocated (nor left with spare capacity) whilst merging
+	size_t nVertices = 0, nFaces = 0, nInstances = 0;
+	uint32_t mFormat = 0;
+	for (const auto &meshID : meshGroup)
+	{
+		auto infoIt = meshInfo.find(meshID);
+		if (infoIt == meshInfo.end()) continue;
+		nVertices += (size_t)infoIt->second.nVertices * infoIt->second.nInstances;
+		nFaces += (size_t)infoIt->second.nFaces * infoIt->second.nInstances;
+		nInstances += infoIt->second.nInstances;
+		mFormat = infoIt->second.mFormat; //all meshes of a group share the same format
+	}
+	vertices.reserve(nVertices);
+	if (mFormat & REPO_MP_NORMALS_BIT)
+		normals.reserve(nVertices);
+	if (mFormat & REPO_MP_COLORS_BIT)
+		colors.reserve(nVertices);
+	uvChannels.resize(mFormat >> REPO_MP_UV_SHIFT);
+	for (auto &channel : uvChannels)
+		channel.reserve(nVertices);
+	faces.reserve(nFaces);
+	meshMapping.reserve(nInstances);
+
 	repo::lib::RepoMatrix startMat;
+	bool nonAffine = false;
 
 	bool success = collectMeshData(scene, scene->getRoot(defaultGraph), meshGroup, startMat,
-		vertices, normals, faces, uvChannels, colors, meshMapping, matIDs);
+		vertices, normals, faces, uvChannels, colors, meshMapping, matIDs, nonAffine);
+
+	if (nonAffine)
+	{
+		repoWarning << "Potentially incorrect transformation : does not expect the last row to have values! (merged mesh of "
+			<< meshGroup.size() << " meshes)";
+	}
 
 	if (success && meshMapping.size())
 	{
@@ -243,6 +304,13 @@ std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUID
 		std::vector<std::vector<float>> bboxVec = { { bbox[0].x, bbox[0].y, bbox[0].z }, { bbox[1].x, bbox[1].y, bbox[1].z } };
 
 		repo::core::model::MeshNode superMesh = repo::core::model::RepoBSONFactory::makeMeshNode(vertices, faces, normals, bboxVec, uvChannels, colors, outline);
+		//The node holds its own copy of the geometry now, release ours before it is copied again
+		std::vector<repo::lib::RepoVector3D>().swap(vertices);
+		std::vector<repo::lib::RepoVector3D>().swap(normals);
+		faces = repo::lib::RepoFaceBuffer();
+		std::vector<std::vector<repo::lib::RepoVector2D>>().swap(uvChannels);
+		std::vector<repo_color4d_t>().swap(colors);
+
 		resultMesh = new repo::core::model::MeshNode(superMesh.cloneAndUpdateMeshMapping(meshMapping, true));
 	}
 	else
@@ -263,7 +331,8 @@ bool MultipartOptimizer::generateMultipartScene(repo::core::model::RepoScene *sc
 		std::unordered_map<uint32_t, std::vector<std::set<repo::lib::RepoUUID>>> transparentMeshes, normalMeshes;
 		std::unordered_map<uint32_t, std::unordered_map<repo::lib::RepoUUID, std::vector<std::set<repo::lib::RepoUUID>>, repo::lib::RepoUUIDHasher>> texturedMeshes;
 		//Sort the meshes into 3 different grouping
-		sortMeshes(scene, meshes, normalMeshes, transparentMeshes, texturedMeshes);
+		cacheMeshInfo(scene, meshes);
+		sortMeshes(meshes, normalMeshes, transparentMeshes, texturedMeshes);
 
 		repo::core::model::RepoNodeSet mergedMeshes, materials, trans, textures, dummy;
 
@@ -271,36 +340,89 @@ bool MultipartOptimizer::generateMultipartScene(repo::core::model::RepoScene *sc
 		trans.insert(rootNode);
 		repo::lib::RepoUUID rootID = rootNode->getSharedID();
 
-		std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode*, repo::lib::RepoUUIDHasher> matNodes;
-		std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> matIDs;
+		//Groups are listed in a fixed order: normal, transparent then textured meshes, each by format (and texture)
+		std::vector<const std::set<repo::lib::RepoUUID>*> groups;
+		appendGroupsInOrder(normalMeshes, groups);
+		appendGroupsInOrder(transparentMeshes, groups);
+		std::vector<uint32_t> texturedFormats;
+		for (const auto &textureMeshMap : texturedMeshes)
+			texturedFormats.push_back(textureMeshMap.first);
+		std::sort(texturedFormats.begin(), texturedFormats.end());
+		for (const auto &mFormat : texturedFormats)
+			appendGroupsInOrder(texturedMeshes[mFormat], groups);
 
-		for (const auto &groupings : normalMeshes)
+		//Assign the new material IDs up front so merging the groups shares no mutable state
+		std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> matIDs;
+		for (const auto &group : groups)
 		{
-			for (const auto grouping : groupings.second)
+			for (const auto &meshID : *group)
 			{
-				success &= processMeshGroup(scene, grouping, rootID, mergedMeshes, matNodes, matIDs);
+				const auto &matID = meshInfo.at(meshID).materialID;
+				if (matIDs.find(matID) == matIDs.end())
+					matIDs[matID] = repo::lib::RepoUUID::createUUID();
 			}
 		}
-		for (const auto &groupings : transparentMeshes)
+
+		//Merging a group holds its source geometry, the merged buffers and the new node at once,
+		//about 3 times its size. Merges wait for each other to keep the memory in flight within
+		//maxMergeMemory, a group over the budget on its own is merged once nothing else is.
+		std::vector<uint64_t> mergeCosts(groups.size(), 0);
+		for (size_t i = 0; i < groups.size(); ++i)
 		{
-			for (const auto grouping : groupings.second)
+			for (const auto &meshID : *groups[i])
 			{
-				success &= processMeshGroup(scene, grouping, rootID, mergedMeshes, matNodes, matIDs);
+				const auto &info = meshInfo.at(meshID);
+				mergeCosts[i] += 3 * info.nBytes * info.nInstances;
 			}
 		}
-
-		//textured meshes
-		for (const auto &textureMeshMap : texturedMeshes)
+		uint64_t bytesInFlight = 0;
+		boost::mutex memoryMutex;
+		boost::condition_variable memoryReleased;
+
+		//Every group is merged independently, each thread picks the next unmerged group
+		std::vector<repo::core::model::MeshNode*> superMeshes(groups.size(), nullptr);
+		std::atomic<size_t> nextGroup(0);
+		auto mergeGroups = [&]()
 		{
-			for (const auto &groupings : textureMeshMap.second)
+			size_t i;
+			while ((i = nextGroup++) < groups.size())
 			{
-				for (const auto grouping : groupings.second)
 				{
+					boost::mutex::scoped_lock lock(memoryMutex);
+					while (bytesInFlight && bytesInFlight + mergeCosts[i] > maxMergeMemory)
+						memoryReleased.wait(lock);
+					bytesInFlight += mergeCosts[i];
+				}
 
-					success &= processMeshGroup(scene, grouping, rootID, mergedMeshes, matNodes, matIDs);
+				try{
+					superMeshes[i] = createSuperMesh(scene, *groups[i], matIDs);
+				}
+				catch (std::exception &e)
+				{
+					repoError << "Failed to merge mesh group: " << e.what();
+				}
 
+				{
+					boost::mutex::scoped_lock lock(memoryMutex);
+					bytesInFlight -= mergeCosts[i];
 				}
+				memoryReleased.notify_all();
 			}
+		};
+
+		const size_t nThreads = std::min<size_t>(groups.size(), std::max(1u, boost::thread::hardware_concurrency()));
+		repoInfo << "Merging " << groups.size() << " mesh groups with " << nThreads << " threads";
+		boost::thread_group mergers;
+		for (size_t i = 1; i < nThreads; ++i)
+			mergers.create_thread(mergeGroups);
+		mergeGroups();
+		mergers.join_all();
+
+		//Combine the results in group order so the stash is reproducible
+		std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode*, repo::lib::RepoUUIDHasher> matNodes;
+		for (const auto &sMesh : superMeshes)
+		{
+			success &= processMeshGroup(scene, sMesh, rootID, mergedMeshes, matNodes, matIDs);
 		}
 
 		if (success)
@@ -333,70 +455,70 @@ bool MultipartOptimizer::generateMultipartScene(repo::core::model::RepoScene *sc
 		repoError << "Cannot generate a multipart scene for a scene with no meshes";
 	}
 
+	meshInfo.clear();
+
 	return success;
 }
 
-repo::lib::RepoUUID MultipartOptimizer::getMaterialID(
-	const repo::core::model::RepoScene *scene,
-	const repo::core::model::MeshNode  *mesh
-	)
+void MultipartOptimizer::cacheMeshInfo(
+	const repo::core::model::RepoScene   *scene,
+	const repo::core::model::RepoNodeSet &meshes)
 {
-	repo::lib::RepoUUID matID = repo::lib::RepoUUID(REPO_HISTORY_MASTER_BRANCH);
-	const auto mat = scene->getChildrenNodesFiltered(defaultGraph, mesh->getSharedID(), repo::core::model::NodeType::MATERIAL);
-	if (mat.size())
-	{
-		matID = mat[0]->getUniqueID();
-	}
-
-	return matID;
-}
+	meshInfo.clear();
+	meshInfo.reserve(meshes.size());
+	const auto instanceCounts = scene->getMeshInstanceCounts(defaultGraph);
 
-bool MultipartOptimizer::hasTexture(
-	const repo::core::model::RepoScene *scene,
-	const repo::core::model::MeshNode  *mesh,
-	repo::lib::RepoUUID                           &texID)
-{
-	bool hasText = false;
-	const auto mat = scene->getChildrenNodesFiltered(defaultGraph, mesh->getSharedID(), repo::core::model::NodeType::MATERIAL);
-	if (mat.size())
+	for (const auto &node : meshes)
 	{
-		const auto texture = scene->getChildrenNodesFiltered(defaultGraph, mat[0]->getSharedID(), repo::core::model::NodeType::TEXTURE);
-		if (hasText = texture.size())
+		auto mesh = dynamic_cast<const repo::core::model::MeshNode*>(node);
+		if (!mesh) continue;
+
+		MeshInfo info;
+		info.nVertices = mesh->getNumVertices();
+		info.nFaces = mesh->getNumFaces();
+		info.mFormat = mesh->getMFormat();
+		auto instanceIt = instanceCounts.find(mesh->getUniqueID());
+		info.nInstances = instanceIt != instanceCounts.end() && instanceIt->second ? instanceIt->second : 1;
+		//The faces are merged as they are serialised, whatever the polygon sizes
+		info.nBytes = (uint64_t)info.nVertices * (sizeof(repo::lib::RepoVector3D)
+			+ (info.mFormat & REPO_MP_NORMALS_BIT ? sizeof(repo::lib::RepoVector3D) : 0)
+			+ (info.mFormat & REPO_MP_COLORS_BIT ? sizeof(repo_color4d_t) : 0)
+			+ (info.mFormat >> REPO_MP_UV_SHIFT) * sizeof(repo::lib::RepoVector2D))
+			+ (uint64_t)mesh->getFacesView().serialised().size() * sizeof(uint32_t);
+		info.materialID = repo::lib::RepoUUID(REPO_HISTORY_MASTER_BRANCH);
+		info.hasTexture = false;
+		info.isTransparent = false;
+
+		const auto mat = scene->getChildrenNodesFiltered(defaultGraph, mesh->getSharedID(), repo::core::model::NodeType::MATERIAL);
+		if (mat.size())
 		{
-			texID = texture[0]->getSharedID();
+			info.materialID = mat[0]->getUniqueID();
+			const auto texture = scene->getChildrenNodesFiltered(defaultGraph, mat[0]->getSharedID(), repo::core::model::NodeType::TEXTURE);
+			if (info.hasTexture = texture.size())
+			{
+				info.textureID = texture[0]->getSharedID();
+			}
+			else
+			{
+				const repo::core::model::MaterialNode* matNode = (repo::core::model::MaterialNode*)mat[0];
+				info.isTransparent = matNode->getMaterialStruct().opacity != 1;
+			}
 		}
-	}
 
-	return hasText;
-}
-
-bool MultipartOptimizer::isTransparent(
-	const repo::core::model::RepoScene *scene,
-	const repo::core::model::MeshNode  *mesh)
-{
-	bool isTransparent = false;
-	const auto mat = scene->getChildrenNodesFiltered(defaultGraph, mesh->getSharedID(), repo::core::model::NodeType::MATERIAL);
-	if (mat.size())
-	{
-		const repo::core::model::MaterialNode* matNode = (repo::core::model::MaterialNode*)mat[0];
-		const auto matStruct = matNode->getMaterialStruct();
-		isTransparent = matStruct.opacity != 1;
+		meshInfo[mesh->getUniqueID()] = info;
 	}
-
-	return isTransparent;
 }
 
 bool MultipartOptimizer::processMeshGroup(
 	const repo::core::model::RepoScene                                        *scene,
-	const  std::set<repo::lib::RepoUUID>                                                  &meshes,
+	repo::core::model::MeshNode                                               *sMesh,
 	const repo::lib::RepoUUID                                                             &rootID,
 	repo::core::model::RepoNodeSet                                             &mergedMeshes,
 	std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode*, repo::lib::RepoUUIDHasher> &matNodes,
-	std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>                     &matIDs
+	const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>               &matIDs
 	)
 {
 	bool success = false;
-	auto sMesh = createSuperMesh(scene, meshes, matIDs);
 	if (success = sMesh)
 	{
 		auto sMeshWithParent = sMesh->cloneAndAddParent({ rootID });
@@ -455,22 +577,54 @@ bool MultipartOptimizer::processMeshGroup(
 }
 
 void MultipartOptimizer::sortMeshes(
-	const repo::core::model::RepoScene                                      *scene,
 	const repo::core::model::RepoNodeSet                                    &meshes,
 	std::unordered_map<uint32_t, std::vector<std::set<repo::lib::RepoUUID>>>						&normalMeshes,
 	std::unordered_map<uint32_t, std::vector<std::set<repo::lib::RepoUUID>>>						&transparentMeshes,
 	std::unordered_map < uint32_t, std::unordered_map < repo::lib::RepoUUID,
 	std::vector<std::set<repo::lib::RepoUUID>>, repo::lib::RepoUUIDHasher >> &texturedMeshes)
 {
-	std::unordered_map<uint32_t, size_t> normalFCount, transparentFCount;
-	std::unordered_map<uint32_t, std::unordered_map<repo::lib::RepoUUID, size_t, repo::lib::RepoUUIDHasher> > texturedFCount;
-
-	for (const auto &node : meshes)
+	//Size of the last group of every grouping
+	struct GroupSize
+	{
+		size_t nFaces;
+		uint64_t nBytes;
+	};
+	std::unordered_map<uint32_t, GroupSize> normalSize, transparentSize;
+	std::unordered_map<uint32_t, std::unordered_map<repo::lib::RepoUUID, GroupSize, repo::lib::RepoUUIDHasher> > texturedSize;
+
+	//Start another group whenever the mesh would take the last one over the face limit or the memory budget
+	auto addToGroup = [this](
+		std::vector<std::set<repo::lib::RepoUUID>> &groups,
+		GroupSize                                  &size,
+		const repo::lib::RepoUUID                  &meshID,
+		const size_t                               &nFaces,
+		const uint64_t                             &nBytes)
 	{
-		auto mesh = (repo::core::model::MeshNode*) node;
-		if (!mesh->getVertices().size() || !mesh->getFaces().size())
+		if (groups.empty() || (size.nFaces
+			&& (size.nFaces + nFaces > REPO_MP_MAX_FACE_COUNT || size.nBytes + nBytes > maxSuperMeshSize)))
 		{
-			repoWarning << "mesh " << mesh->getUniqueID() << " has no vertices/faces, skipping...";
+			groups.push_back(std::set<repo::lib::RepoUUID>());
+			size.nFaces = 0;
+			size.nBytes = 0;
+		}
+		groups.back().insert(meshID);
+		size.nFaces += nFaces;
+		size.nBytes += nBytes;
+	};
+
+	//Visit the meshes in a fixed order, the groupings would depend on their addresses otherwise
+	std::vector<repo::core::model::RepoNode*> orderedMeshes(meshes.begin(), meshes.end());
+	std::sort(orderedMeshes.begin(), orderedMeshes.end(),
+		[](const repo::core::model::RepoNode *a, const repo::core::model::RepoNode *b)
+	{ return a->getUniqueID() < b->getUniqueID(); });
+
+	for (const auto &node : orderedMeshes)
+	{
+		const auto &meshID = node->getUniqueID();
+		auto infoIt = meshInfo.find(meshID);
+		if (infoIt == meshInfo.end() || !infoIt->second.nVertices || !infoIt->second.nFaces)
+		{
+			repoWarning << "mesh " << meshID << " has no vertices/faces, skipping...";
 			continue;
 		}
 		/**
@@ -478,57 +632,28 @@ void MultipartOptimizer::sortMeshes(
 		* 2 - check if it has texture
 		* 3 - if not, check if it is transparent
 		*/
-		uint32_t mFormat = mesh->getMFormat();
-
-		repo::lib::RepoUUID texID;
-		if (hasTexture(scene, mesh, texID))
+		const auto &info = infoIt->second;
+		const uint32_t mFormat = info.mFormat;
+		//Every instance of a mesh is baked into the supermesh its group ends up in
+		const size_t faceCount = (size_t)info.nFaces * info.nInstances;
+		const uint64_t byteCount = info.nBytes * info.nInstances;
+		if (byteCount > maxSuperMeshSize)
 		{
-			auto it = texturedMeshes.find(mFormat);
-			if (it == texturedMeshes.end())
-			{
-				texturedMeshes[mFormat] = std::unordered_map<repo::lib::RepoUUID, std::vector<std::set<repo::lib::RepoUUID>>, repo::lib::RepoUUIDHasher>();
-				texturedFCount[mFormat] = std::unordered_map<repo::lib::RepoUUID, size_t, repo::lib::RepoUUIDHasher>();
-			}
-			auto it2 = texturedMeshes[mFormat].find(texID);
+			repoWarning << "mesh " << meshID << " (" << byteCount << " bytes) exceeds the super mesh memory budget on its own";
+		}
 
-			if (it2 == texturedMeshes[mFormat].end())
-			{
-				texturedMeshes[mFormat][texID] = std::vector<std::set<repo::lib::RepoUUID>>();
-				texturedMeshes[mFormat][texID].push_back(std::set<repo::lib::RepoUUID>());
-				texturedFCount[mFormat][texID] = 0;
-			}
-			size_t faceCount = mesh->getFaces().size();
-			if (texturedFCount[mFormat][texID] + faceCount > REPO_MP_MAX_FACE_COUNT)
-			{
-				//Exceed max face count, create another grouping entry for this format
-				texturedMeshes[mFormat][texID].push_back(std::set<repo::lib::RepoUUID>());
-				texturedFCount[mFormat][texID] = 0;
-			}
-			texturedMeshes[mFormat][texID].back().insert(mesh->getUniqueID());
-			texturedFCount[mFormat][texID] += mesh->getFaces().size();
+		if (info.hasTexture)
+		{
+			addToGroup(texturedMeshes[mFormat][info.textureID], texturedSize[mFormat][info.textureID],
+				meshID, faceCount, byteCount);
 		}
-		else
+		else if (info.isTransparent)
 		{
-			//no texture, check if it is transparent
-			const bool istransParentMesh = isTransparent(scene, mesh);
-			auto &meshMap = istransParentMesh ? transparentMeshes : normalMeshes;
-			auto &meshFCount = istransParentMesh ? transparentFCount : normalFCount;
-			auto it = meshMap.find(mFormat);
-			if (it == meshMap.end())
-			{
-				meshMap[mFormat] = std::vector<std::set<repo::lib::RepoUUID>>();
-				meshMap[mFormat].push_back(std::set<repo::lib::RepoUUID>());
-				meshFCount[mFormat] = 0;
-			}
-			size_t faceCount = mesh->getFaces().size();
-			if (meshFCount[mFormat] && meshFCount[mFormat] + faceCount > REPO_MP_MAX_FACE_COUNT)
-			{
-				//Exceed max face count, create another grouping entry for this format
-				meshMap[mFormat].push_back(std::set<repo::lib::RepoUUID>());
-				meshFCount[mFormat] = 0;
-			}
-			meshMap[mFormat].back().insert(mesh->getUniqueID());
-			meshFCount[mFormat] += mesh->getFaces().size();
+			addToGroup(transparentMeshes[mFormat], transparentSize[mFormat], meshID, faceCount, byteCount);
 		}
+		else
+		{
+			addToGroup(normalMeshes[mFormat], normalSize[mFormat], meshID, faceCount, byteCount);
 		}
-	}
\ No newline at end of file
+	}
+}
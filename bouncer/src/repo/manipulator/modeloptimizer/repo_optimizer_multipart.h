@@ -25,6 +25,9 @@
 #include "../../core/model/collection/repo_scene.h"
 #include "../../core/model/bson/repo_node_mesh.h"
 
+#define REPO_MP_MAX_SUPERMESH_SIZE 268435456 //<! default memory budget of a merged mesh (256MB)
+#define REPO_MP_MAX_MERGE_MEMORY 1073741824 //<! default memory budget of all the merges in flight (1GB)
+
 namespace repo {
 	namespace manipulator {
 		namespace modeloptimizer {
@@ -33,8 +36,14 @@ namespace repo {
 			public:
 				/**
 				* Default constructor
+				* @param maxSuperMeshSize memory budget (in bytes) for the geometry
+				*        of a merged mesh, groups are split to stay within it
+				* @param maxMergeMemory memory budget (in bytes) shared by all the
+				*        groups being merged at once, merges wait until it is available
 				*/
-				MultipartOptimizer();
+				MultipartOptimizer(
+					const size_t &maxSuperMeshSize = REPO_MP_MAX_SUPERMESH_SIZE,
+					const size_t &maxMergeMemory = REPO_MP_MAX_MERGE_MEMORY);
 
 				/**
 				* Default deconstructor
@@ -62,6 +71,8 @@ namespace repo {
 				* @param uvChannels uvChannels collected
 				* @param colors colors collected
 				* @param meshMapping meshMapping for this superMesh
+				* @param matIDMap original material unique ID to the ID of its copy in the stash
+				* @param nonAffine set if a mesh was transformed by a matrix that is not affine
 				*/
 				bool collectMeshData(
 					const repo::core::model::RepoScene        *scene,
@@ -70,25 +81,27 @@ namespace repo {
 					repo::lib::RepoMatrix                        &mat,
 					std::vector<repo::lib::RepoVector3D>                &vertices,
 					std::vector<repo::lib::RepoVector3D>                &normals,
-					std::vector<repo_face_t>                  &faces,
+					repo::lib::RepoFaceBuffer                 &faces,
 					std::vector<std::vector<repo::lib::RepoVector2D>> &uvChannels,
 					std::vector<repo_color4d_t>               &colors,
 					std::vector<repo_mesh_mapping_t>          &meshMapping,
-					std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>    &matIDMap
+					const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>    &matIDMap,
+					bool                                      &nonAffine
 					);
 
 				/**
 				* Merge all meshes within the mesh group and generate a
 				* super mesh.
+				* This only reads the scene, so groups can be merged concurrently
 				* @param scene where the meshes are
 				* @param meshGroup contains all the meshes to c merge
-				* @param matIDs the unique IDs f materials required by this mesh
+				* @param matIDs original material unique ID to the ID of its copy in the stash
 				* @return returns a pointer to a newly created merged mesh
 				*/
 				repo::core::model::MeshNode* createSuperMesh(
 					const repo::core::model::RepoScene *scene,
 					const std::set<repo::lib::RepoUUID>           &meshGroup,
-					std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> &matIDs);
+					const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher> &matIDs);
 
 				/**
 				* Generate the multipart scene
@@ -98,68 +111,69 @@ namespace repo {
 				bool generateMultipartScene(repo::core::model::RepoScene *scene);
 
 				/**
-				* Get child's material id from a mesh
-				* @param scene scene it belongs to
-				* @param mesh mesh in question
-				* @return returns unqiue ID of the material
-				*/
-				repo::lib::RepoUUID getMaterialID(
-					const repo::core::model::RepoScene *scene,
-					const repo::core::model::MeshNode  *mesh
-					);
-
-				/**
-				* Check if the mesh has texture
-				* @param scene scene as reference
-				* @param mesh mesh to check
-				* @param texID texID to return (if any)
-				* @return returns true if there is texture
+				* Gather the statistics of every mesh needed for grouping and merging
+				* in one pass, so the scene graph and the mesh binaries are not
+				* visited again for every query
+				* @param scene scene the meshes belong to
+				* @param meshes meshes to gather the statistics of
 				*/
-				bool hasTexture(
-					const repo::core::model::RepoScene *scene,
-					const repo::core::model::MeshNode  *mesh,
-					repo::lib::RepoUUID                           &texID);
+				void cacheMeshInfo(
+					const repo::core::model::RepoScene   *scene,
+					const repo::core::model::RepoNodeSet &meshes);
 
 				/**
-				* Check if the mesh is (semi) Transparent
-				* @param scene scene as reference
-				* @param mesh mesh to check
-				* @return returns true if the mesh is not fully opaque
-				*/
-				bool isTransparent(
-					const repo::core::model::RepoScene *scene,
-					const repo::core::model::MeshNode  *mesh);
-
-				/**
-				* Process a mesh grouping, great a merged mesh base on the information
+				* Add a merged mesh of a mesh grouping to the stash, along with the materials it uses
 				* @param scene as reference
-				* @param meshes mesh groupings
+				* @param sMesh merged mesh of the grouping (nullptr if merging failed)
 				* @param mergedMeshes add newly created meshes into this set
 				* @param matNodes contains already processed materials
+				* @param matIDs original material unique ID to the ID of its copy in the stash
 				*/
 				bool processMeshGroup(
 					const repo::core::model::RepoScene                                         *scene,
-					const std::set<repo::lib::RepoUUID>							                       & meshes,
+					repo::core::model::MeshNode                                                *sMesh,
 					const repo::lib::RepoUUID                                                             &rootID,
 					repo::core::model::RepoNodeSet                                             &mergedMeshes,
 					std::unordered_map<repo::lib::RepoUUID, repo::core::model::RepoNode*, repo::lib::RepoUUIDHasher> &matNodes,
-					std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>                    &matIDs);
+					const std::unordered_map<repo::lib::RepoUUID, repo::lib::RepoUUID, repo::lib::RepoUUIDHasher>              &matIDs);
 
 				/**
 				* Sort the given RepoNodeSet of meshes for multipart merging
-				* @param scene             scene as reference
+				* Every instance of a mesh is merged into the same group, so instanced
+				* meshes count once per instance towards the face limit and the
+				* memory budget of a group
+				* The meshes must have been passed to cacheMeshInfo() beforehand
 				* @param meshes            meshes to sort
 				* @param normalMeshes      container to store normal meshes
 				* @param transparentMeshes container to store (semi)transparent meshes
 				* @param texturedMeshes    container to store textured meshes
 				*/
 				void sortMeshes(
-					const repo::core::model::RepoScene                                      *scene,
 					const repo::core::model::RepoNodeSet                                    &meshes,
 					std::unordered_map<uint32_t, std::vector<std::set<repo::lib::RepoUUID>>>			&normalMeshes,
 					std::unordered_map<uint32_t, std::vector<std::set<repo::lib::RepoUUID>>>			&transparentMeshes,
 					std::unordered_map < uint32_t, std::unordered_map < repo::lib::RepoUUID,
 					std::vector<std::set<repo::lib::RepoUUID>>, repo::lib::RepoUUIDHasher >> &texturedMeshes);
+
+				/**
+				* Statistics of a mesh, gathered once by cacheMeshInfo()
+				*/
+				struct MeshInfo
+				{
+					uint32_t nVertices;
+					uint32_t nFaces;
+					uint32_t mFormat;
+					uint64_t nBytes; //size of the geometry once merged, per instance
+					size_t nInstances; //number of times the mesh is referenced within the scene graph
+					repo::lib::RepoUUID materialID; //unique ID of the material
+					repo::lib::RepoUUID textureID; //shared ID of the texture, if hasTexture is set
+					bool hasTexture;
+					bool isTransparent;
+				};
+
+				std::unordered_map<repo::lib::RepoUUID, MeshInfo, repo::lib::RepoUUIDHasher> meshInfo;
+				size_t maxSuperMeshSize;
+				size_t maxMergeMemory;
 			};
 		}
 	}
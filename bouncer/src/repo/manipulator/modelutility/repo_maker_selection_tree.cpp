@@ -46,6 +46,8 @@ repo::lib::PropertyTree SelectionTreeMaker::generatePTree(
 	{
 		
 		std::string idString = currentNode->getUniqueID().toString();
+		//Instanced nodes appear in the tree once per parent but are only listed in the maps once
+		const bool firstInstance = idMaps.find(idString) == idMaps.end();
 
 		repo::lib::RepoUUID sharedID = currentNode->getSharedID();
 		std::string childPath = currentPath.empty() ? idString : currentPath + "__" + idString;
@@ -130,7 +132,8 @@ repo::lib::PropertyTree SelectionTreeMaker::generatePTree(
 		{
 			tree.addToTree(REPO_LABEL_VISIBILITY_STATE, REPO_VISIBILITY_STATE_HIDDEN);
 			hiddenOnDefault = true;
-			hiddenNode.push_back(idString);
+			if (firstInstance)
+				hiddenNode.push_back(idString);
 		}
 		else if (hiddenOnDefault || hasHiddenChildren)
 		{
@@ -142,13 +145,16 @@ repo::lib::PropertyTree SelectionTreeMaker::generatePTree(
 			tree.addToTree(REPO_LABEL_VISIBILITY_STATE, REPO_VISIBILITY_STATE_SHOW);
 		}
 
-		idMaps[idString] = { name, childPath };
-		sharedIDToUniqueID.push_back({ idString, sharedID.toString() });
-		if (meshIds.size())
-			idToMeshesTree.addToTree(idString, meshIds);
-		else if (currentNode->getTypeAsEnum() == repo::core::model::NodeType::MESH){
-			std::vector<repo::lib::RepoUUID> self = { currentNode->getUniqueID() };
-			idToMeshesTree.addToTree(idString, self);
+		if (firstInstance)
+		{
+			idMaps[idString] = { name, childPath };
+			sharedIDToUniqueID.push_back({ idString, sharedID.toString() });
+			if (meshIds.size())
+				idToMeshesTree.addToTree(idString, meshIds);
+			else if (currentNode->getTypeAsEnum() == repo::core::model::NodeType::MESH){
+				std::vector<repo::lib::RepoUUID> self = { currentNode->getUniqueID() };
+				idToMeshesTree.addToTree(idString, self);
+			}
 		}
 	}
 	else
@@ -15,30 +15,58 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "repo_mesh_map_reorganiser.h"
+#include "repo_vertex_cache_optimiser.h"
 #include "../../core/model/bson/repo_bson_builder.h"
 #include "../../core/model/bson/repo_bson_factory.h"
 
+#include <algorithm>
+
 using namespace repo::manipulator::modelutility;
 
+/**
+* Reorder a range of a buffer
+* @param buffer buffer to reorder
+* @param start start of the range
+* @param newToOld index within the range of every element, by new index
+*/
+template <typename T>
+static void reorderRange(
+	std::vector<T>              &buffer,
+	const size_t                &start,
+	const std::vector<uint32_t> &newToOld)
+{
+	std::vector<T> range(buffer.begin() + start, buffer.begin() + start + newToOld.size());
+	for (size_t i = 0; i < newToOld.size(); ++i)
+		buffer[start + i] = range[newToOld[i]];
+}
+
 MeshMapReorganiser::MeshMapReorganiser(
 	const repo::core::model::MeshNode *mesh,
-	const size_t                      &vertThreshold) :
+	const size_t                      &vertThreshold,
+	const bool                        &optimiseForCache) :
 	mesh(mesh),
 	maxVertices(vertThreshold),
-	oldFaces(mesh->getFaces()),
-	oldVertices(mesh->getVertices()),
-	oldNormals(mesh->getNormals()),
-	oldUVs(mesh->getUVChannelsSeparated()),
-	oldColors(mesh->getColors()),
-	reMapSuccess(false)
+	oldFaces(mesh->getFacesView()),
+	oldVertices(mesh->getVerticesView()),
+	oldNormals(mesh->getNormalsView()),
+	oldUVs(mesh->getUVChannelsSeparatedView()),
+	oldColors(mesh->getColorsView()),
+	reMapSuccess(false),
+	orgCacheMisses(0),
+	cacheMisses(0),
+	reIndexGeneration(0)
 {
 	if (mesh && mesh->getMeshMapping().size())
 	{
-		newVertices = oldVertices;
-		newNormals = oldNormals;
-		newColors = oldColors;
-		newUVs = oldUVs;
-		newFaces.reserve(oldFaces.size());
+		//The new buffers are built by appending from the views into the mesh,
+		//they only grow beyond the original by the vertices duplicated at split boundaries
+		newVertices.reserve(oldVertices.size());
+		newNormals.reserve(oldNormals.size());
+		newColors.reserve(oldColors.size());
+		newUVs.resize(oldUVs.size());
+		for (size_t iUV = 0; iUV < oldUVs.size(); ++iUV)
+			newUVs[iUV].reserve(oldUVs[iUV].size());
+		newFaces.reserve(oldFaces.size(), 3);
 		serialisedFaces.reserve(oldFaces.size() * 3);
 		
 		if (!(reMapSuccess = performSplitting()))
@@ -55,6 +83,10 @@ MeshMapReorganiser::MeshMapReorganiser(
 			splitMap.clear();
 			idMapBuf.clear();
 		}
+		else if (optimiseForCache)
+		{
+			optimiseVertexCache();
+		}
 	
 	}
 	else
@@ -144,6 +176,33 @@ MeshMapReorganiser::getSplitMapping() const {
 	return reMapSuccess ? splitMap : std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher>();
 }
 
+std::shared_ptr<repo::core::model::MeshSplit> MeshMapReorganiser::releaseMeshSplit()
+{
+	if (!reMapSuccess)
+		return nullptr;
+
+	auto split = std::make_shared<repo::core::model::MeshSplit>();
+	split->remappedMesh = std::make_shared<repo::core::model::MeshNode>(getRemappedMesh());
+
+	//The mesh holds its own copy of the geometry, release ours
+	std::vector<repo::lib::RepoVector3D>().swap(newVertices);
+	std::vector<repo::lib::RepoVector3D>().swap(newNormals);
+	std::vector<repo_color4d_t>().swap(newColors);
+	std::vector<std::vector<repo::lib::RepoVector2D>>().swap(newUVs);
+	newFaces.clear();
+
+	split->serialisedFaces = std::move(serialisedFaces);
+	split->idMapBuf = std::move(idMapBuf);
+	split->matMap = std::move(matMap);
+	split->splitMapping = std::move(splitMap);
+	split->orgCacheMisses = orgCacheMisses;
+	split->cacheMisses = cacheMisses;
+	reMappedMappings.clear();
+	reMapSuccess = false;
+
+	return split;
+}
+
 repo::core::model::MeshNode MeshMapReorganiser::getRemappedMesh() const
 {
 	if (reMapSuccess)
@@ -176,8 +235,6 @@ bool MeshMapReorganiser::performSplitting()
 	std::vector<repo_mesh_mapping_t> newMappings;
 	std::vector<repo_mesh_mapping_t> orgMappings = mesh->getMeshMapping();
 
-	std::vector<repo_face_t> faces;
-
 	size_t subMeshVertexCount = 0;
 	size_t subMeshFaceCount = 0;
 
@@ -185,7 +242,7 @@ bool MeshMapReorganiser::performSplitting()
 	size_t totalFaceCount = 0;
 
 	size_t idMapIdx = 0;
-	size_t orgFaceIdx = 0;
+	auto orgFaceIt = oldFaces.begin();
 
 	bool finishedSubMesh = true;
 
@@ -242,7 +299,7 @@ bool MeshMapReorganiser::performSplitting()
 		if (currentMeshNumVertices > maxVertices) {
 			size_t retTotalVCount, retTotalFCount;
 			newMatMapEntry(currentSubMesh, totalVertexCount, totalFaceCount);
-			if (!splitLargeMesh(currentSubMesh, newMappings, idMapIdx, orgFaceIdx, totalVertexCount, totalFaceCount))
+			if (!splitLargeMesh(currentSubMesh, newMappings, idMapIdx, orgFaceIt, totalVertexCount, totalFaceCount))
 			{
 				return false;
 			}
@@ -253,11 +310,32 @@ bool MeshMapReorganiser::performSplitting()
 		}
 		else
 		{
+			if (currentMeshVTo > oldVertices.size())
+			{
+				repoError << "Mesh mapping refers to more vertices than the mesh contains!";
+				return false;
+			}
+
+			//The sub mesh is taken as it is
+			newVertices.insert(newVertices.end(), oldVertices.begin() + currentMeshVFrom, oldVertices.begin() + currentMeshVTo);
+			if (oldNormals.size())
+				newNormals.insert(newNormals.end(), oldNormals.begin() + currentMeshVFrom, oldNormals.begin() + currentMeshVTo);
+			if (oldColors.size())
+				newColors.insert(newColors.end(), oldColors.begin() + currentMeshVFrom, oldColors.begin() + currentMeshVTo);
+			for (size_t iUV = 0; iUV < oldUVs.size(); ++iUV)
+				newUVs[iUV].insert(newUVs[iUV].end(), oldUVs[iUV].begin() + currentMeshVFrom, oldUVs[iUV].begin() + currentMeshVTo);
+
 			newMatMapEntry(currentSubMesh, totalVertexCount, totalFaceCount);
 			for (uint32_t fIdx = 0; fIdx < currentMeshNumFaces; fIdx++)
 			{
-				repo_face_t currentFace = oldFaces[orgFaceIdx++];
-				auto        nSides = currentFace.size();
+				if (orgFaceIt == oldFaces.end())
+				{
+					repoError << "Mesh mapping refers to more faces than the mesh contains!";
+					return false;
+				}
+				auto currentFace = *orgFaceIt;
+				++orgFaceIt;
+				auto nSides = currentFace.size();
 
 				if (nSides != 3)
 				{
@@ -265,17 +343,16 @@ bool MeshMapReorganiser::performSplitting()
 				}
 				else
 				{
-					repo_face_t newFace;
-					for (const auto &indexValue : currentFace)
+					uint32_t newFace[3];
+					for (uint32_t i = 0; i < 3; ++i)
 					{
 						// Take currentMeshVFrom from Index Value to reset to zero start,
 						// then add back in the current running total to append after
 						// previous mesh.
-						auto newIdx = indexValue + (subMeshVertexCount - currentMeshVFrom);
-						newFace.push_back(newIdx);
-						serialisedFaces.push_back(newIdx);
+						newFace[i] = currentFace[i] + (subMeshVertexCount - currentMeshVFrom);
+						serialisedFaces.push_back(newFace[i]);
 					}
-					newFaces.push_back(newFace);
+					newFaces.addTriangle(newFace[0], newFace[1], newFace[2]);
 					++subMeshFaceCount;
 					++totalFaceCount;
 				}
@@ -302,21 +379,83 @@ bool MeshMapReorganiser::performSplitting()
 	return true;
 }
 
+void MeshMapReorganiser::optimiseVertexCache()
+{
+	VertexCacheOptimiser optimiser;
+	for (size_t subMeshIdx = 0; subMeshIdx < matMap.size(); ++subMeshIdx)
+	{
+		//The faces index the vertices from the start of the new sub mesh,
+		//each original sub mesh within it only uses its own range of vertices
+		const size_t subMeshVFrom = reMappedMappings[subMeshIdx].vertFrom;
+		for (const auto &orgSubMesh : matMap[subMeshIdx])
+		{
+			const size_t vFrom = orgSubMesh.vertFrom;
+			const size_t localVFrom = vFrom - subMeshVFrom;
+			const size_t nVertices = orgSubMesh.vertTo - orgSubMesh.vertFrom;
+			const size_t nFaces = orgSubMesh.triTo - orgSubMesh.triFrom;
+			if (!nFaces)
+				continue;
+
+			uint16_t *faces = &serialisedFaces[orgSubMesh.triFrom * 3];
+			bool inRange = true;
+			for (size_t i = 0; i < nFaces * 3 && inRange; ++i)
+				inRange = faces[i] >= localVFrom && faces[i] < localVFrom + nVertices;
+
+			if (!inRange)
+			{
+				repoWarning << "Faces of sub mesh " << orgSubMesh.mesh_id << " use vertices of other sub meshes, skipping vertex cache optimisation";
+				const uint64_t nMisses = optimiser.countCacheMisses(faces, nFaces, *std::max_element(faces, faces + nFaces * 3) + 1);
+				orgCacheMisses += nMisses;
+				cacheMisses += nMisses;
+				continue;
+			}
+
+			for (size_t i = 0; i < nFaces * 3; ++i)
+				faces[i] -= localVFrom;
+
+			orgCacheMisses += optimiser.countCacheMisses(faces, nFaces, nVertices);
+			optimiser.reorderFaces(faces, nFaces, &newVertices[vFrom], nVertices);
+			auto newToOld = optimiser.reorderVertices(faces, nFaces, nVertices);
+			cacheMisses += optimiser.countCacheMisses(faces, nFaces, nVertices);
+
+			for (size_t i = 0; i < nFaces * 3; ++i)
+				faces[i] += localVFrom;
+
+			//The id map is constant within an original sub mesh, so it is left as it is
+			reorderRange(newVertices, vFrom, newToOld);
+			if (newNormals.size())
+				reorderRange(newNormals, vFrom, newToOld);
+			if (newColors.size())
+				reorderRange(newColors, vFrom, newToOld);
+			for (auto &uvChannel : newUVs)
+			{
+				if (uvChannel.size())
+					reorderRange(uvChannel, vFrom, newToOld);
+			}
+		}
+	}
+
+	//Rebuild the faces of the mesh from the reordered buffer
+	newFaces.clear();
+	newFaces.reserve(serialisedFaces.size() / 3, 3);
+	for (size_t i = 0; i < serialisedFaces.size(); i += 3)
+		newFaces.addTriangle(serialisedFaces[i], serialisedFaces[i + 1], serialisedFaces[i + 2]);
+
+	if (serialisedFaces.size())
+	{
+		repoTrace << "Vertex cache misses per face: " << (float)orgCacheMisses / (serialisedFaces.size() / 3)
+			<< " -> " << (float)cacheMisses / (serialisedFaces.size() / 3);
+	}
+}
+
 bool MeshMapReorganiser::splitLargeMesh(
 	const repo_mesh_mapping_t        &currentSubMesh,
 	std::vector<repo_mesh_mapping_t> &newMappings,
 	size_t                           &idMapIdx,
-	size_t                           &orgFaceIdx,
+	repo::lib::RepoFaceStreamView::const_iterator &orgFaceIt,
 	size_t                           &totalVertexCount,
 	size_t                           &totalFaceCount)
 {
-	std::unordered_map<uint32_t, uint32_t> reIndexMap;
-	std::vector<repo::lib::RepoVector3D> reMappedVertices, reMappedNormals;
-	std::vector<repo_color4d_t> reMappedCols;
-	std::vector<std::vector<repo::lib::RepoVector2D>> reMappedUVs;
-	if (oldUVs.size())
-		reMappedUVs.resize(oldUVs.size());
-
 	auto currentMeshVFrom = currentSubMesh.vertFrom;
 	auto currentMeshVTo = currentSubMesh.vertTo;
 	auto currentMeshTFrom = currentSubMesh.triFrom;
@@ -325,8 +464,21 @@ bool MeshMapReorganiser::splitLargeMesh(
 	auto currentMeshNumVertices = currentMeshVTo - currentMeshVFrom;
 	auto currentMeshNumFaces = currentMeshTTo - currentMeshTFrom;
 
-	//When split mesh is called, it's guaranteed that a new mesh mapping has been created for it
-	auto newVerticesVFrom = newMappings.back().vertFrom;
+	if (currentMeshVTo > oldVertices.size())
+	{
+		repoError << "Mesh mapping refers to more vertices than the mesh contains!";
+		return false;
+	}
+
+	//The faces of a sub mesh only index its own vertices, so the remapping is a flat table
+	//over that range. An entry is only valid if it was written within the current split,
+	//so starting a new split is a bump of the generation instead of clearing the table.
+	if (reIndexTable.size() < currentMeshNumVertices)
+	{
+		reIndexTable.resize(currentMeshNumVertices);
+		reIndexTableGen.resize(currentMeshNumVertices, reIndexGeneration);
+	}
+	++reIndexGeneration;
 
 	const bool hasNormal = oldNormals.size();
 	const bool hasColor = oldColors.size();
@@ -339,13 +491,17 @@ bool MeshMapReorganiser::splitLargeMesh(
 	std::vector<float> bboxMin;
 	std::vector<float> bboxMax;
 
-	size_t totalLargeMeshVertexCount = 0;
-
 	// Perform quick and dirty splitting algorithm
 	// Loop over all faces in the giant mesh
 	for (uint32_t fIdx = 0; fIdx < currentMeshNumFaces; ++fIdx) {
-		repo_face_t currentFace = oldFaces[orgFaceIdx++];
-		auto        nSides = currentFace.size();
+		if (orgFaceIt == oldFaces.end())
+		{
+			repoError << "Mesh mapping refers to more faces than the mesh contains!";
+			return false;
+		}
+		auto currentFace = *orgFaceIt;
+		++orgFaceIt;
+		auto nSides = currentFace.size();
 		if (nSides != 3)
 		{
 			repoError << "Non triangulated face with " << nSides << " vertices.";
@@ -371,7 +527,6 @@ bool MeshMapReorganiser::splitLargeMesh(
 
 				totalVertexCount += splitMeshVertexCount;
 				totalFaceCount += splitMeshFaceCount;
-				totalLargeMeshVertexCount += splitMeshVertexCount;
 				startedLargeMeshSplit = true;
 				newMappings.resize(newMappings.size() + 1);
 
@@ -379,50 +534,54 @@ bool MeshMapReorganiser::splitLargeMesh(
 				newMatMapEntry(currentSubMesh, totalVertexCount, totalFaceCount);
 				splitMeshVertexCount = 0;
 				splitMeshFaceCount = 0;
-				reIndexMap.clear();
+				++reIndexGeneration;
 			}//if (((splitMeshVertexCount + nSides) > maxVertices) || !startedLargeMeshSplit)
 
-			repo_face_t newFace;
-			for (const auto &indexValue : currentFace)
+			uint32_t newFace[3];
+			for (uint32_t i = 0; i < 3; ++i)
 			{
-				const auto it = reIndexMap.find(indexValue);
-				if (it == reIndexMap.end())
+				const auto indexValue = currentFace[i];
+				if (indexValue < currentMeshVFrom || indexValue >= currentMeshVTo)
+				{
+					repoError << "Face index (" << indexValue << ") is outside of the sub mesh's vertices ["
+						<< currentMeshVFrom << ", " << currentMeshVTo << ")";
+					return false;
+				}
+
+				const auto localIndex = indexValue - currentMeshVFrom;
+				if (reIndexTableGen[localIndex] != reIndexGeneration)
 				{
-					reIndexMap[indexValue] = splitMeshVertexCount;
-					repo::lib::RepoVector3D vertex = oldVertices[indexValue];
-					reMappedVertices.push_back(vertex);
+					reIndexTableGen[localIndex] = reIndexGeneration;
+					reIndexTable[localIndex] = splitMeshVertexCount;
+
+					const repo::lib::RepoVector3D &vertex = oldVertices[indexValue];
+					newVertices.push_back(vertex);
 
 					if (hasNormal)
 					{
-						reMappedNormals.push_back(oldNormals[indexValue]);
+						newNormals.push_back(oldNormals[indexValue]);
 					}
 
 					if (hasColor)
 					{
-						reMappedCols.push_back(oldColors[indexValue]);
+						newColors.push_back(oldColors[indexValue]);
 					}
 
 					if (hasUV)
 					{
 						for (int iUV = 0; iUV < oldUVs.size(); ++iUV)
-							reMappedUVs[iUV].push_back(oldUVs[iUV][indexValue]);
+							newUVs[iUV].push_back(oldUVs[iUV][indexValue]);
 					}
 
 					updateBoundingBoxes(bboxMin, bboxMax, vertex, vertex);
 					splitMeshVertexCount++;
 				}
-				if (splitMeshVertexCount < reIndexMap[indexValue])
-				{
-					repoError << "SplitMesh Vertex count(" << splitMeshVertexCount << ") "
-						<< "is smaller than remapped index value(" << reIndexMap[indexValue] << ") -  potentially out of range.";
-					return false;
-				}
 
-				newFace.push_back(reIndexMap[indexValue]);
-				serialisedFaces.push_back(reIndexMap[indexValue]);
-			}//for (const auto &indexValue : currentFace)
+				newFace[i] = reIndexTable[localIndex];
+				serialisedFaces.push_back(newFace[i]);
+			}//for (uint32_t i = 0; i < 3; ++i)
 
-			newFaces.push_back(newFace);
+			newFaces.addTriangle(newFace[0], newFace[1], newFace[2]);
 			splitMeshFaceCount++;
 		}//else nSides != 3
 		
@@ -430,90 +589,8 @@ bool MeshMapReorganiser::splitLargeMesh(
 
 	updateIDMapArray(splitMeshVertexCount, idMapIdx);
 	totalVertexCount += splitMeshVertexCount;
-	totalLargeMeshVertexCount += splitMeshVertexCount;
 	totalFaceCount += splitMeshFaceCount;
 
-	if (currentMeshNumVertices > totalLargeMeshVertexCount)
-	{
-		auto leftOverVertices = currentMeshNumVertices - totalLargeMeshVertexCount;
-
-		auto startingPos = newVertices.begin() + newMappings.back().vertFrom + splitMeshVertexCount;
-
-		//Chop out the unwanted vertices
-		newVertices.erase(startingPos, startingPos + leftOverVertices);
-		if (hasNormal)
-		{
-			auto startingPosN = newNormals.begin() + newMappings.back().vertFrom + splitMeshVertexCount;
-			newNormals.erase(startingPosN, startingPosN + leftOverVertices);
-		}
-
-		if (hasColor)
-		{
-			auto startingPosN = newColors.begin() + newMappings.back().vertFrom + splitMeshVertexCount;
-			newColors.erase(startingPosN, startingPosN + leftOverVertices);
-		}
-
-		if (hasUV)
-		{
-			for (int iUV = 0; iUV < oldUVs.size(); ++iUV)
-			{
-				auto startingPosN = newUVs[iUV].begin() + newMappings.back().vertFrom + splitMeshVertexCount;
-				newUVs[iUV].erase(startingPosN, startingPosN + leftOverVertices);
-			}
-		}
-	}
-	else if (currentMeshNumVertices < totalLargeMeshVertexCount)
-	{
-		auto extraVertices = totalLargeMeshVertexCount - currentMeshNumVertices;
-		auto startingPos = newVertices.begin() + newVerticesVFrom;
-
-		//Expand newVertices to include the extra vertices
-		std::vector<repo::lib::RepoVector3D> extraVs;
-		extraVs.resize(extraVertices);
-		newVertices.insert(startingPos, extraVs.begin(), extraVs.end());
-		if (hasNormal)
-		{
-			auto startingPosN = newNormals.begin() + newVerticesVFrom;
-			newNormals.insert(startingPosN, extraVs.begin(), extraVs.end());
-		}
-
-		if (hasColor)
-		{
-			auto startingPosN = newColors.begin() + newVerticesVFrom;
-			std::vector<repo_color4d_t> extras;
-			extras.resize(extraVertices);
-			newColors.insert(startingPosN, extras.begin(), extras.end());
-
-		}
-
-		if (hasUV)
-		{
-			for (int iUV = 0; iUV < oldUVs.size(); ++iUV)
-			{
-				auto startingPosN = newUVs[iUV].begin() + newVerticesVFrom;
-				std::vector<repo::lib::RepoVector2D> extras;
-				extras.resize(extraVertices);
-				newUVs[iUV].insert(startingPosN, extras.begin(), extras.end());
-			}
-		}
-	}
-
-
-
-	//Modify the vertices as it may be rearranged within this region
-	std::copy(reMappedVertices.begin(), reMappedVertices.end(), newVertices.begin() + newVerticesVFrom);
-	if (hasNormal)
-		std::copy(reMappedNormals.begin(), reMappedNormals.end(), newNormals.begin() + newVerticesVFrom);
-
-	if (hasUV)
-		for (int iUV = 0; iUV < oldUVs.size(); ++iUV)
-			std::copy(reMappedUVs[iUV].begin(), reMappedUVs[iUV].end(), newUVs[iUV].begin() + newVerticesVFrom);
-
-	if (hasColor)
-		std::copy(reMappedCols.begin(), reMappedCols.end(), newColors.begin() + newVerticesVFrom);
-
-
-
 	splitMap[currentSubMesh.mesh_id].push_back(newMappings.size() - 1);
 	finishSubMesh(newMappings.back(), bboxMin, bboxMax, splitMeshVertexCount, splitMeshFaceCount);
 	completeLastMatMapEntry(matMap.back().back().vertFrom + splitMeshVertexCount,
@@ -15,8 +15,10 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <memory>
 #include <unordered_map>
 #include "../../core/model/bson/repo_node_mesh.h"
+#include "../../core/model/collection/repo_mesh_split_cache.h"
 
 namespace repo{
 	namespace manipulator{
@@ -30,10 +32,12 @@ namespace repo{
 				* a remapped mesh, it will return an empty meshNode.
 				* @param mesh the mesh to reorganise
 				* @param vertThreshold maximum vertices
+				* @param optimiseForCache reorder the faces and vertices of every sub mesh for the vertex cache
 				*/
 				MeshMapReorganiser(
 					const repo::core::model::MeshNode *mesh,
-					const size_t                        &vertThreshold);
+					const size_t                        &vertThreshold,
+					const bool                          &optimiseForCache = true);
 				~MeshMapReorganiser();
 
 				/**
@@ -66,6 +70,14 @@ namespace repo{
 				*/
 				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> getSplitMapping() const;
 
+				/**
+				* Hand over all the results of the reorganisation at once
+				* The buffers are moved rather than copied, so the reorganiser
+				* holds no results afterwards
+				* @return returns the results, nullptr if the remapping failed
+				*/
+				std::shared_ptr<repo::core::model::MeshSplit> releaseMeshSplit();
+
 			private:
 				/**
 				* Complete a submesh by filling in the ending parts of  mesh mapping
@@ -102,13 +114,20 @@ namespace repo{
 				*/
 				bool performSplitting();
 
+				/**
+				* Reorder the faces and vertices of every original sub mesh
+				* within the new sub meshes for the vertex cache
+				* The ranges of the mappings are unchanged
+				*/
+				void optimiseVertexCache();
+
 				/**
 				* Split a single large sub mesh that exceeds the number of
 				* vertices into multiple sub meshes
 				* @param currentSubMesh current sub mesh's mapping
 				* @param newMappings current load of new mappings (consume and update)
 				* @param idMapIdx idMap index value           (consume and update)
-				* @param orgFaceIdx current face index        (consume and update)
+				* @param orgFaceIt current face               (consume and update)
 				* @param totalVertexCount total vertice count (consume and update)
 				* @param totalFaceCount total face count      (consume and update)
 				*/
@@ -116,7 +135,7 @@ namespace repo{
 					const repo_mesh_mapping_t        &currentSubMesh,
 					std::vector<repo_mesh_mapping_t> &newMappings,
 					size_t                           &idMapIdx,
-					size_t                           &orgFaceIdx,
+					repo::lib::RepoFaceStreamView::const_iterator &orgFaceIt,
 					size_t                           &totalVertexCount,
 					size_t                           &totalFaceCount);
 
@@ -162,24 +181,32 @@ namespace repo{
 
 				const repo::core::model::MeshNode *mesh;
 				const size_t maxVertices;
-				const std::vector<repo::lib::RepoVector3D> oldVertices;
-				const std::vector<repo::lib::RepoVector3D> oldNormals;
-				const std::vector<std::vector<repo::lib::RepoVector2D>> oldUVs;
-				const std::vector<repo_face_t>   oldFaces;
-				const std::vector<repo_color4d_t>   oldColors;
+				//views into the original mesh's buffers, valid as long as the mesh is
+				const repo::lib::RepoArrayView<repo::lib::RepoVector3D> oldVertices;
+				const repo::lib::RepoArrayView<repo::lib::RepoVector3D> oldNormals;
+				const std::vector<repo::lib::RepoArrayView<repo::lib::RepoVector2D>> oldUVs;
+				const repo::lib::RepoFaceStreamView   oldFaces;
+				const repo::lib::RepoArrayView<repo_color4d_t>   oldColors;
 
 				std::vector<repo::lib::RepoVector3D> newVertices;
 				std::vector<repo::lib::RepoVector3D> newNormals;
-				std::vector<repo_face_t>   newFaces;
+				repo::lib::RepoFaceBuffer   newFaces;
 				std::vector<repo_color4d_t>   newColors;
 				std::vector<std::vector<repo::lib::RepoVector2D>> newUVs;
 
 				std::vector<uint16_t> serialisedFaces;
+				uint64_t orgCacheMisses; //vertex cache misses of serialisedFaces before optimiseVertexCache()
+				uint64_t cacheMisses; //vertex cache misses of serialisedFaces
 
 				std::vector<std::vector<float>> idMapBuf;
 				std::unordered_map<repo::lib::RepoUUID, std::vector<uint32_t>, repo::lib::RepoUUIDHasher> splitMap;
 				std::vector<std::vector<repo_mesh_mapping_t>> matMap;
 				std::vector<repo_mesh_mapping_t> reMappedMappings;
+
+				//remapping of a large sub mesh's vertices into the current split, reused between sub meshes
+				std::vector<uint32_t> reIndexTable; //new index, by vertex index from the start of the sub mesh
+				std::vector<uint32_t> reIndexTableGen; //generation each entry of reIndexTable was written in
+				uint32_t reIndexGeneration;
 			};
 		}
 	}
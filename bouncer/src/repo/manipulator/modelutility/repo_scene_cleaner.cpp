@@ -16,9 +16,12 @@
 */
 #include "repo_scene_cleaner.h"
 #include "../../core/model/bson/repo_node_revision.h"
+#include "../../core/model/bson/repo_node_mesh.h"
 #include "../../core/model/collection/repo_scene.h"
 #include "repo_scene_manager.h"
 
+#include <algorithm>
+
 using namespace repo::manipulator::modelutility;
 
 SceneCleaner::SceneCleaner(
@@ -114,7 +117,7 @@ std::vector<repo::core::model::RepoBSON> SceneCleaner::getIncompleteRevisions()
 	return handler->findAllByCriteria(dbName, projectName + "." + REPO_COLLECTION_HISTORY, criteria);
 }
 
-void SceneCleaner::removeAllGridFSReference(
+std::vector<std::pair<std::string, std::string>> SceneCleaner::getGridFSReferences(
 	const repo::core::model::RepoBSON &criteria
 	)
 {
@@ -122,13 +125,76 @@ void SceneCleaner::removeAllGridFSReference(
 	const std::string collection = projectName + "." + REPO_COLLECTION_SCENE;
 	auto results = handler->findAllByCriteria(dbName, collection, criteria);
 
+	std::vector<std::pair<std::string, std::string>> files;
+	std::set<std::string> seen;
 	for (const auto &res : results)
 	{
 		auto node = repo::core::model::RepoNode(res);
-		auto fnames = node.getFileList();
-		std::string errMsg;
-		for (const auto fname : fnames)
-			handler->dropRawFile(dbName, collection, fname.second, errMsg);
+		for (const auto &fname : node.getFileList())
+		{
+			if (seen.insert(fname.second).second)
+				files.push_back(fname);
+		}
+	}
+	return files;
+}
+
+void SceneCleaner::removeUnreferencedGridFSFiles(
+	const std::string                                      &collection,
+	const std::vector<std::pair<std::string, std::string>> &files)
+{
+	//Files named after their geometry are skipped by imports that find them already stored,
+	//dropping one here could race with such an import, so only the other files are considered
+	std::vector<std::pair<std::string, std::string>> candidates;
+	for (const auto &fname : files)
+	{
+		if (repo::core::model::MeshNode::isGeometryFileName(fname.second))
+			repoTrace << fname.second << " is named after its geometry, leaving it to an offline sweep";
+		else
+			candidates.push_back(fname);
+	}
+
+	//gridFS buckets belong to a collection, so only documents of that collection can refer to its files
+	const std::string fullCollection = projectName + "." + collection;
+	const size_t filesPerQuery = 500;
+	const repo::core::model::RepoBSON projection = BSON(REPO_LABEL_OVERSIZED_FILES << 1);
+
+	std::set<std::string> inUse;
+	for (size_t start = 0; start < candidates.size(); start += filesPerQuery)
+	{
+		mongo::BSONArrayBuilder references;
+		const size_t end = std::min(candidates.size(), start + filesPerQuery);
+		for (size_t i = start; i < end; ++i)
+			references << BSON(std::string(REPO_LABEL_OVERSIZED_FILES) + "." + candidates[i].first << candidates[i].second);
+		repo::core::model::RepoBSON criteria = BSON("$or" << references.arr());
+
+		bool success = handler->findAllByCriteria(dbName, fullCollection, criteria,
+			[&inUse](std::vector<repo::core::model::RepoBSON> &batch)
+		{
+			for (const auto &bson : batch)
+			{
+				for (const auto &fname : bson.getFileList())
+					inUse.insert(fname.second);
+			}
+			return true;
+		}, projection);
+
+		if (!success)
+		{
+			//Without knowing what is referenced, removing anything may break another revision
+			repoError << "Failed to look up references to gridFS files in " << fullCollection
+				<< ", no files are removed";
+			return;
+		}
+	}
+
+	std::string errMsg;
+	for (const auto &fname : candidates)
+	{
+		if (inUse.find(fname.second) == inUse.end())
+			handler->dropRawFile(dbName, fullCollection, fname.second, errMsg);
+		else
+			repoTrace << fname.second << " is still in use, not removing";
 	}
 }
 
@@ -141,12 +207,14 @@ bool SceneCleaner::removeRevision(
 	//find and delete all gridfs entries
 	//FIXME: it's not easy to keep the bsonarray as array. need to construct it into a embedded bson (or we need to inherit mongo::bsonarray)
 	auto gridFSCriteria = BSON(REPO_NODE_LABEL_ID << BSON("$in" << currentField) << REPO_LABEL_OVERSIZED_FILES << BSON("$exists" << true));
-	removeAllGridFSReference(gridFSCriteria);
+	auto gridFSFiles = getGridFSReferences(gridFSCriteria);
 
 	repo::core::model::RepoBSON criteria = BSON(REPO_NODE_LABEL_ID << BSON("$in" << currentField));
 	std::string errMsg;
 	//clean up scene
 	handler->dropDocuments(criteria, dbName, projectName + "." + REPO_COLLECTION_SCENE, errMsg);
+	//files are removed once the documents are gone, so shared ones are only removed by their last user
+	removeUnreferencedGridFSFiles(REPO_COLLECTION_SCENE, gridFSFiles);
 
 	//remove the original files attached to the revision
 	auto orgFileNames = revNode.getOrgFiles();
@@ -60,11 +60,25 @@ namespace repo{
 				std::vector<repo::core::model::RepoBSON> getIncompleteRevisions();
 
 				/**
-				* Given a list of IDs in BSON format, find all of its gridFS references and
-				* remove them
+				* Find all gridFS files referenced by the scene documents matching the criteria
+				* @param criteria criteria to match
+				* @return returns a list of <field, file name> pairs
 				*/
-				void removeAllGridFSReference(
-					const repo::core::model::RepoBSON &idArray);
+				std::vector<std::pair<std::string, std::string>> getGridFSReferences(
+					const repo::core::model::RepoBSON &criteria);
+
+				/**
+				* Remove the given gridFS files from the bucket of a collection unless
+				* a document of that collection still refers to them. Files named after
+				* their geometry are never removed: an import may be about to reuse them
+				* without uploading them again, so they are left to an offline sweep.
+				* Nothing is removed if the references cannot be looked up.
+				* @param collection collection (without the project name) owning the bucket
+				* @param files list of <field, file name> pairs
+				*/
+				void removeUnreferencedGridFSFiles(
+					const std::string                                      &collection,
+					const std::vector<std::pair<std::string, std::string>> &files);
 
 				/**
 				* Remove the revision given from the database
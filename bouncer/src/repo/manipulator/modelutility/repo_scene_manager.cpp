@@ -16,8 +16,10 @@
 */
 #include "repo_scene_manager.h"
 
+#include "../../core/handler/repo_commit_pipeline.h"
 #include "../../core/model/bson/repo_bson_builder.h"
 #include "../modeloptimizer/repo_optimizer_multipart.h"
+#include "../modelconvertor/export/repo_model_export_asset.h"
 #include "../modelconvertor/export/repo_model_export_gltf.h"
 #include "../modelconvertor/export/repo_model_export_src.h"
 #include "../modeloptimizer/repo_optimizer_multipart.h"
@@ -32,40 +34,42 @@ bool SceneManager::commitWebBuffers(
 	repo::core::handler::AbstractDatabaseHandler *handler,
 	const bool                                    addTimestampToSettings)
 {
-	bool success = true;
-	std::string jsonStashExt = scene->getJSONExtension();
-	//Upload the files
-	for (const auto &bufferPair : resultBuffers.geoFiles)
+	const std::string databaseName = scene->getDatabaseName();
+	const std::string geoCollection = scene->getProjectName() + "." + geoStashExt;
+	const std::string jsonCollection = scene->getProjectName() + "." + scene->getJSONExtension();
+
+	//Upload the files concurrently. The revision status is only updated
+	//once every file has been written.
+	repo::core::handler::CommitPipeline pipeline(handler);
+	auto uploadFile = [&](const std::string &collection, const std::string &fileName, const std::vector<uint8_t> &buffer)
 	{
-		std::string errMsg;
-		if (success &= handler->insertRawFile(scene->getDatabaseName(), scene->getProjectName() + "." + geoStashExt, bufferPair.first, bufferPair.second,
-			errMsg))
+		pipeline.push([&](
+			repo::core::handler::AbstractDatabaseHandler *handler, std::string &errMsg)
 		{
-			repoInfo << "File (" << bufferPair.first << ") added successfully.";
-		}
-		else
-		{
-			repoError << "Failed to add file  (" << bufferPair.first << "): " << errMsg;
-		}
+			if (handler->insertRawFile(databaseName, collection, fileName, buffer, errMsg))
+			{
+				repoInfo << "File (" << fileName << ") added successfully.";
+				return true;
+			}
+
+			repoError << "Failed to add file  (" << fileName << "): " << errMsg;
+			return false;
+		});
+	};
+
+	for (const auto &bufferPair : resultBuffers.geoFiles)
+	{
+		uploadFile(geoCollection, bufferPair.first, bufferPair.second);
 	}
 
 	for (const auto &bufferPair : resultBuffers.jsonFiles)
 	{
-		std::string databaseName = scene->getDatabaseName();
-		std::string projectName = scene->getProjectName();
-		std::string errMsg;
-		std::string fileName = bufferPair.first;
-		if (success &= handler->insertRawFile(scene->getDatabaseName(), scene->getProjectName() + "." + jsonStashExt, fileName, bufferPair.second,
-			errMsg))
-		{
-			repoInfo << "File (" << fileName << ") added successfully.";
-		}
-		else
-		{
-			repoError << "Failed to add file  (" << fileName << "): " << errMsg;
-		}
+		uploadFile(jsonCollection, bufferPair.first, bufferPair.second);
 	}
 
+	std::string errMsg;
+	bool success = pipeline.finish(errMsg);
+
 	if (success)
 	{
 		scene->updateRevisionStatus(handler, repo::core::model::RevisionNode::UploadStatus::COMPLETE);
@@ -89,7 +93,8 @@ repo::core::model::RepoScene* SceneManager::fetchScene(
 	const repo::lib::RepoUUID                                &uuid,
 	const bool                                    &headRevision,
 	const bool                                    &lightFetch,
-	const bool                                    &ignoreRefScenes)
+	const bool                                    &ignoreRefScenes,
+	const repo::core::model::RepoScene::LoadProfile &profile)
 {
 	repo::core::model::RepoScene* scene = nullptr;
 	if (handler)
@@ -101,6 +106,7 @@ repo::core::model::RepoScene* SceneManager::fetchScene(
 		{
 			if(ignoreRefScenes)
 				scene->ignoreReferenceScene();
+			scene->setLoadProfile(profile);
 			if (headRevision)
 				scene->setBranch(uuid);
 			else
@@ -139,7 +145,14 @@ repo::core::model::RepoScene* SceneManager::fetchScene(
 					{
 						repoTrace << "Loaded Scene";
 
-						if (scene->loadStash(handler, errMsg))
+						//The stash is of no use without its geometry
+						const bool needStash = profile == repo::core::model::RepoScene::LoadProfile::FULL
+							|| profile == repo::core::model::RepoScene::LoadProfile::GEOMETRY;
+						if (!needStash)
+						{
+							repoTrace << "Stash not needed for this load profile";
+						}
+						else if (scene->loadStash(handler, errMsg))
 						{
 							repoTrace << "Stash Loaded";
 						}
@@ -216,7 +229,9 @@ void SceneManager::fetchScene(
 
 bool SceneManager::generateStashGraph(
 	repo::core::model::RepoScene              *scene,
-	repo::core::handler::AbstractDatabaseHandler *handler
+	repo::core::handler::AbstractDatabaseHandler *handler,
+	const size_t                              &maxSuperMeshSize,
+	const size_t                              &maxMergeMemory
 	)
 {
 	bool success = false;
@@ -231,8 +246,10 @@ bool SceneManager::generateStashGraph(
 		}
 
 		removeStashGraph(scene, handler);
+		if (handler)
+			scene->prefetchBinaries(repo::core::model::RepoScene::GraphType::DEFAULT, handler->connectionLimit());
 		repoInfo << "Generating stash graph...";
-		repo::manipulator::modeloptimizer::MultipartOptimizer mpOpt;
+		repo::manipulator::modeloptimizer::MultipartOptimizer mpOpt(maxSuperMeshSize, maxMergeMemory);
 		if (success = mpOpt.apply(scene))
 		{
 			if (toCommit)
@@ -265,14 +282,18 @@ bool SceneManager::generateWebViewBuffers(
 	repo::core::model::RepoScene                 *scene,
 	const repo::manipulator::modelconvertor::WebExportType          &exType,
 	repo_web_buffers_t                           &resultBuffers,
-	repo::core::handler::AbstractDatabaseHandler *handler)
+	repo::core::handler::AbstractDatabaseHandler *handler,
+	repo::core::model::MeshSplitCache            *splitCache)
 {
 	bool success = false;
 	if (success = (scene&& scene->isRevisioned()))
 	{
 		bool toCommit = handler;
 		if (toCommit)
+		{
 			scene->updateRevisionStatus(handler, repo::core::model::RevisionNode::UploadStatus::GEN_WEB_STASH);
+			scene->prefetchBinaries(scene->getViewGraph(), handler->connectionLimit());
+		}
 
 		std::string geoStashExt;
 		std::string jsonStashExt = scene->getJSONExtension();
@@ -281,22 +302,30 @@ bool SceneManager::generateWebViewBuffers(
 		{
 		case repo::manipulator::modelconvertor::WebExportType::GLTF:
 			geoStashExt = scene->getGLTFExtension();
-			resultBuffers = generateGLTFBuffer(scene);
+			resultBuffers = generateGLTFBuffer(scene, splitCache);
 			break;
 		case repo::manipulator::modelconvertor::WebExportType::SRC:
 			geoStashExt = scene->getSRCExtension();
-			resultBuffers = generateSRCBuffer(scene);
+			resultBuffers = generateSRCBuffer(scene, splitCache);
+			break;
+		case repo::manipulator::modelconvertor::WebExportType::UNITY:
+			geoStashExt = scene->getUnityExtension();
+			resultBuffers = generateAssetBuffer(scene, handler && isVrEnabled(scene, handler), splitCache);
 			break;
 		default:
 			repoError << "Unknown export type with enum:  " << (uint16_t)exType;
 			return false;
 		}
 
-		if (success = resultBuffers.geoFiles.size())
+		//Unity asset bundles are generated elsewhere, only their descriptors are produced here
+		if (success = exType == repo::manipulator::modelconvertor::WebExportType::UNITY ?
+			resultBuffers.jsonFiles.size() : resultBuffers.geoFiles.size())
 		{
 			if (toCommit)
 			{
-				success = commitWebBuffers(scene, geoStashExt, resultBuffers, handler);
+				//Asset bundle descriptors are committed the same way as by commitAssetBundleBuffers
+				const bool addTimestampToSettings = exType == repo::manipulator::modelconvertor::WebExportType::UNITY;
+				success = commitWebBuffers(scene, geoStashExt, resultBuffers, handler, addTimestampToSettings);
 			}
 		}
 		else
@@ -313,10 +342,11 @@ bool SceneManager::generateWebViewBuffers(
 }
 
 repo_web_buffers_t SceneManager::generateGLTFBuffer(
-	repo::core::model::RepoScene *scene)
+	repo::core::model::RepoScene      *scene,
+	repo::core::model::MeshSplitCache *splitCache)
 {
 	repo_web_buffers_t result;
-	repo::manipulator::modelconvertor::GLTFModelExport gltfExport(scene);
+	repo::manipulator::modelconvertor::GLTFModelExport gltfExport(scene, splitCache);
 	if (gltfExport.isOk())
 	{
 		repoTrace << "Conversion succeed.. exporting as buffer..";
@@ -379,10 +409,11 @@ bool SceneManager::generateAndCommitSelectionTree(
 }
 
 repo_web_buffers_t SceneManager::generateSRCBuffer(
-	repo::core::model::RepoScene *scene)
+	repo::core::model::RepoScene      *scene,
+	repo::core::model::MeshSplitCache *splitCache)
 {
 	repo_web_buffers_t result;
-	repo::manipulator::modelconvertor::SRCModelExport srcExport(scene);
+	repo::manipulator::modelconvertor::SRCModelExport srcExport(scene, splitCache);
 	if (srcExport.isOk())
 	{
 		repoTrace << "Conversion succeed.. exporting as buffer..";
@@ -394,6 +425,24 @@ repo_web_buffers_t SceneManager::generateSRCBuffer(
 	return result;
 }
 
+repo_web_buffers_t SceneManager::generateAssetBuffer(
+	repo::core::model::RepoScene      *scene,
+	const bool                         vrEnabled,
+	repo::core::model::MeshSplitCache *splitCache)
+{
+	repo_web_buffers_t result;
+	repo::manipulator::modelconvertor::AssetModelExport assetExport(scene, vrEnabled, splitCache);
+	if (assetExport.isOk())
+	{
+		repoTrace << "Conversion succeed.. exporting as buffer..";
+		result = assetExport.getAllFilesExportedAsBuffer();
+	}
+	else
+		repoError << "Export to Unity assets failed.";
+
+	return result;
+}
+
 bool SceneManager::isVrEnabled(
 	const repo::core::model::RepoScene                 *scene,
 	repo::core::handler::AbstractDatabaseHandler *handler) const
@@ -18,6 +18,7 @@
 #include "../../core/model/collection/repo_scene.h"
 #include "../../core/handler/repo_database_handler_abstract.h"
 #include "../modelconvertor/export/repo_model_export_web.h"
+#include "../modeloptimizer/repo_optimizer_multipart.h"
 
 namespace repo{
 	namespace manipulator{
@@ -53,6 +54,8 @@ namespace repo{
 				* @param headRevision true if retrieving head revision
 				* @param lightFetch fetches only the stash (or scene if stash failed),
 				reduce computation and memory usage (ideal for visualisation only)
+				* @param profile which fields of the nodes to load, the stash is
+				*                only loaded with FULL or GEOMETRY (see RepoScene::LoadProfile)
 				* @return returns a pointer to a repoScene.
 				*/
 				repo::core::model::RepoScene* fetchScene(
@@ -62,7 +65,8 @@ namespace repo{
 					const repo::lib::RepoUUID                                &uuid,
 					const bool                                    &headRevision = true,
 					const bool                                    &lightFetch = false,
-					const bool                                    &ignoreRefScenes = false);
+					const bool                                    &ignoreRefScenes = false,
+					const repo::core::model::RepoScene::LoadProfile &profile = repo::core::model::RepoScene::LoadProfile::FULL);
 
 				repo::core::model::RepoScene* fetchScene(
 					repo::core::handler::AbstractDatabaseHandler *handler,
@@ -103,11 +107,15 @@ namespace repo{
 				* it will commit the stash to database
 				* @param scene scene to generate stash graph for
 				* @param handler hander to the database
+				* @param maxSuperMeshSize memory budget (in bytes) of a merged mesh
+				* @param maxMergeMemory memory budget (in bytes) of all the meshes merged at once
 				* @return returns true upon success
 				*/
 				bool generateStashGraph(
 					repo::core::model::RepoScene                 *scene,
-					repo::core::handler::AbstractDatabaseHandler *handler = nullptr
+					repo::core::handler::AbstractDatabaseHandler *handler = nullptr,
+					const size_t                                 &maxSuperMeshSize = REPO_MP_MAX_SUPERMESH_SIZE,
+					const size_t                                 &maxMergeMemory = REPO_MP_MAX_MERGE_MEMORY
 					);
 
 				/**
@@ -129,13 +137,17 @@ namespace repo{
 				* This requires the repo stash to have been generated already
 				* @param scene the scene to generate the src encoding from
 				* @param exType the type of export it is
+				* @param splitCache cache of mesh splits to share between calls exporting the
+				*        same scene to several formats, the caller drops it once done.
+				*        If not given, the meshes are split without caching.
 				* @return returns repo_web_buffers upon success
 				*/
 				bool generateWebViewBuffers(
 					repo::core::model::RepoScene                 *scene,
 					const repo::manipulator::modelconvertor::WebExportType          &exType,
 					repo_web_buffers_t                           &resultBuffers,
-					repo::core::handler::AbstractDatabaseHandler *handler = nullptr);
+					repo::core::handler::AbstractDatabaseHandler *handler = nullptr,
+					repo::core::model::MeshSplitCache            *splitCache = nullptr);
 
 				/**
 				* Remove stash graph entry for the given scene
@@ -154,19 +166,37 @@ namespace repo{
 				* Generate a gltf encoding in the form of a buffer for the given scene
 				* This requires the stash to have been generated already
 				* @param scene the scene to generate the gltf encoding from
+				* @param splitCache cache of mesh splits (optional)
 				* @return returns a buffer in the form of a byte vector mapped to its filename
 				*/
 				repo_web_buffers_t generateGLTFBuffer(
-					repo::core::model::RepoScene *scene);
+					repo::core::model::RepoScene      *scene,
+					repo::core::model::MeshSplitCache *splitCache);
 
 				/**
 				* Generate a SRC encoding in the form of a buffer for the given scene
 				* This requires the stash to have been generated already
 				* @param scene the scene to generate the src encoding from
+				* @param splitCache cache of mesh splits (optional)
 				* @return returns a buffer in the form of a byte vector mapped to its filename
 				*/
 				repo_web_buffers_t generateSRCBuffer(
-					repo::core::model::RepoScene *scene);
+					repo::core::model::RepoScene      *scene,
+					repo::core::model::MeshSplitCache *splitCache);
+
+				/**
+				* Generate the unity asset bundle descriptors for the given scene
+				* The asset bundles themselves are not generated here, so only JSON files are returned
+				* This requires the stash to have been generated already
+				* @param scene the scene to generate the descriptors from
+				* @param vrEnabled whether VR asset bundles are expected
+				* @param splitCache cache of mesh splits (optional)
+				* @return returns a buffer in the form of a byte vector mapped to its filename
+				*/
+				repo_web_buffers_t generateAssetBuffer(
+					repo::core::model::RepoScene      *scene,
+					const bool                         vrEnabled,
+					repo::core::model::MeshSplitCache *splitCache);
 			};
 		}
 	}
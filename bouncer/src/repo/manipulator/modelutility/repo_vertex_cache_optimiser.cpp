@@ -0,0 +1,266 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "repo_vertex_cache_optimiser.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace repo::manipulator::modelutility;
+
+VertexCacheOptimiser::VertexCacheOptimiser(const uint32_t &cacheSize) :
+	cacheSize(std::max<uint32_t>(cacheSize, 3))
+{
+}
+
+VertexCacheOptimiser::~VertexCacheOptimiser(){}
+
+uint64_t VertexCacheOptimiser::countCacheMisses(
+	const uint16_t *faces,
+	const size_t   &nFaces,
+	const size_t   &nVertices)
+{
+	//A vertex is in the cache if fewer than cacheSize misses happened since it went in
+	//cacheTime holds the miss count after it went in, 0 if it never did
+	uint64_t nMisses = 0;
+	cacheTime.assign(nVertices, 0);
+	for (size_t i = 0; i < nFaces * 3; ++i)
+	{
+		const uint16_t vertex = faces[i];
+		if (!cacheTime[vertex] || nMisses - cacheTime[vertex] >= cacheSize)
+		{
+			cacheTime[vertex] = ++nMisses;
+		}
+	}
+
+	return nMisses;
+}
+
+void VertexCacheOptimiser::reorderFaces(
+	uint16_t                      *faces,
+	const size_t                  &nFaces,
+	const repo::lib::RepoVector3D *vertices,
+	const size_t                  &nVertices)
+{
+	if (nFaces < 2)
+		return;
+
+	//Faces using every vertex
+	liveCount.assign(nVertices, 0);
+	for (size_t i = 0; i < nFaces * 3; ++i)
+		++liveCount[faces[i]];
+
+	adjacencyOffset.resize(nVertices + 1);
+	adjacencyOffset[0] = 0;
+	for (size_t vertex = 0; vertex < nVertices; ++vertex)
+		adjacencyOffset[vertex + 1] = adjacencyOffset[vertex] + liveCount[vertex];
+
+	//cacheTime is used as the insertion point of every vertex here, before it is reset
+	cacheTime.assign(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+	adjacency.resize(nFaces * 3);
+	for (size_t i = 0; i < nFaces * 3; ++i)
+		adjacency[cacheTime[faces[i]]++] = i / 3;
+
+	//Time starts beyond the cache size, so no vertex is in the cache to begin with
+	uint32_t time = cacheSize + 1;
+	cacheTime.assign(nVertices, 0);
+	emitted.assign(nFaces, false);
+	deadEnd.clear();
+	faceOrder.clear();
+	faceOrder.reserve(nFaces);
+	clusterStarts.assign(1, 0);
+
+	size_t cursor = 0;
+	uint32_t fanning = skipDeadEnd(nVertices, cursor);
+	while (fanning < nVertices)
+	{
+		//Emit all the remaining faces around the vertex
+		candidates.clear();
+		for (uint32_t adj = adjacencyOffset[fanning]; adj < adjacencyOffset[fanning + 1]; ++adj)
+		{
+			const uint32_t face = adjacency[adj];
+			if (emitted[face])
+				continue;
+
+			for (size_t i = 0; i < 3; ++i)
+			{
+				const uint16_t vertex = faces[face * 3 + i];
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveCount[vertex];
+				if (time - cacheTime[vertex] > cacheSize)
+					cacheTime[vertex] = time++;
+			}
+			emitted[face] = true;
+			faceOrder.push_back(face);
+		}
+
+		//Fan around the candidate that stays in the cache the longest once its faces are emitted,
+		//or any candidate with faces left if none would stay in the cache
+		uint32_t next = nVertices;
+		int64_t bestPriority = -1;
+		for (const uint32_t &vertex : candidates)
+		{
+			if (liveCount[vertex])
+			{
+				int64_t priority = 0;
+				if (time - cacheTime[vertex] + 2 * liveCount[vertex] <= cacheSize)
+					priority = time - cacheTime[vertex];
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+		}
+
+		if (next == nVertices)
+		{
+			//A jump to a vertex that is out of the cache starts a new cluster
+			next = skipDeadEnd(nVertices, cursor);
+			if (next < nVertices && time - cacheTime[next] > cacheSize && clusterStarts.back() != faceOrder.size())
+				clusterStarts.push_back(faceOrder.size());
+		}
+
+		fanning = next;
+	}
+
+	//Sort the clusters facing away from the centre of the mesh first, as they are the most likely
+	//to occlude the others. The order within a cluster is kept, so is its cache efficiency.
+	const size_t nClusters = clusterStarts.size();
+	clusterStarts.push_back(faceOrder.size());
+	std::vector<uint32_t> clusterOrder(nClusters);
+	for (uint32_t cluster = 0; cluster < nClusters; ++cluster)
+		clusterOrder[cluster] = cluster;
+
+	if (vertices && nClusters > 1)
+	{
+		repo::lib::RepoVector3D meshCentre = { 0, 0, 0 };
+		for (size_t vertex = 0; vertex < nVertices; ++vertex)
+		{
+			meshCentre.x += vertices[vertex].x;
+			meshCentre.y += vertices[vertex].y;
+			meshCentre.z += vertices[vertex].z;
+		}
+		meshCentre.x /= nVertices;
+		meshCentre.y /= nVertices;
+		meshCentre.z /= nVertices;
+
+		std::vector<float> occlusion(nClusters);
+		for (size_t cluster = 0; cluster < nClusters; ++cluster)
+		{
+			//Area weighted centre and normal of the cluster
+			repo::lib::RepoVector3D centre = { 0, 0, 0 }, normal = { 0, 0, 0 };
+			float area = 0;
+			for (size_t i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; ++i)
+			{
+				const auto &v0 = vertices[faces[faceOrder[i] * 3]];
+				const auto &v1 = vertices[faces[faceOrder[i] * 3 + 1]];
+				const auto &v2 = vertices[faces[faceOrder[i] * 3 + 2]];
+				repo::lib::RepoVector3D e1 = { v1.x - v0.x, v1.y - v0.y, v1.z - v0.z };
+				repo::lib::RepoVector3D e2 = { v2.x - v0.x, v2.y - v0.y, v2.z - v0.z };
+				auto faceNormal = e1.crossProduct(e2);
+				float faceArea = std::sqrt(faceNormal.dotProduct(faceNormal));
+
+				normal.x += faceNormal.x;
+				normal.y += faceNormal.y;
+				normal.z += faceNormal.z;
+				centre.x += (v0.x + v1.x + v2.x) * faceArea;
+				centre.y += (v0.y + v1.y + v2.y) * faceArea;
+				centre.z += (v0.z + v1.z + v2.z) * faceArea;
+				area += faceArea;
+			}
+
+			if (area > 0)
+			{
+				normal.normalize();
+				repo::lib::RepoVector3D offset = {
+					centre.x / (area * 3) - meshCentre.x,
+					centre.y / (area * 3) - meshCentre.y,
+					centre.z / (area * 3) - meshCentre.z };
+				occlusion[cluster] = offset.dotProduct(normal);
+			}
+		}
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+			[&occlusion](const uint32_t &a, const uint32_t &b) { return occlusion[a] > occlusion[b]; });
+	}
+
+	faceBuffer.assign(faces, faces + nFaces * 3);
+	uint16_t *output = faces;
+	for (const auto &cluster : clusterOrder)
+	{
+		for (size_t i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; ++i)
+		{
+			const uint16_t *face = &faceBuffer[faceOrder[i] * 3];
+			*output++ = face[0];
+			*output++ = face[1];
+			*output++ = face[2];
+		}
+	}
+}
+
+std::vector<uint32_t> VertexCacheOptimiser::reorderVertices(
+	uint16_t     *faces,
+	const size_t &nFaces,
+	const size_t &nVertices)
+{
+	//cacheTime holds the new index + 1 of every vertex here, 0 if not assigned yet
+	std::vector<uint32_t> newToOld;
+	newToOld.reserve(nVertices);
+	cacheTime.assign(nVertices, 0);
+	for (size_t i = 0; i < nFaces * 3; ++i)
+	{
+		uint32_t &newIndex = cacheTime[faces[i]];
+		if (!newIndex)
+		{
+			newToOld.push_back(faces[i]);
+			newIndex = newToOld.size();
+		}
+		faces[i] = newIndex - 1;
+	}
+
+	for (uint32_t vertex = 0; vertex < nVertices; ++vertex)
+	{
+		if (!cacheTime[vertex])
+			newToOld.push_back(vertex);
+	}
+
+	return newToOld;
+}
+
+uint32_t VertexCacheOptimiser::skipDeadEnd(
+	const size_t &nVertices,
+	size_t       &cursor)
+{
+	//Go back through the vertices recently used first, as they may still be in the cache
+	while (!deadEnd.empty())
+	{
+		const uint32_t vertex = deadEnd.back();
+		deadEnd.pop_back();
+		if (liveCount[vertex])
+			return vertex;
+	}
+
+	for (; cursor < nVertices; ++cursor)
+	{
+		if (liveCount[cursor])
+			return cursor;
+	}
+
+	return nVertices;
+}
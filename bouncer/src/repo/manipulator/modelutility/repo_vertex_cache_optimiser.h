@@ -0,0 +1,117 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* Vertex cache optimiser - reorders the triangles of an index buffer for the
+* post transform vertex cache of the GPU (Tipsify, Sander et al. 2007), sorts
+* the resulting clusters to reduce overdraw, and renumbers the vertices in the
+* order they are fetched.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../lib/datastructure/repo_vector.h"
+
+//Size of the FIFO cache the triangles are ordered for and measured against
+#define REPO_VERTEX_CACHE_SIZE 16
+
+namespace repo{
+	namespace manipulator{
+		namespace modelutility{
+			class VertexCacheOptimiser
+			{
+			public:
+				/**
+				* Construct a vertex cache optimiser
+				* The working buffers are kept between calls, so one optimiser
+				* should be reused for all the faces of a mesh
+				* @param cacheSize number of vertices held by the cache
+				*/
+				VertexCacheOptimiser(const uint32_t &cacheSize = REPO_VERTEX_CACHE_SIZE);
+				~VertexCacheOptimiser();
+
+				/**
+				* Count the misses of a FIFO vertex cache when drawing the faces
+				* the average cache miss ratio (ACMR) is this over the number of faces
+				* @param faces triangle index buffer
+				* @param nFaces number of triangles
+				* @param nVertices number of vertices indexed by the faces
+				* @return returns the number of cache misses
+				*/
+				uint64_t countCacheMisses(
+					const uint16_t *faces,
+					const size_t   &nFaces,
+					const size_t   &nVertices);
+
+				/**
+				* Reorder the triangles for the vertex cache, then sort the
+				* clusters of triangles between cache flushes front to back
+				* @param faces triangle index buffer to reorder in place
+				* @param nFaces number of triangles
+				* @param vertices positions of the vertices indexed by the faces
+				* @param nVertices number of vertices indexed by the faces
+				*/
+				void reorderFaces(
+					uint16_t                      *faces,
+					const size_t                  &nFaces,
+					const repo::lib::RepoVector3D *vertices,
+					const size_t                  &nVertices);
+
+				/**
+				* Renumber the vertices in the order the faces first use them
+				* Vertices not used by any face are moved to the end
+				* @param faces triangle index buffer to renumber in place
+				* @param nFaces number of triangles
+				* @param nVertices number of vertices indexed by the faces
+				* @return returns the old index of every vertex, by new index
+				*/
+				std::vector<uint32_t> reorderVertices(
+					uint16_t     *faces,
+					const size_t &nFaces,
+					const size_t &nVertices);
+
+			private:
+				/**
+				* Find the next vertex to fan around once the last one has no
+				* candidate left in the cache
+				* @param nVertices number of vertices indexed by the faces
+				* @param cursor next vertex to check in index order (consume and update)
+				* @return returns the vertex, nVertices if all faces are emitted
+				*/
+				uint32_t skipDeadEnd(
+					const size_t &nVertices,
+					size_t       &cursor);
+
+				const uint32_t cacheSize;
+
+				std::vector<uint32_t> liveCount; //faces not emitted yet, by vertex
+				std::vector<uint32_t> adjacencyOffset; //start of the faces of every vertex within adjacency
+				std::vector<uint32_t> adjacency; //faces using every vertex
+				std::vector<uint32_t> cacheTime; //time stamp a vertex entered the cache
+				std::vector<uint32_t> deadEnd; //vertices recently used, to pick up from when fanning stops
+				std::vector<uint32_t> candidates; //vertices of the faces emitted around the current vertex
+				std::vector<uint32_t> faceOrder; //faces in their new order
+				std::vector<bool> emitted; //whether a face has been emitted
+				std::vector<size_t> clusterStarts; //start of every cluster within faceOrder
+				std::vector<uint16_t> faceBuffer; //copy of the faces while reordering
+			};
+		}
+	}
+}
@@ -440,12 +440,13 @@ repo::core::model::RepoScene* RepoManipulator::fetchScene(
 	const repo::lib::RepoUUID                                &uuid,
 	const bool                                    &headRevision,
 	const bool                                    &lightFetch,
-	const bool                                    &ignoreRefScene)
+	const bool                                    &ignoreRefScene,
+	const repo::core::model::RepoScene::LoadProfile &profile)
 {
 	repo::core::handler::AbstractDatabaseHandler* handler =
 		repo::core::handler::MongoDatabaseHandler::getHandler(databaseAd);
 	modelutility::SceneManager sceneManager;
-	return sceneManager.fetchScene(handler, database, project, uuid, headRevision, lightFetch, ignoreRefScene);
+	return sceneManager.fetchScene(handler, database, project, uuid, headRevision, lightFetch, ignoreRefScene, profile);
 }
 
 void RepoManipulator::fetchScene(
@@ -531,6 +532,20 @@ bool RepoManipulator::generateAndCommitSRCBuffer(
 		buffers, modelconvertor::WebExportType::SRC);
 }
 
+bool RepoManipulator::generateAndCommitSRCAndGLTFBuffers(
+	const std::string                             &databaseAd,
+	const repo::core::model::RepoBSON	          *cred,
+	repo::core::model::RepoScene                  *scene)
+{
+	//Both encodings split the same meshes, so split them once for the job
+	repo::core::model::MeshSplitCache splitCache;
+	repo_web_buffers_t srcBuffers, gltfBuffers;
+	return generateAndCommitWebViewBuffer(databaseAd, cred, scene,
+		srcBuffers, modelconvertor::WebExportType::SRC, &splitCache)
+		&& generateAndCommitWebViewBuffer(databaseAd, cred, scene,
+		gltfBuffers, modelconvertor::WebExportType::GLTF, &splitCache);
+}
+
 bool RepoManipulator::generateAndCommitSelectionTree(
 	const std::string                         &databaseAd,
 	const repo::core::model::RepoBSON         *cred,
@@ -580,12 +595,13 @@ bool RepoManipulator::generateAndCommitWebViewBuffer(
 	const repo::core::model::RepoBSON	          *cred,
 	repo::core::model::RepoScene                  *scene,
 	repo_web_buffers_t                            &buffers,
-	const modelconvertor::WebExportType           &exType)
+	const modelconvertor::WebExportType           &exType,
+	repo::core::model::MeshSplitCache             *splitCache)
 {
 	repo::core::handler::AbstractDatabaseHandler* handler =
 		repo::core::handler::MongoDatabaseHandler::getHandler(databaseAd);
 	modelutility::SceneManager SceneManager;
-	return SceneManager.generateWebViewBuffers(scene, exType, buffers, handler);
+	return SceneManager.generateWebViewBuffers(scene, exType, buffers, handler, splitCache);
 }
 
 repo_web_buffers_t RepoManipulator::generateGLTFBuffer(
@@ -1162,28 +1178,52 @@ bool RepoManipulator::saveOriginalFiles(
 
 			for (const std::string &file : files)
 			{
-				std::vector<uint8_t> rawFile = handler->getRawFile(scene->getDatabaseName(),
-					scene->getProjectName() + "." + scene->getRawExtension(), file);
-				if (rawFile.size() > 0)
+				boost::filesystem::path filePath(file);
+				boost::filesystem::path fullPath = dir / filePath;
+
+				//The output is only opened once the file is found in the database, so a missing
+				//file does not leave an empty one behind
+				std::ofstream out;
+				bool writeFailed = false;
+				bool streamed = handler->streamRawFile(scene->getDatabaseName(),
+					scene->getProjectName() + "." + scene->getRawExtension(), file,
+					[&](const uint8_t *data, const size_t &size)
+				{
+					if (!out.is_open())
+						out.open(fullPath.string(), std::ofstream::binary);
+					out.write((const char*)data, size);
+					return !(writeFailed = !out.good());
+				});
+
+				//An empty file has no chunk to stream
+				if (streamed && !out.is_open())
+					out.open(fullPath.string(), std::ofstream::binary);
+
+				const bool opened = out.is_open();
+				if (opened)
 				{
-					boost::filesystem::path filePath(file);
-					boost::filesystem::path fullPath = dir / filePath;
+					out.close();
+					writeFailed |= out.fail();
+				}
 
-					std::ofstream out(fullPath.string(), std::ofstream::binary);
-					if (out.good())
-					{
-						out.write((char*)rawFile.data(), rawFile.size());
-						out.close();
-					}
-					else
-					{
-						repoError << " Failed to open file to write: " << fullPath.string();
-						success = false;
-					}
+				if (writeFailed || (streamed && !opened))
+				{
+					repoError << "Failed to write file: " << fullPath.string();
 				}
-				else
+				else if (!streamed)
 				{
-					repoWarning << "Unable to read file " << file << " from the database. Skipping...";
+					repoError << "Unable to read file " << file << " from the database";
+				}
+
+				if (writeFailed || !streamed || !opened)
+				{
+					success = false;
+					//Do not leave a partial file behind
+					if (opened)
+					{
+						boost::system::error_code ec;
+						boost::filesystem::remove(fullPath, ec);
+					}
 				}
 			}
 		}
@@ -277,6 +277,7 @@ namespace repo{
 			* @param headRevision true if retrieving head revision
 			* @param lightFetch fetches only the stash (or scene if stash failed),
 			reduce computation and memory usage (ideal for visualisation only)
+			* @param profile which fields of the nodes to load (see RepoScene::LoadProfile)
 			* @return returns a pointer to a repoScene.
 			*/
 			repo::core::model::RepoScene* fetchScene(
@@ -287,7 +288,8 @@ namespace repo{
 				const repo::lib::RepoUUID                                &uuid,
 				const bool                                    &headRevision = false,
 				const bool                                    &lightFetch = false,
-				const bool                                    &ignoreRefScene = false);
+				const bool                                    &ignoreRefScene = false,
+				const repo::core::model::RepoScene::LoadProfile &profile = repo::core::model::RepoScene::LoadProfile::FULL);
 
 			/**
 			* Retrieve all RepoScene representations given a partially loaded scene.
@@ -340,6 +342,8 @@ namespace repo{
 			* @param scene the scene to generate the src encoding from
 			* @param buffers buffers that are geneated and commited
 			* @param exType the type of export it is
+			* @param splitCache cache of mesh splits shared with other exports
+			*        of the same scene (optional)
 			* @return returns true upon success
 			*/
 			bool generateAndCommitWebViewBuffer(
@@ -347,7 +351,8 @@ namespace repo{
 				const repo::core::model::RepoBSON	          *cred,
 				repo::core::model::RepoScene                  *scene,
 				repo_web_buffers_t                            &buffers,
-				const modelconvertor::WebExportType           &exType);
+				const modelconvertor::WebExportType           &exType,
+				repo::core::model::MeshSplitCache             *splitCache = nullptr);
 
 			/**
 			* Generate and commit a GLTF encoding for the given scene
@@ -376,6 +381,20 @@ namespace repo{
 				const repo::core::model::RepoBSON	          *cred,
 				repo::core::model::RepoScene                  *scene);
 
+			/**
+			* Generate and commit both the SRC and GLTF encodings for the given scene
+			* Meshes are split once and the splits are shared by both encodings
+			* This requires the stash to have been generated already
+			* @param databaseAd database address:portdatabase
+			* @param cred user credentials in bson form
+			* @param scene the scene to generate the encodings from
+			* @return returns true upon success
+			*/
+			bool generateAndCommitSRCAndGLTFBuffers(
+				const std::string                             &databaseAd,
+				const repo::core::model::RepoBSON	          *cred,
+				repo::core::model::RepoScene                  *scene);
+
 			/**
 			* Generate a gltf encoding in the form of a buffer for the given scene
 			* This requires the stash to have been generated already
@@ -174,9 +174,10 @@ repo::core::model::RepoScene* RepoController::fetchScene(
 	const std::string    &uuid,
 	const bool           &headRevision,
 	const bool           &lightFetch,
-	const bool           &ignoreRefScene)
+	const bool           &ignoreRefScene,
+	const repo::core::model::RepoScene::LoadProfile &profile)
 {
-	return impl->fetchScene(token, database, collection, uuid, headRevision, lightFetch, ignoreRefScene);
+	return impl->fetchScene(token, database, collection, uuid, headRevision, lightFetch, ignoreRefScene, profile);
 }
 
 bool RepoController::generateAndCommitSelectionTree(
@@ -447,6 +448,13 @@ bool RepoController::generateAndCommitSRCBuffer(
 	return impl->generateAndCommitSRCBuffer(token, scene);
 }
 
+bool RepoController::generateAndCommitSRCAndGLTFBuffers(
+	const RepoController::RepoToken    *token,
+	repo::core::model::RepoScene *scene)
+{
+	return impl->generateAndCommitSRCAndGLTFBuffers(token, scene);
+}
+
 repo_web_buffers_t RepoController::generateGLTFBuffer(
 	repo::core::model::RepoScene *scene)
 {
@@ -434,7 +434,8 @@ public:
 		const std::string    &uuid = REPO_HISTORY_MASTER_BRANCH,
 		const bool           &headRevision = true,
 		const bool           &lightFetch = false,
-		const bool           &ignoreRefScene = false);
+		const bool           &ignoreRefScene = false,
+		const repo::core::model::RepoScene::LoadProfile &profile = repo::core::model::RepoScene::LoadProfile::FULL);
 
 	/**
 	* Save the files of the original model to a specified directory
@@ -739,6 +740,18 @@ public:
 		const RepoToken                               *token,
 		repo::core::model::RepoScene            *scene);
 
+	/**
+	* Generate and commit both the SRC and GLTF encodings for the given scene
+	* Meshes are split once and the splits are shared by both encodings
+	* This requires the stash to have been generated already
+	* @param token token for authentication
+	* @param scene the scene to generate the encodings from
+	* @return returns true upon success
+	*/
+	bool generateAndCommitSRCAndGLTFBuffers(
+		const RepoToken                               *token,
+		repo::core::model::RepoScene            *scene);
+
 	/**
 	* Generate a GLTF encoding in the form of a buffer for the given scene
 	* This requires the stash to have been generated already
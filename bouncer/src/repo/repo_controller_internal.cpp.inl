@@ -326,7 +326,8 @@ repo::core::model::RepoScene* RepoController::_RepoControllerImpl::fetchScene(
 	const std::string    &uuid,
 	const bool           &headRevision,
 	const bool           &lightFetch,
-	const bool           &ignoreRefScene)
+	const bool           &ignoreRefScene,
+	const repo::core::model::RepoScene::LoadProfile &profile)
 {
 	repo::core::model::RepoScene* scene = 0;
 	if (token)
@@ -334,7 +335,7 @@ repo::core::model::RepoScene* RepoController::_RepoControllerImpl::fetchScene(
 		manipulator::RepoManipulator* worker = workerPool.pop();
 
 		scene = worker->fetchScene(token->databaseAd, token->getCredentials(),
-			database, collection, repo::lib::RepoUUID(uuid), headRevision, lightFetch, ignoreRefScene);
+			database, collection, repo::lib::RepoUUID(uuid), headRevision, lightFetch, ignoreRefScene, profile);
 
 		workerPool.push(worker);
 	}
@@ -931,6 +932,24 @@ bool RepoController::_RepoControllerImpl::generateAndCommitSRCBuffer(
 	return success;
 }
 
+bool RepoController::_RepoControllerImpl::generateAndCommitSRCAndGLTFBuffers(
+	const RepoController::RepoToken                    *token,
+	repo::core::model::RepoScene *scene)
+{
+	bool success;
+	if (success = token && scene)
+	{
+		manipulator::RepoManipulator* worker = workerPool.pop();
+		success = worker->generateAndCommitSRCAndGLTFBuffers(token->databaseAd, token->getCredentials(), scene);
+		workerPool.push(worker);
+	}
+	else
+	{
+		repoError << "Failed to generate SRC and GLTF Buffers.";
+	}
+	return success;
+}
+
 repo_web_buffers_t RepoController::_RepoControllerImpl::generateGLTFBuffer(
 	repo::core::model::RepoScene *scene)
 {
@@ -41,7 +41,7 @@ std::string helpInfo()
 {
 	std::stringstream ss;
 
-	ss << cmdGenStash << "\tGenerate Stash for a project. (args: database project [repo|gltf|src|tree])\n";
+	ss << cmdGenStash << "\tGenerate Stash for a project. (args: database project [repo|gltf|src|web|tree])\n";
 	ss << cmdGetFile << "\t\tGet original file for the latest revision of the project (args: database project dir)\n";
 	ss << cmdImportFile << "\t\tImport file to database. (args: {file database project [dxrotate] [owner] [configfile]} or {-f parameterFile} )\n";
 	ss << cmdCreateFed << "\t\tGenerate a federation. (args: fedDetails [owner])\n";
@@ -306,7 +306,7 @@ int32_t generateStash(
 	if (command.nArgcs < 3)
 	{
 		repoLogError("Number of arguments mismatch! " + cmdGenStash
-			+ " requires 3 arguments:database project [repo|gltf|src|tree]");
+			+ " requires 3 arguments:database project [repo|gltf|src|web|tree]");
 		return REPOERR_INVALID_ARG;
 	}
 
@@ -314,13 +314,15 @@ int32_t generateStash(
 	std::string project = command.args[1];
 	std::string type = command.args[2];
 
-	if (!(type == "repo" || type == "gltf" || type == "src" || type == "tree"))
+	if (!(type == "repo" || type == "gltf" || type == "src" || type == "web" || type == "tree"))
 	{
 		repoLogError("Unknown stash type: " + type);
 		return REPOERR_INVALID_ARG;
 	}
 
-	auto scene = controller->fetchScene(token, dbName, project, REPO_HISTORY_MASTER_BRANCH, true, false, true);
+	//The selection tree only needs the structure of the graph
+	auto profile = type == "tree" ? repo::core::model::RepoScene::LoadProfile::TREE : repo::core::model::RepoScene::LoadProfile::FULL;
+	auto scene = controller->fetchScene(token, dbName, project, REPO_HISTORY_MASTER_BRANCH, true, false, true, profile);
 	if (!scene)
 	{
 		return REPOERR_STASH_GEN_FAIL;
@@ -340,6 +342,10 @@ int32_t generateStash(
 	{
 		success = controller->generateAndCommitSRCBuffer(token, scene);
 	}
+	else if (type == "web")
+	{
+		success = controller->generateAndCommitSRCAndGLTFBuffers(token, scene);
+	}
 	else if (type == "tree")
 	{
 		success = controller->generateAndCommitSelectionTree(token, scene);
@@ -0,0 +1,83 @@
+/**
+*  Copyright (C) 2015 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <repo/core/handler/repo_commit_pipeline.h>
+#include <gtest/gtest.h>
+
+using namespace repo::core::handler;
+
+TEST(CommitPipelineTest, RunsAllJobs)
+{
+	std::atomic<int> count(0);
+	std::string errMsg;
+	CommitPipeline pipeline(nullptr, 4, 2);
+	for (int i = 0; i < 100; ++i)
+	{
+		pipeline.push([&](AbstractDatabaseHandler *handler, std::string &err)
+		{
+			++count;
+			return true;
+		});
+	}
+
+	EXPECT_TRUE(pipeline.finish(errMsg));
+	EXPECT_TRUE(errMsg.empty());
+	EXPECT_EQ(100, count);
+}
+
+TEST(CommitPipelineTest, AggregatesErrors)
+{
+	std::string errMsg;
+	CommitPipeline pipeline(nullptr, 3);
+	for (int i = 0; i < 10; ++i)
+	{
+		pipeline.push([i](AbstractDatabaseHandler *handler, std::string &err)
+		{
+			if (i % 5) return true;
+			err = "fail;";
+			return false;
+		});
+	}
+
+	EXPECT_FALSE(pipeline.finish(errMsg));
+	EXPECT_EQ("fail;fail;", errMsg);
+
+	//Nothing can be pushed once finished
+	EXPECT_FALSE(pipeline.push([](AbstractDatabaseHandler *handler, std::string &err) { return false; }));
+	errMsg.clear();
+	EXPECT_FALSE(pipeline.finish(errMsg));
+	EXPECT_FALSE(errMsg.empty());
+}
+
+TEST(CommitPipelineTest, PushAfterFinishFails)
+{
+	std::string errMsg;
+	bool ran = false;
+	CommitPipeline pipeline(nullptr, 2);
+	EXPECT_TRUE(pipeline.finish(errMsg));
+
+	//A dropped job fails the pipeline instead of going missing silently
+	EXPECT_FALSE(pipeline.push([&](AbstractDatabaseHandler *handler, std::string &err)
+	{
+		ran = true;
+		return true;
+	}));
+	EXPECT_FALSE(pipeline.finish(errMsg));
+	EXPECT_FALSE(errMsg.empty());
+	EXPECT_FALSE(ran);
+}
@@ -475,6 +475,41 @@ TEST(MongoDatabaseHandlerTest, InsertDocument)
 	errMsg.clear();
 }
 
+TEST(MongoDatabaseHandlerTest, InsertManyDocuments)
+{
+	auto handler = getHandler();
+	ASSERT_TRUE(handler);
+	std::string errMsg;
+	std::string database = "sandbox";
+	std::string collection = "sbManyCollection";
+
+	std::vector<repo::core::model::RepoBSON> testCases;
+	for (int i = 0; i < 10; ++i)
+	{
+		testCases.push_back(BSON("_id" << ("manyTestID" + std::to_string(i)) << "anotherField" << std::rand()));
+	}
+
+	EXPECT_TRUE(handler->insertManyDocuments(database, collection, testCases, errMsg));
+	EXPECT_TRUE(errMsg.empty());
+	errMsg.clear();
+
+	for (const auto &testCase : testCases)
+	{
+		repo::core::model::RepoBSON result = handler->findOneByCriteria(database, collection, testCase);
+		EXPECT_FALSE(result.isEmpty());
+	}
+
+	EXPECT_TRUE(handler->insertManyDocuments(database, collection, {}, errMsg));
+	EXPECT_TRUE(errMsg.empty());
+
+	EXPECT_FALSE(handler->insertManyDocuments("", collection, testCases, errMsg));
+	EXPECT_FALSE(errMsg.empty());
+	errMsg.clear();
+	EXPECT_FALSE(handler->insertManyDocuments(database, "", testCases, errMsg));
+	EXPECT_FALSE(errMsg.empty());
+	errMsg.clear();
+}
+
 TEST(MongoDatabaseHandlerTest, InsertRawFile)
 {
 	auto handler = getHandler();
@@ -726,6 +761,42 @@ TEST(MongoDatabaseHandlerTest, FindAllByCriteria)
 	EXPECT_EQ(0, handler->findAllByCriteria(REPO_GTEST_DBNAME1, "", search).size());
 }
 
+TEST(MongoDatabaseHandlerTest, FindAllByCriteriaInBatches)
+{
+	auto handler = getHandler();
+	ASSERT_TRUE(handler);
+
+	repo::core::model::RepoBSON search = BSON("type" << "mesh");
+
+	size_t nBatches = 0, nDocs = 0;
+	EXPECT_TRUE(handler->findAllByCriteria(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".scene", search,
+		[&](std::vector<repo::core::model::RepoBSON> &batch)
+	{
+		++nBatches;
+		nDocs += batch.size();
+		for (const auto &bson : batch)
+			EXPECT_EQ("mesh", bson.getStringField("type"));
+		return true;
+	}));
+	EXPECT_EQ(4, nDocs);
+	EXPECT_TRUE(nBatches > 0);
+
+	//Rejecting a batch stops the query
+	nBatches = 0;
+	EXPECT_FALSE(handler->findAllByCriteria(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".scene", search,
+		[&](std::vector<repo::core::model::RepoBSON> &batch)
+	{
+		++nBatches;
+		return false;
+	}));
+	EXPECT_EQ(1, nBatches);
+
+	auto noCall = [](std::vector<repo::core::model::RepoBSON> &batch) { ADD_FAILURE(); return true; };
+	EXPECT_FALSE(handler->findAllByCriteria(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".scene", repo::core::model::RepoBSON(), noCall));
+	handler->findAllByCriteria("", REPO_GTEST_DBNAME1_PROJ + ".scene", search, noCall);
+	handler->findAllByCriteria(REPO_GTEST_DBNAME1, "", search, noCall);
+}
+
 TEST(MongoDatabaseHandlerTest, FindOneByCriteria)
 {
 	auto handler = getHandler();
@@ -777,4 +848,31 @@ TEST(MongoDatabaseHandlerTest, GetRawFile)
 	EXPECT_EQ(0, handler->getRawFile(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".history", "some_non_existent_file").size());
 	EXPECT_EQ(0, handler->getRawFile("", REPO_GTEST_DBNAME1_PROJ + ".history", REPO_GTEST_RAWFILE_FETCH_TEST).size());
 	EXPECT_EQ(0, handler->getRawFile(REPO_GTEST_DBNAME1, "", REPO_GTEST_RAWFILE_FETCH_TEST).size());
-}
\ No newline at end of file
+}
+
+TEST(MongoDatabaseHandlerTest, StreamRawFile)
+{
+	auto handler = getHandler();
+	ASSERT_TRUE(handler);
+	auto expected = handler->getRawFile(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".history", REPO_GTEST_RAWFILE_FETCH_TEST);
+
+	std::vector<uint8_t> streamed;
+	size_t nChunks = 0;
+	auto sink = [&](const uint8_t *data, const size_t &size)
+	{
+		streamed.insert(streamed.end(), data, data + size);
+		++nChunks;
+		return true;
+	};
+
+	EXPECT_TRUE(handler->streamRawFile(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".history", REPO_GTEST_RAWFILE_FETCH_TEST, sink));
+	EXPECT_EQ(expected, streamed);
+	EXPECT_GT(nChunks, 0);
+
+	//Stopping the read early fails
+	EXPECT_FALSE(handler->streamRawFile(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".history", REPO_GTEST_RAWFILE_FETCH_TEST,
+		[](const uint8_t *data, const size_t &size) { return false; }));
+
+	EXPECT_FALSE(handler->streamRawFile(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ + ".history", "some_non_existent_file", sink));
+	EXPECT_FALSE(handler->streamRawFile("", REPO_GTEST_DBNAME1_PROJ + ".history", REPO_GTEST_RAWFILE_FETCH_TEST, sink));
+}
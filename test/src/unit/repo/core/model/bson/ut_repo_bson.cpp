@@ -15,6 +15,7 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <atomic>
 #include <cstdlib>
 
 #include <gtest/gtest.h>
@@ -482,6 +483,87 @@ TEST(RepoBSONTest, HasOversizeFiles)
 	EXPECT_FALSE(emptyBson.hasOversizeFiles());
 }
 
+TEST(RepoBSONTest, LazyBigFiles)
+{
+	std::vector<uint8_t> in;
+	in.resize(100);
+	for (size_t i = 0; i < in.size(); ++i)
+		in[i] = i;
+
+	std::unordered_map < std::string, std::pair<std::string, std::vector<uint8_t>>> mapping;
+	mapping["blah"] = std::pair<std::string, std::vector<uint8_t>>("orgRef", in);
+	mongo::BSONObj stored = RepoBSON(testBson, mapping).copy();
+
+	std::atomic<int> nLoads(0);
+	auto loader = [&](const std::string &fileName, std::vector<uint8_t> &data)
+	{
+		++nLoads;
+		if (fileName == "orgRef")
+			data = in;
+		else if (fileName == "emptyRef")
+			data.clear();
+		else
+			return false;
+		return true;
+	};
+
+	RepoBSON lazyBson(stored, loader);
+	EXPECT_EQ(0, nLoads);
+	EXPECT_TRUE(lazyBson.hasOversizeFiles());
+	EXPECT_TRUE(lazyBson.hasBinField("blah"));
+	EXPECT_EQ(0, nLoads);
+
+	//Looking up without fetching leaves the file alone
+	EXPECT_EQ(nullptr, lazyBson.findBigFile("blah", false));
+	EXPECT_EQ(0, nLoads);
+
+	//Copies share the fetched content
+	RepoBSON copy = lazyBson;
+	EXPECT_EQ(in, lazyBson.getBigBinary("blah"));
+	EXPECT_EQ(in, copy.getBigBinary("blah"));
+	EXPECT_EQ(1, nLoads);
+
+	auto outMapping = copy.getFilesMapping();
+	ASSERT_FALSE(outMapping.find("blah") == outMapping.end());
+	EXPECT_EQ("orgRef", outMapping["blah"].first);
+	EXPECT_EQ(in, outMapping["blah"].second);
+	EXPECT_EQ(1, nLoads);
+
+	//Prefetching fetches every file once, regardless of the number of copies
+	std::vector<RepoBSON> bsons(10, RepoBSON(stored, loader));
+	std::vector<const RepoBSON*> ptrs;
+	for (const auto &bson : bsons)
+		ptrs.push_back(&bson);
+	ptrs.push_back(&bsons[0]);
+	RepoBSON::prefetchBigFiles(ptrs, 4);
+	EXPECT_EQ(2, nLoads);
+	EXPECT_EQ(in, bsons[9].getBigBinary("blah"));
+	EXPECT_EQ(2, nLoads);
+
+	//A file that fails to load is retried on the next access
+	mapping["blah"].first = "missing";
+	mongo::BSONObj missing = RepoBSON(testBson, mapping).copy();
+	RepoBSON missingBson(missing, loader);
+	EXPECT_EQ(0, missingBson.getBigBinary("blah").size());
+	EXPECT_EQ(0, missingBson.getBigBinary("blah").size());
+	EXPECT_EQ(4, nLoads);
+
+	//An empty file is loaded like any other, it is only fetched once
+	mapping["blah"].first = "emptyRef";
+	mongo::BSONObj empty = RepoBSON(testBson, mapping).copy();
+	RepoBSON emptyFileBson(empty, loader);
+	EXPECT_EQ(0, emptyFileBson.getBigBinary("blah").size());
+	ASSERT_NE(nullptr, emptyFileBson.findBigFile("blah", false));
+	EXPECT_EQ(0, emptyFileBson.getBigBinary("blah").size());
+	EXPECT_EQ(5, nLoads);
+
+	//No files, nothing to fetch
+	RepoBSON noFiles(testBson, loader);
+	EXPECT_FALSE(noFiles.hasOversizeFiles());
+	noFiles.prefetchBigFiles();
+	EXPECT_EQ(5, nLoads);
+}
+
 TEST(RepoBSONTest, GetEmbeddedDoubleTest)
 {
 	RepoBSON empty;
@@ -380,7 +380,8 @@ TEST(RepoBSONFactoryTest, MakeMeshNodeTest)
 	auto uvOut = mesh.getUVChannelsSeparated();
 	EXPECT_TRUE(compareStdVectors(vectors, vOut));
 	EXPECT_TRUE(compareStdVectors(normals, nOut));
-	EXPECT_TRUE(compareStdVectors(faces, fOut));
+	EXPECT_EQ(faces.size(), fOut.size());
+	EXPECT_TRUE(compareStdVectors(repo::lib::RepoFaceBuffer(faces).serialised(), fOut.serialised()));
 	EXPECT_TRUE(compareVectors(colors, cOut));
 	EXPECT_TRUE(compareStdVectors(uvChannels, uvOut));
 
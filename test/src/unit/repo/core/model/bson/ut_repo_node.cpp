@@ -561,4 +561,35 @@ TEST(RepoNodeTest, OperatorCompareTest)
 	EXPECT_EQ(uniqueID < uniqueID2, makeNode(uniqueID, sharedID, "14") < makeNode(uniqueID2, sharedID, "14"));
 	EXPECT_EQ(uniqueID < uniqueID2, makeNode(uniqueID, sharedID, "15") < makeNode(uniqueID2, sharedID, "15"));
 	EXPECT_EQ(uniqueID < uniqueID2, makeNode(uniqueID, sharedID, "16") < makeNode(uniqueID2, sharedID, "16"));
-}
\ No newline at end of file
+}
+
+TEST(RepoNodeTest, CachedIDsTest)
+{
+	//IDs should remain stable even if they are absent from the bson
+	EXPECT_EQ(emptyNode.getUniqueID(), emptyNode.getUniqueID());
+	EXPECT_EQ(emptyNode.getSharedID(), emptyNode.getSharedID());
+
+	repo::lib::RepoUUID sharedID = repo::lib::RepoUUID::createUUID();
+	repo::lib::RepoUUID uniqueID = repo::lib::RepoUUID::createUUID();
+
+	RepoNode node = makeTypicalNode();
+	node.swap(makeNode(uniqueID, sharedID));
+
+	//swapping the content should refresh the IDs
+	EXPECT_EQ(uniqueID, node.getUniqueID());
+	EXPECT_EQ(sharedID, node.getSharedID());
+
+	//so does assignment
+	RepoNode assigned = makeTypicalNode();
+	assigned = node;
+	EXPECT_EQ(uniqueID, assigned.getUniqueID());
+	EXPECT_EQ(sharedID, assigned.getSharedID());
+
+	//Nodes within a set should be found by their IDs
+	RepoNodeSet nodeSet;
+	RepoNode typicalNode = makeTypicalNode();
+	nodeSet.insert(&node);
+	nodeSet.insert(&typicalNode);
+	RepoNode lookUp = makeNode(uniqueID, sharedID, "lookup");
+	EXPECT_NE(nodeSet.end(), nodeSet.find(&lookUp));
+}
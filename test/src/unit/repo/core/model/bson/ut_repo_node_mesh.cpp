@@ -246,6 +246,54 @@ TEST(MeshNodeTest, CloneAndApplyTransformation)
 	EXPECT_FALSE(compareStdVectors(changedMesh.getNormals(), changedMesh.getVertices()));
 }
 
+TEST(MeshNodeTest, GeometryHash)
+{
+	std::vector<repo::lib::RepoVector3D> v = { { 0.1f, 0.2f, 0.3f }, { 0.4f, 0.5f, 0.6f }, { 0.7f, 0.8f, 0.9f } };
+	std::vector<repo_face_t> f = { { 0, 1, 2 } };
+	std::vector<std::vector<float>> bbox;
+
+	auto mesh1 = RepoBSONFactory::makeMeshNode(v, f, v, bbox);
+	auto mesh2 = RepoBSONFactory::makeMeshNode(v, f, v, bbox);
+	EXPECT_NE(mesh1.getUniqueID(), mesh2.getUniqueID());
+	EXPECT_EQ(64, mesh1.getSHA256().size());
+	EXPECT_EQ(mesh1.getSHA256(), mesh2.getSHA256());
+	EXPECT_EQ(mesh1.getSHA256(), mesh1.getStringField(REPO_NODE_MESH_LABEL_SHA256));
+
+	//Same data laid out differently must not collide
+	auto noNormals = RepoBSONFactory::makeMeshNode(v, f, std::vector<repo::lib::RepoVector3D>(), bbox);
+	EXPECT_NE(mesh1.getSHA256(), noNormals.getSHA256());
+
+	f[0] = { 0, 2, 1 };
+	auto mesh3 = RepoBSONFactory::makeMeshNode(v, f, v, bbox);
+	EXPECT_NE(mesh1.getSHA256(), mesh3.getSHA256());
+
+	std::vector<float> notId =
+	{ 0.1f, 0, 0, 0,
+	0, 0.5f, 0.12f, 0,
+	0.5f, 0, 0.1f, 0,
+	0, 0, 0, 1 };
+	MeshNode transformed = mesh1.cloneAndApplyTransformation(notId);
+	EXPECT_NE(mesh1.getSHA256(), transformed.getSHA256());
+	EXPECT_EQ(transformed.getSHA256(), RepoBSONFactory::makeMeshNode(
+		transformed.getVertices(), transformed.getFaces(), transformed.getNormals(), bbox).getSHA256());
+}
+
+TEST(MeshNodeTest, GeometryFileName)
+{
+	std::vector<repo::lib::RepoVector3D> v = { { 0.1f, 0.2f, 0.3f }, { 0.4f, 0.5f, 0.6f }, { 0.7f, 0.8f, 0.9f } };
+	std::vector<repo_face_t> f = { { 0, 1, 2 } };
+	auto mesh = RepoBSONFactory::makeMeshNode(v, f, v, std::vector<std::vector<float>>());
+
+	auto fileName = MeshNode::getGeometryFileName(mesh.getSHA256(), REPO_NODE_MESH_LABEL_VERTICES);
+	EXPECT_TRUE(MeshNode::isGeometryFileName(fileName));
+
+	//Names based on unique IDs are not content addressed
+	EXPECT_FALSE(MeshNode::isGeometryFileName(mesh.getUniqueID().toString() + "_" + REPO_NODE_MESH_LABEL_VERTICES));
+	EXPECT_FALSE(MeshNode::isGeometryFileName(mesh.getSHA256() + "_"));
+	EXPECT_FALSE(MeshNode::isGeometryFileName(mesh.getSHA256()));
+	EXPECT_FALSE(MeshNode::isGeometryFileName(""));
+}
+
 TEST(MeshNodeTest, CloneAndApplyMeshMapping)
 {
 	MeshNode empty;
@@ -342,7 +390,7 @@ TEST(MeshNodeTest, Getters)
 	EXPECT_EQ(f.size(), resFaces.size());
 	for (int i = 0; i < resFaces.size(); ++i)
 	{
-		EXPECT_TRUE(compareStdVectors(resFaces[i], f[i]));
+		EXPECT_TRUE(compareStdVectors(resFaces[i].toVector(), f[i]));
 	}
 
 	EXPECT_EQ(0, empty.getNormals().size());
@@ -370,4 +418,101 @@ TEST(MeshNodeTest, Getters)
 		bboxInVect.push_back({ bbox[i][0], bbox[i][1], bbox[i][2] });
 	}
 	EXPECT_TRUE(compareStdVectors(retBbox, bboxInVect));
-}
\ No newline at end of file
+}
+TEST(MeshNodeTest, ViewGetters)
+{
+	MeshNode empty;
+
+	std::vector<repo::lib::RepoVector3D> v, n;
+	std::vector<repo_face_t> f;
+	std::vector<std::vector<float>> bbox;
+	std::vector<std::vector<repo::lib::RepoVector2D>> uvs;
+	std::vector<repo_color4d_t> cols;
+
+	uvs.resize(2);
+	for (int i = 0; i < 10; ++i)
+	{
+		v.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+		n.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+		uvs[0].push_back({ rand() / 100.0f, rand() / 100.0f });
+		uvs[1].push_back({ rand() / 100.0f, rand() / 100.0f });
+		cols.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+		f.push_back({ (uint32_t)rand(), (uint32_t)rand(), (uint32_t)rand() });
+	}
+	bbox.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+	bbox.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+
+	auto mesh = RepoBSONFactory::makeMeshNode(v, f, n, bbox, uvs, cols);
+
+	EXPECT_EQ(0, empty.getVerticesView().size());
+	EXPECT_EQ(0, empty.getNormalsView().size());
+	EXPECT_EQ(0, empty.getColorsView().size());
+	EXPECT_EQ(0, empty.getUVChannelsView().size());
+	EXPECT_EQ(0, empty.getUVChannelsSeparatedView().size());
+	EXPECT_EQ(0, empty.getFacesView().size());
+
+	EXPECT_TRUE(compareStdVectors(v, mesh.getVerticesView().toVector()));
+	EXPECT_TRUE(compareStdVectors(n, mesh.getNormalsView().toVector()));
+	EXPECT_TRUE(compareVectors(cols, mesh.getColorsView().toVector()));
+
+	auto uvViews = mesh.getUVChannelsSeparatedView();
+	ASSERT_EQ(uvs.size(), uvViews.size());
+	for (int i = 0; i < uvs.size(); ++i)
+	{
+		EXPECT_TRUE(compareStdVectors(uvs[i], uvViews[i].toVector()));
+	}
+	EXPECT_EQ(uvs[0].size() + uvs[1].size(), mesh.getUVChannelsView().size());
+
+	auto facesView = mesh.getFacesView();
+	EXPECT_EQ(f.size(), facesView.size());
+	//Serialised as [n, i0, i1, i2, ...]
+	EXPECT_EQ(f.size() * 4, facesView.serialised().size());
+	size_t fIdx = 0;
+	for (const auto face : facesView)
+	{
+		ASSERT_LT(fIdx, f.size());
+		EXPECT_TRUE(compareStdVectors(f[fIdx++], face.toVector()));
+	}
+	EXPECT_EQ(f.size(), fIdx);
+
+	//Views should point into the same buffer on every call
+	EXPECT_EQ(mesh.getVerticesView().data(), mesh.getVerticesView().data());
+	EXPECT_EQ(facesView.serialised().data(), mesh.getFacesView().serialised().data());
+}
+
+TEST(MeshNodeTest, GeometryCounts)
+{
+	MeshNode empty;
+	EXPECT_EQ(0, empty.getNumVertices());
+	EXPECT_EQ(0, empty.getNumFaces());
+
+	std::vector<repo::lib::RepoVector3D> v;
+	std::vector<repo_face_t> f;
+	std::vector<std::vector<float>> bbox;
+	for (int i = 0; i < 12; ++i)
+	{
+		v.push_back({ rand() / 100.0f, rand() / 100.0f, rand() / 100.0f });
+		if (i % 3 == 0)
+			f.push_back({ (uint32_t)i, (uint32_t)i + 1, (uint32_t)i + 2 });
+	}
+
+	auto mesh = RepoBSONFactory::makeMeshNode(v, f, v, bbox);
+	EXPECT_EQ(v.size(), mesh.getNumVertices());
+	EXPECT_EQ(f.size(), mesh.getNumFaces());
+	EXPECT_EQ(mesh.getVerticesView().size(), mesh.getNumVertices());
+	EXPECT_EQ(mesh.getFacesView().size(), mesh.getNumFaces());
+
+	//Counts are unaffected by transformations
+	std::vector<float> notId =
+	{ 0.1f, 0, 0, 0,
+	0, 0.5f, 0.12f, 0,
+	0.5f, 0, 0.1f, 0,
+	0, 0, 0, 1 };
+	MeshNode transformed = mesh.cloneAndApplyTransformation(notId);
+	EXPECT_EQ(v.size(), transformed.getNumVertices());
+	EXPECT_EQ(f.size(), transformed.getNumFaces());
+
+	//Meshes without a recorded vertex count fall back to the binary
+	MeshNode noCount(mesh.removeField(REPO_NODE_MESH_LABEL_VERTICES_COUNT));
+	EXPECT_EQ(v.size(), noCount.getNumVertices());
+}
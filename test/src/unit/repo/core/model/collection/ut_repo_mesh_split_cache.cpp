@@ -0,0 +1,69 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <gtest/gtest.h>
+
+#include <repo/core/model/collection/repo_mesh_split_cache.h>
+
+using namespace repo::core::model;
+
+TEST(MeshSplitCacheTest, FindAndInsert)
+{
+	MeshSplitCache cache;
+	auto meshID = repo::lib::RepoUUID::createUUID();
+
+	EXPECT_EQ(nullptr, cache.find(meshID, 65535));
+	EXPECT_EQ(0, cache.size());
+
+	auto split = std::make_shared<MeshSplit>();
+	split->serialisedFaces = { 0, 1, 2 };
+	EXPECT_EQ(split, cache.insert(meshID, 65535, split));
+	EXPECT_EQ(split, cache.find(meshID, 65535));
+	EXPECT_EQ(1, cache.size());
+
+	//A split is specific to its threshold
+	EXPECT_EQ(nullptr, cache.find(meshID, 100));
+	EXPECT_EQ(nullptr, cache.find(repo::lib::RepoUUID::createUUID(), 65535));
+
+	//Inserting again keeps the split already cached
+	auto split2 = std::make_shared<MeshSplit>();
+	EXPECT_EQ(split, cache.insert(meshID, 65535, split2));
+	EXPECT_EQ(split, cache.find(meshID, 65535));
+
+	EXPECT_EQ(split2, cache.insert(meshID, 100, split2));
+	EXPECT_EQ(2, cache.size());
+
+	cache.clear();
+	EXPECT_EQ(0, cache.size());
+	EXPECT_EQ(nullptr, cache.find(meshID, 65535));
+}
+
+TEST(MeshSplitCacheTest, SplitsOutliveCache)
+{
+	auto meshID = repo::lib::RepoUUID::createUUID();
+	std::shared_ptr<const MeshSplit> split;
+	{
+		MeshSplitCache cache;
+		auto newSplit = std::make_shared<MeshSplit>();
+		newSplit->serialisedFaces = { 0, 1, 2 };
+		split = cache.insert(meshID, 65535, newSplit);
+	}
+
+	//An exporter still using a split keeps it once the cache is dropped
+	ASSERT_NE(nullptr, split);
+	EXPECT_EQ(3, split->serialisedFaces.size());
+}
@@ -15,6 +15,7 @@
 *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
 #include <cstdlib>
 
 #include <gtest/gtest.h>
@@ -544,6 +545,32 @@ TEST(RepoSceneTest, loadScene)
 	errMsg.clear();
 }
 
+TEST(RepoSceneTest, loadSceneWithProfile)
+{
+	std::string errMsg;
+	RepoScene full(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ);
+	ASSERT_TRUE(full.loadScene(getHandler(), errMsg));
+	EXPECT_EQ(RepoScene::LoadProfile::FULL, full.getLoadProfile());
+
+	RepoScene tree(REPO_GTEST_DBNAME1, REPO_GTEST_DBNAME1_PROJ);
+	tree.setLoadProfile(RepoScene::LoadProfile::TREE);
+	EXPECT_EQ(RepoScene::LoadProfile::TREE, tree.getLoadProfile());
+	ASSERT_TRUE(tree.loadScene(getHandler(), errMsg));
+	EXPECT_TRUE(errMsg.empty());
+
+	//Same graph, without the geometry
+	EXPECT_EQ(full.getItemsInCurrentGraph(defaultG), tree.getItemsInCurrentGraph(defaultG));
+	EXPECT_EQ(full.getAllMeshes(defaultG).size(), tree.getAllMeshes(defaultG).size());
+	ASSERT_TRUE(tree.hasRoot(defaultG));
+	EXPECT_EQ(full.getRoot(defaultG)->getUniqueID(), tree.getRoot(defaultG)->getUniqueID());
+	for (const auto &mesh : tree.getAllMeshes(defaultG))
+		EXPECT_FALSE(mesh->hasBinField(REPO_NODE_MESH_LABEL_VERTICES));
+
+	//A partially loaded scene cannot be committed
+	EXPECT_FALSE(tree.commit(getHandler(), errMsg, "user"));
+	EXPECT_FALSE(errMsg.empty());
+}
+
 TEST(RepoSceneTest, loadStash)
 {
 	std::string errMsg;
@@ -706,6 +733,40 @@ TEST(RepoSceneTest, getParentAsNodesFiltered)
 	EXPECT_EQ(0, scene.getParentNodesFiltered(RepoScene::GraphType::DEFAULT, m1, NodeType::MESH).size());
 }
 
+TEST(RepoSceneTest, getMeshInstanceCounts)
+{
+	RepoNodeSet transNodes, meshNodes, empty;
+
+	auto root = new TransformationNode(makeRandomNode(getRandomString(rand() % 10 + 1)));
+	auto t1 = new TransformationNode(makeRandomNode(root->getSharedID()));
+	auto t2 = new TransformationNode(makeRandomNode(root->getSharedID()));
+	auto t3 = new TransformationNode(makeRandomNode(t1->getSharedID()));
+
+	//m1 is shared by 3 transformations, it is reachable through 3 paths
+	auto m1 = new MeshNode(RepoBSONFactory::appendDefaults("", 0U, repo::lib::RepoUUID::createUUID(), "",
+	{ t1->getSharedID(), t2->getSharedID(), t3->getSharedID() }));
+	auto m2 = new MeshNode(makeRandomNode(t3->getSharedID()));
+	auto orphan = new MeshNode(makeRandomNode(repo::lib::RepoUUID::createUUID()));
+
+	transNodes.insert(root);
+	transNodes.insert(t1);
+	transNodes.insert(t2);
+	transNodes.insert(t3);
+	meshNodes.insert(m1);
+	meshNodes.insert(m2);
+	meshNodes.insert(orphan);
+
+	RepoScene scene(std::vector<std::string>(), empty, meshNodes, empty, empty, empty, transNodes);
+
+	auto counts = scene.getMeshInstanceCounts(RepoScene::GraphType::DEFAULT);
+	EXPECT_EQ(3, counts.size());
+	EXPECT_EQ(3, counts[m1->getUniqueID()]);
+	EXPECT_EQ(1, counts[m2->getUniqueID()]);
+	EXPECT_EQ(0, counts[orphan->getUniqueID()]);
+
+	EXPECT_EQ(0, RepoScene().getMeshInstanceCounts(RepoScene::GraphType::DEFAULT).size());
+}
+
 TEST(RepoSceneTest, getSceneFromReference)
 {
 	RepoScene scene;
@@ -916,6 +977,47 @@ TEST(RepoSceneTest, getSceneBoundingBox)
 	EXPECT_TRUE(compareStdVectors(bb, getGoldenDataForBBoxTest()));
 }
 
+TEST(RepoSceneTest, getSceneBoundingBoxExact)
+{
+	//Rotate 45 degrees around z, then translate by (10, 0, 0)
+	const float c = std::sqrt(0.5f);
+	std::vector<float> rot45 = {
+		c, -c, 0, 10,
+		c, c, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1 };
+
+	auto root = new TransformationNode(RepoBSONFactory::makeTransformationNode());
+	auto trans = new TransformationNode(RepoBSONFactory::makeTransformationNode(rot45, "rot", { root->getSharedID() }));
+
+	std::vector<repo::lib::RepoVector3D> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+	repo::lib::RepoFaceBuffer faces;
+	faces.addTriangle(0, 1, 2);
+	std::vector<std::vector<float>> meshBBox = { { 0, 0, 0 }, { 1, 1, 0 } };
+	auto mesh = new MeshNode(RepoBSONFactory::makeMeshNode(vertices, faces, {}, meshBBox)
+		.cloneAndAddParent(trans->getSharedID()));
+
+	RepoNodeSet transNodes = { root, trans }, meshNodes = { mesh }, empty;
+	RepoScene scene(std::vector<std::string>(), empty, meshNodes, empty, empty, empty, transNodes);
+
+	auto exact = scene.getSceneBoundingBox(true);
+	ASSERT_EQ(2, exact.size());
+	EXPECT_NEAR(10 - c, exact[0].x, 1e-5);
+	EXPECT_NEAR(0, exact[0].y, 1e-5);
+	EXPECT_NEAR(10 + c, exact[1].x, 1e-5);
+	EXPECT_NEAR(c, exact[1].y, 1e-5);
+
+	//Derived from the mesh bounding box, this must enclose the exact box
+	auto approx = scene.getSceneBoundingBox();
+	ASSERT_EQ(2, approx.size());
+	EXPECT_NEAR(10 - c, approx[0].x, 1e-5);
+	EXPECT_NEAR(0, approx[0].y, 1e-5);
+	EXPECT_NEAR(10 + c, approx[1].x, 1e-5);
+	EXPECT_NEAR(2 * c, approx[1].y, 1e-5);
+	EXPECT_LE(approx[0].z, exact[0].z);
+	EXPECT_GE(approx[1].z, exact[1].z);
+}
+
 TEST(RepoSceneTest, getNodeBySharedID)
 {
 	RepoNodeSet transNodes, meshNodes, empty, matNodes, texNodes;
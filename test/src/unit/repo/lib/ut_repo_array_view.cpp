@@ -0,0 +1,100 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdlib>
+#include <repo/lib/datastructure/repo_array_view.h>
+#include <gtest/gtest.h>
+
+using namespace repo::lib;
+
+TEST(RepoArrayViewTest, constructorTest)
+{
+	RepoArrayView<float> empty;
+	EXPECT_EQ(0, empty.size());
+	EXPECT_TRUE(empty.empty());
+	EXPECT_EQ(empty.begin(), empty.end());
+
+	std::vector<float> data = { 1.0f, 2.0f, 3.0f, 4.0f };
+	RepoArrayView<float> view(data);
+	EXPECT_EQ(data.size(), view.size());
+	EXPECT_FALSE(view.empty());
+	//No copies should be made
+	EXPECT_EQ(data.data(), view.data());
+	for (size_t i = 0; i < data.size(); ++i)
+		EXPECT_EQ(data[i], view[i]);
+	EXPECT_EQ(data.back(), view.back());
+
+	RepoArrayView<float> ptrView(data.data() + 1, 2);
+	EXPECT_EQ(2, ptrView.size());
+	EXPECT_EQ(2.0f, ptrView[0]);
+	EXPECT_EQ(3.0f, ptrView[1]);
+}
+
+TEST(RepoArrayViewTest, subViewTest)
+{
+	std::vector<float> data = { 1.0f, 2.0f, 3.0f, 4.0f };
+	RepoArrayView<float> view(data);
+
+	auto sub = view.subView(1, 2);
+	EXPECT_EQ(2, sub.size());
+	EXPECT_EQ(data.data() + 1, sub.data());
+
+	//clamped to the end of the view
+	EXPECT_EQ(1, view.subView(3, 10).size());
+	EXPECT_TRUE(view.subView(4, 1).empty());
+	EXPECT_TRUE(view.subView(10, 1).empty());
+
+	auto copy = sub.toVector();
+	EXPECT_EQ(std::vector<float>({ 2.0f, 3.0f }), copy);
+}
+
+TEST(RepoFaceStreamViewTest, iterationTest)
+{
+	RepoFaceStreamView empty;
+	EXPECT_EQ(0, empty.size());
+	EXPECT_TRUE(empty.empty());
+	EXPECT_TRUE(empty.begin() == empty.end());
+
+	std::vector<uint32_t> stream = { 3, 0, 1, 2, 2, 3, 4, 3, 5, 6, 7 };
+	RepoFaceStreamView faces(stream, 3);
+	EXPECT_EQ(3, faces.size());
+	EXPECT_EQ(stream.data(), faces.serialised().data());
+
+	std::vector<std::vector<uint32_t>> expected = { { 0, 1, 2 }, { 3, 4 }, { 5, 6, 7 } };
+	size_t count = 0;
+	for (const auto face : faces)
+	{
+		ASSERT_LT(count, expected.size());
+		EXPECT_EQ(expected[count], face.toVector());
+		++count;
+	}
+	EXPECT_EQ(expected.size(), count);
+}
+
+TEST(RepoFaceStreamViewTest, truncatedStreamTest)
+{
+	//last face claims more indices than there are in the buffer
+	std::vector<uint32_t> stream = { 3, 0, 1, 2, 3, 4, 5 };
+	RepoFaceStreamView faces(stream, 2);
+
+	auto it = faces.begin();
+	EXPECT_EQ(3, (*it).size());
+	++it;
+	EXPECT_EQ(2, (*it).size());
+	++it;
+	EXPECT_TRUE(it == faces.end());
+}
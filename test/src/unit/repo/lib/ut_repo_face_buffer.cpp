@@ -0,0 +1,129 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdlib>
+#include <repo/lib/datastructure/repo_face_buffer.h>
+#include <gtest/gtest.h>
+
+using namespace repo::lib;
+
+TEST(RepoFaceBufferTest, constructorTest)
+{
+	RepoFaceBuffer empty;
+	EXPECT_EQ(0, empty.size());
+	EXPECT_TRUE(empty.empty());
+	EXPECT_EQ(0, empty.serialised().size());
+	EXPECT_TRUE(empty.begin() == empty.end());
+
+	std::vector<std::vector<uint32_t>> faces = { { 0, 1, 2 }, { 2, 3, 4 } };
+	RepoFaceBuffer buffer(faces);
+	EXPECT_EQ(2, buffer.size());
+	EXPECT_EQ(3, buffer.getPolygonSize());
+	EXPECT_EQ(std::vector<uint32_t>({ 3, 0, 1, 2, 3, 2, 3, 4 }), buffer.serialised());
+
+	RepoFaceBuffer copied(buffer.view());
+	EXPECT_EQ(buffer.size(), copied.size());
+	EXPECT_EQ(buffer.serialised(), copied.serialised());
+	EXPECT_NE(buffer.serialised().data(), copied.serialised().data());
+}
+
+TEST(RepoFaceBufferTest, pushBackTest)
+{
+	RepoFaceBuffer buffer;
+	buffer.addTriangle(0, 1, 2);
+	buffer.push_back({ 3, 4, 5 });
+	buffer.push_back(std::vector<uint32_t>({ 6, 7, 8 }));
+	EXPECT_EQ(3, buffer.size());
+	EXPECT_EQ(3, buffer.getPolygonSize());
+	for (uint32_t i = 0; i < buffer.size(); ++i)
+	{
+		auto face = buffer[i];
+		ASSERT_EQ(3, face.size());
+		EXPECT_EQ(i * 3, face[0]);
+		EXPECT_EQ(i * 3 + 1, face[1]);
+		EXPECT_EQ(i * 3 + 2, face[2]);
+	}
+
+	//mixed polygon sizes
+	buffer.push_back({ 9, 10 });
+	EXPECT_EQ(4, buffer.size());
+	EXPECT_EQ(0, buffer.getPolygonSize());
+	EXPECT_EQ(2, buffer[3].size());
+	EXPECT_EQ(10, buffer[3][1]);
+	EXPECT_EQ(6, buffer[2][0]);
+
+	buffer.clear();
+	EXPECT_TRUE(buffer.empty());
+	EXPECT_EQ(0, buffer.serialised().size());
+	buffer.addTriangle(1, 2, 3);
+	EXPECT_EQ(3, buffer.getPolygonSize());
+}
+
+TEST(RepoFaceBufferTest, appendTest)
+{
+	RepoFaceBuffer buffer, other;
+	buffer.addTriangle(0, 1, 2);
+	other.addTriangle(0, 1, 2);
+	other.addTriangle(2, 1, 0);
+
+	buffer.append(other, 10);
+	EXPECT_EQ(3, buffer.size());
+	EXPECT_EQ(std::vector<uint32_t>({ 3, 0, 1, 2, 3, 10, 11, 12, 3, 12, 11, 10 }), buffer.serialised());
+
+	size_t count = 0;
+	for (const auto face : buffer)
+	{
+		EXPECT_EQ(3, face.size());
+		++count;
+	}
+	EXPECT_EQ(buffer.size(), count);
+}
+
+TEST(RepoFaceBufferTest, mixedPolygonIndexTest)
+{
+	//Faces of 1 to 4 indices, every index is the number of the face
+	RepoFaceBuffer buffer;
+	std::vector<std::vector<uint32_t>> faces;
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		faces.push_back(std::vector<uint32_t>(i % 4 + 1, i));
+		if (i % 2)
+			buffer.push_back(faces.back());
+		else
+			buffer.append(RepoFaceBuffer({ faces.back() }));
+	}
+	EXPECT_EQ(0, buffer.getPolygonSize());
+
+	for (uint32_t i = 0; i < buffer.size(); ++i)
+	{
+		auto face = buffer[i];
+		ASSERT_EQ(faces[i].size(), face.size());
+		EXPECT_EQ(i, face[0]);
+		EXPECT_EQ(i, face[face.size() - 1]);
+	}
+
+	//Faces only stop having the same size after a while
+	RepoFaceBuffer late;
+	for (uint32_t i = 0; i < 10; ++i)
+		late.addTriangle(i, i, i);
+	late.push_back({ 10, 10, 10, 10 });
+	late.addTriangle(11, 11, 11);
+	EXPECT_EQ(0, late.getPolygonSize());
+	for (uint32_t i = 0; i < late.size(); ++i)
+		EXPECT_EQ(i, late[i][0]);
+	EXPECT_EQ(4, late[10].size());
+}
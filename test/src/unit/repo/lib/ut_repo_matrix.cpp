@@ -172,6 +172,24 @@ TEST(RepoMatrixTest, isIdentityTest)
 	EXPECT_TRUE(RepoMatrix(lowerUnder).isIdentity(eps));
 }
 
+TEST(RepoMatrixTest, isAffineTest)
+{
+	EXPECT_TRUE(RepoMatrix().isAffine());
+	EXPECT_TRUE(RepoMatrix(std::vector<float>({ 2, 0.3f, 0.4f, 1.23f,
+		0.1f, 3, 0.5f, 4.5f,
+		0.2f, 0.6f, 4, 6.7f,
+		0, 0, 0, 1 })).isAffine());
+
+	//Anything but 0, 0, 0, 1 on the last row
+	for (int i = 12; i < 16; ++i)
+	{
+		std::vector<float> data = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		data[i] += 0.5f;
+		EXPECT_FALSE(RepoMatrix(data).isAffine());
+		EXPECT_TRUE(RepoMatrix(data).isAffine(0.5f));
+	}
+}
+
 
 TEST(RepoMatrixTest, toStringTest)
 {	
@@ -235,6 +253,130 @@ TEST(RepoMatrixTest, matVecTest)
 	EXPECT_EQ(2.87128829956054690f, newVec2.z);
 }
 
+TEST(RepoMatrixTest, transformPositionsTest)
+{
+	RepoMatrix rand({ 2, 0.3f, 0.4f, 1.23f,
+		0.45f, 1, 0.488f, 12345,
+		0.5f, 0, 3.5f, 0,
+		0, 0, 0, 1
+	});
+
+	std::vector<RepoVector3D> positions, results;
+	for (int i = 0; i < 10; ++i)
+		positions.push_back({ (std::rand() % 1000) / 100.f, (std::rand() % 1000) / 100.f, (std::rand() % 1000) / 100.f });
+	results.resize(positions.size());
+
+	rand.transformPositions(positions.data(), results.data(), positions.size());
+	for (int i = 0; i < positions.size(); ++i)
+	{
+		auto expected = rand * positions[i];
+		EXPECT_EQ(expected.x, results[i].x);
+		EXPECT_EQ(expected.y, results[i].y);
+		EXPECT_EQ(expected.z, results[i].z);
+	}
+
+	//in place
+	auto inPlace = positions;
+	rand.transformPositions(inPlace.data(), inPlace.data(), inPlace.size());
+	for (int i = 0; i < positions.size(); ++i)
+	{
+		EXPECT_EQ(results[i].x, inPlace[i].x);
+		EXPECT_EQ(results[i].y, inPlace[i].y);
+		EXPECT_EQ(results[i].z, inPlace[i].z);
+	}
+
+	//Nothing to transform shouldn't crash
+	rand.transformPositions(nullptr, nullptr, 0);
+}
+
+TEST(RepoMatrixTest, transformPositionsBBoxTest)
+{
+	RepoMatrix rand({ 2, 0.3f, 0.4f, 1.23f,
+		0.45f, 1, 0.488f, 12345,
+		0.5f, 0, 3.5f, 0,
+		0, 0, 0, 1
+	});
+
+	std::vector<RepoVector3D> positions, results, expected;
+	for (int i = 0; i < 10; ++i)
+		positions.push_back({ (std::rand() % 1000) / 100.f - 5.f, (std::rand() % 1000) / 100.f, (std::rand() % 1000) / 100.f });
+	results.resize(positions.size());
+	expected.resize(positions.size());
+
+	RepoVector3D min, max;
+	rand.transformPositions(positions.data(), results.data(), positions.size(), min, max);
+	rand.transformPositions(positions.data(), expected.data(), positions.size());
+
+	RepoVector3D expectedMin = expected[0], expectedMax = expected[0];
+	for (int i = 0; i < positions.size(); ++i)
+	{
+		EXPECT_EQ(expected[i].x, results[i].x);
+		EXPECT_EQ(expected[i].y, results[i].y);
+		EXPECT_EQ(expected[i].z, results[i].z);
+		expectedMin.x = std::min(expectedMin.x, expected[i].x);
+		expectedMin.y = std::min(expectedMin.y, expected[i].y);
+		expectedMin.z = std::min(expectedMin.z, expected[i].z);
+		expectedMax.x = std::max(expectedMax.x, expected[i].x);
+		expectedMax.y = std::max(expectedMax.y, expected[i].y);
+		expectedMax.z = std::max(expectedMax.z, expected[i].z);
+	}
+	EXPECT_EQ(expectedMin, min);
+	EXPECT_EQ(expectedMax, max);
+
+	//Bounds are left alone if there is nothing to transform
+	RepoVector3D untouched(1, 2, 3);
+	rand.transformPositions(nullptr, nullptr, 0, untouched, untouched);
+	EXPECT_EQ(RepoVector3D(1, 2, 3), untouched);
+}
+
+TEST(RepoMatrixTest, transformNormalsTest)
+{
+	std::vector<RepoVector3D> normals = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 0, 0 } };
+	std::vector<RepoVector3D> results(normals.size());
+
+	//Translation should not affect normals
+	RepoMatrix translate({ 1, 0, 0, 10,
+		0, 1, 0, 20,
+		0, 0, 1, 30,
+		0, 0, 0, 1 });
+	translate.transformNormals(normals.data(), results.data(), normals.size());
+	for (int i = 0; i < normals.size(); ++i)
+	{
+		EXPECT_FLOAT_EQ(normals[i].x, results[i].x);
+		EXPECT_FLOAT_EQ(normals[i].y, results[i].y);
+		EXPECT_FLOAT_EQ(normals[i].z, results[i].z);
+	}
+
+	//Non uniform scale: normals should be scaled inversely then normalised
+	RepoMatrix scale({ 2, 0, 0, 0,
+		0, 4, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1 });
+	std::vector<RepoVector3D> diagonal = { { 1, 1, 0 } };
+	RepoVector3D result;
+	scale.transformNormals(diagonal.data(), &result, 1);
+	RepoVector3D expected(0.5f, 0.25f, 0);
+	expected.normalize();
+	EXPECT_FLOAT_EQ(expected.x, result.x);
+	EXPECT_FLOAT_EQ(expected.y, result.y);
+	EXPECT_FLOAT_EQ(expected.z, result.z);
+
+	//Rotation by 90 degrees around z
+	RepoMatrix rotate({ 0, -1, 0, 0,
+		1, 0, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1 });
+	rotate.transformNormals(normals.data(), results.data(), normals.size());
+	EXPECT_FLOAT_EQ(1, results[0].y);
+	EXPECT_NEAR(0, results[0].x, 1e-6);
+	EXPECT_FLOAT_EQ(-1, results[1].x);
+	EXPECT_FLOAT_EQ(1, results[2].z);
+	//zero length normals stay as they are
+	EXPECT_EQ(0, results[3].x);
+	EXPECT_EQ(0, results[3].y);
+	EXPECT_EQ(0, results[3].z);
+}
+
 TEST(RepoMatrixTest, matMatTest)
 {
 	EXPECT_TRUE(checkIsIdentity(RepoMatrix()*RepoMatrix()));
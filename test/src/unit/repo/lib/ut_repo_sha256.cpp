@@ -0,0 +1,58 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include <repo/lib/repo_sha256.h>
+#include <gtest/gtest.h>
+
+using namespace repo::lib;
+
+TEST(RepoSHA256Test, KnownDigests)
+{
+	EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", RepoSHA256::hash("", 0));
+	EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", RepoSHA256::hash("abc", 3));
+
+	const std::string twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", RepoSHA256::hash(twoBlocks.data(), twoBlocks.size()));
+
+	std::vector<uint8_t> million(1000000, 'a');
+	RepoSHA256 sha;
+	sha.update(million);
+	EXPECT_EQ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", sha.hexDigest());
+}
+
+TEST(RepoSHA256Test, IncrementalUpdate)
+{
+	std::vector<uint8_t> data(1000);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (uint8_t)(i * 7);
+
+	const std::string expected = RepoSHA256::hash(data.data(), data.size());
+	for (const size_t pieceSize : { 1, 3, 55, 63, 64, 65, 999 })
+	{
+		RepoSHA256 sha;
+		for (size_t offset = 0; offset < data.size(); offset += pieceSize)
+			sha.update(data.data() + offset, std::min(pieceSize, data.size() - offset));
+		EXPECT_EQ(expected, sha.hexDigest());
+		//finishing is idempotent, no more data is taken in
+		sha.update(data.data(), 10);
+		EXPECT_EQ(expected, sha.hexDigest());
+	}
+
+	EXPECT_NE(expected, RepoSHA256::hash(data.data(), data.size() - 1));
+}
@@ -0,0 +1,108 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <repo/lib/repo_stack.h>
+#include <gtest/gtest.h>
+
+using namespace repo::lib;
+
+TEST(RepoStackTest, PushPop)
+{
+	RepoStack<int> stack(0, 10);
+	int a = 1, b = 2;
+	int *pa = &a, *pb = &b;
+	stack.push(pa);
+	stack.push(pb);
+
+	auto first = stack.pop();
+	auto second = stack.pop();
+	EXPECT_TRUE((first == &a && second == &b) || (first == &b && second == &a));
+
+	auto stats = stack.getStats();
+	EXPECT_EQ(2, stats.pops);
+	EXPECT_EQ(0, stats.waits);
+	EXPECT_EQ(2, stats.highWaterMark);
+
+	stack.push(first);
+	EXPECT_EQ(1, stack.empty().size());
+	EXPECT_EQ(0, stack.empty().size());
+}
+
+TEST(RepoStackTest, Timeout)
+{
+	//Gives up after 10 * (4 + 1) ms
+	RepoStack<int> stack(4, 10);
+	auto start = boost::chrono::steady_clock::now();
+	EXPECT_EQ(nullptr, stack.pop());
+	auto elapsed = boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now() - start);
+	EXPECT_GE(elapsed.count(), 50);
+
+	auto stats = stack.getStats();
+	EXPECT_EQ(1, stats.waits);
+	EXPECT_EQ(1, stats.timeouts);
+	EXPECT_EQ(0, stats.pops);
+}
+
+TEST(RepoStackTest, WakesUpOnPush)
+{
+	RepoStack<int> stack;
+	int a = 1;
+	int *result = nullptr;
+
+	boost::thread waiter([&]() { result = stack.pop(); });
+	boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+	int *pa = &a;
+	stack.push(pa);
+	waiter.join();
+
+	EXPECT_EQ(&a, result);
+	auto stats = stack.getStats();
+	EXPECT_EQ(1, stats.waits);
+	//Woken up by the push, not by polling
+	EXPECT_LT(stats.maxWaitMs, 500);
+}
+
+TEST(RepoStackTest, FirstInFirstServed)
+{
+	RepoStack<int> stack;
+	int items[3] = { 0, 1, 2 };
+	int *results[3] = { nullptr, nullptr, nullptr };
+
+	boost::thread_group waiters;
+	for (int i = 0; i < 3; ++i)
+	{
+		waiters.create_thread([&, i]() { results[i] = stack.pop(); });
+		//make sure the waiters queue up in order
+		while (stack.getStats().waits < i + 1)
+			boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+	}
+
+	EXPECT_EQ(3, stack.getStats().maxWaiting);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		int *item = &items[i];
+		stack.push(item);
+		//wait until the item has been taken before pushing the next one
+		while (stack.getStats().pops < i + 1)
+			boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+	}
+	waiters.join_all();
+
+	for (int i = 0; i < 3; ++i)
+		EXPECT_EQ(&items[i], results[i]);
+}
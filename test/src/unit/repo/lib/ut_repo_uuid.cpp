@@ -16,11 +16,13 @@
 */
 
 #include <cstdlib>
+#include <set>
 #include <sstream>
 #include <repo/lib/datastructure/repo_uuid.h>
 #include <gtest/gtest.h>
 
 #include <repo/core/model/bson/repo_bson_builder.h>
+#include <boost/thread.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
@@ -290,4 +292,27 @@ TEST(RepoUUIDTest, gteOperatorTest)
 		EXPECT_TRUE(fromGenB >= fromGenA);
 	}
 
-}
\ No newline at end of file
+}
+
+TEST(RepoUUIDTest, createUUIDConcurrently)
+{
+	const size_t nThreads = 16, nIDsPerThread = 10000;
+	std::vector<std::vector<RepoUUID>> ids(nThreads);
+	boost::thread_group threads;
+	for (size_t i = 0; i < nThreads; ++i)
+	{
+		threads.create_thread([&ids, i, nIDsPerThread]()
+		{
+			ids[i].reserve(nIDsPerThread);
+			for (size_t j = 0; j < nIDsPerThread; ++j)
+				ids[i].push_back(RepoUUID::createUUID());
+		});
+	}
+	threads.join_all();
+
+	std::set<RepoUUID> uniqueIDs;
+	for (const auto &threadIDs : ids)
+		uniqueIDs.insert(threadIDs.begin(), threadIDs.end());
+	EXPECT_EQ(nThreads * nIDsPerThread, uniqueIDs.size());
+	EXPECT_EQ(0, uniqueIDs.count(RepoUUID()));
+}
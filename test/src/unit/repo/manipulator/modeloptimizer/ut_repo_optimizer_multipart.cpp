@@ -0,0 +1,158 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/manipulator/modeloptimizer/repo_optimizer_multipart.h>
+
+using namespace repo::manipulator::modeloptimizer;
+using namespace repo::core::model;
+
+static const RepoScene::GraphType stashG = RepoScene::GraphType::OPTIMIZED;
+
+/**
+* Create a scene with meshes of different formats under one root,
+* so several groups are merged
+*/
+static RepoScene* createScene(const size_t &nMeshes)
+{
+	RepoNodeSet meshes, trans, empty;
+	auto root = new TransformationNode(RepoBSONFactory::makeTransformationNode());
+	trans.insert(root);
+
+	for (size_t i = 0; i < nMeshes; ++i)
+	{
+		float offset = (float)i;
+		std::vector<repo::lib::RepoVector3D> vertices = { { offset, 0, 0 }, { offset + 1, 0, 0 }, { offset, 1, 0 } };
+		std::vector<repo::lib::RepoVector3D> normals = { { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 } };
+		std::vector<repo_color4d_t> colors = { { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, 0, 1, 1 } };
+		std::vector<repo_face_t> faces = { { 0, 1, 2 } };
+		std::vector<std::vector<float>> bbox = { { offset, 0, 0 }, { offset + 1, 1, 0 } };
+
+		auto mesh = RepoBSONFactory::makeMeshNode(vertices, faces,
+			i % 2 ? normals : std::vector<repo::lib::RepoVector3D>(), bbox,
+			std::vector<std::vector<repo::lib::RepoVector2D>>(),
+			i % 3 ? colors : std::vector<repo_color4d_t>());
+		meshes.insert(new MeshNode(mesh.cloneAndAddParent(root->getSharedID())));
+	}
+
+	return new RepoScene(std::vector<std::string>(), empty, meshes, empty, empty, empty, trans);
+}
+
+/**
+* Get the meshes merged into every super mesh, in merging order
+*/
+static std::vector<std::vector<repo::lib::RepoUUID>> getMergedMeshIDs(const RepoScene *scene)
+{
+	std::vector<std::vector<repo::lib::RepoUUID>> merged;
+	for (const auto &node : scene->getAllMeshes(stashG))
+	{
+		merged.push_back(std::vector<repo::lib::RepoUUID>());
+		for (const auto &mapping : ((MeshNode*)node)->getMeshMapping())
+			merged.back().push_back(mapping.mesh_id);
+	}
+	std::sort(merged.begin(), merged.end());
+	return merged;
+}
+
+TEST(MultipartOptimizer, ApplyOptimizationTest)
+{
+	MultipartOptimizer opt;
+	RepoScene *empty = nullptr;
+	EXPECT_FALSE(opt.apply(empty));
+
+	auto scene = createScene(60);
+	EXPECT_TRUE(opt.apply(scene));
+
+	//Normals (2 formats) x colours (2 formats)
+	auto merged = getMergedMeshIDs(scene);
+	EXPECT_EQ(4, merged.size());
+
+	std::vector<repo::lib::RepoUUID> allMerged, original;
+	for (const auto &group : merged)
+		allMerged.insert(allMerged.end(), group.begin(), group.end());
+	for (const auto &mesh : scene->getAllMeshes(RepoScene::GraphType::DEFAULT))
+		original.push_back(mesh->getUniqueID());
+	std::sort(allMerged.begin(), allMerged.end());
+	std::sort(original.begin(), original.end());
+	EXPECT_EQ(original, allMerged);
+
+	delete scene;
+}
+
+TEST(MultipartOptimizer, DeterministicGrouping)
+{
+	MultipartOptimizer opt;
+	auto scene = createScene(60);
+
+	EXPECT_TRUE(opt.apply(scene));
+	auto firstRun = getMergedMeshIDs(scene);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		EXPECT_TRUE(opt.apply(scene));
+		EXPECT_EQ(firstRun, getMergedMeshIDs(scene));
+	}
+
+	delete scene;
+}
+
+TEST(MultipartOptimizer, MemoryBudget)
+{
+	auto scene = createScene(60);
+
+	//Every mesh is over a budget of 1 byte, so each ends up in its own group
+	MultipartOptimizer tinyBudget(1);
+	EXPECT_TRUE(tinyBudget.apply(scene));
+	auto merged = getMergedMeshIDs(scene);
+	EXPECT_EQ(60, merged.size());
+	for (const auto &group : merged)
+		EXPECT_EQ(1, group.size());
+
+	//A triangle takes 52 bytes, 136 bytes with normals and colours
+	MultipartOptimizer smallBudget(700);
+	EXPECT_TRUE(smallBudget.apply(scene));
+	merged = getMergedMeshIDs(scene);
+	EXPECT_LT(4, merged.size());
+	EXPECT_GT(60, merged.size());
+	for (const auto &group : merged)
+		EXPECT_GE(13, group.size());
+
+	delete scene;
+}
+
+TEST(MultipartOptimizer, MergeMemoryBudget)
+{
+	auto scene = createScene(60);
+
+	MultipartOptimizer opt;
+	EXPECT_TRUE(opt.apply(scene));
+	auto expected = getMergedMeshIDs(scene);
+
+	//Every group is over a shared budget of 1 byte, so they are merged one at a time
+	MultipartOptimizer oneAtATime(REPO_MP_MAX_SUPERMESH_SIZE, 1);
+	EXPECT_TRUE(oneAtATime.apply(scene));
+	EXPECT_EQ(expected, getMergedMeshIDs(scene));
+
+	//Small groups, merged a few at a time
+	MultipartOptimizer fewAtATime(700, 4000);
+	EXPECT_TRUE(fewAtATime.apply(scene));
+	EXPECT_LT(4, getMergedMeshIDs(scene).size());
+
+	delete scene;
+}
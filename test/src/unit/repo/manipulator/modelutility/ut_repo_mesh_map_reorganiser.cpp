@@ -0,0 +1,285 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+#include <gtest/gtest.h>
+#include <repo/core/model/bson/repo_bson_factory.h>
+#include <repo/manipulator/modelutility/repo_mesh_map_reorganiser.h>
+
+using namespace repo::manipulator::modelutility;
+using namespace repo::core::model;
+
+/**
+* Create a square grid mesh of (at least) nTriangles triangles,
+* split into nSubMeshes sub meshes of equal size
+*/
+static MeshNode createGridMesh(const size_t &nTriangles, const size_t &nSubMeshes = 1)
+{
+	std::vector<repo::lib::RepoVector3D> vertices, normals;
+	repo::lib::RepoFaceBuffer faces;
+	std::vector<repo_mesh_mapping_t> mappings;
+
+	const size_t nQuads = (nTriangles / nSubMeshes + 1) / 2;
+	const size_t width = std::max<size_t>(1, std::sqrt((double)nQuads));
+	const size_t height = (nQuads + width - 1) / width;
+
+	vertices.reserve(nSubMeshes * (width + 1) * (height + 1));
+	normals.reserve(vertices.capacity());
+	faces.reserve(nSubMeshes * nQuads * 2);
+	for (size_t subMesh = 0; subMesh < nSubMeshes; ++subMesh)
+	{
+		repo_mesh_mapping_t mapping;
+		mapping.mesh_id = repo::lib::RepoUUID::createUUID();
+		mapping.material_id = repo::lib::RepoUUID::createUUID();
+		mapping.vertFrom = vertices.size();
+		mapping.triFrom = faces.size();
+		mapping.min = { 0, 0, (float)subMesh };
+		mapping.max = { (float)width, (float)height, (float)subMesh };
+
+		for (size_t y = 0; y <= height; ++y)
+		{
+			for (size_t x = 0; x <= width; ++x)
+			{
+				vertices.push_back({ (float)x, (float)y, (float)subMesh });
+				normals.push_back({ 0, 0, 1 });
+			}
+		}
+
+		for (size_t quad = 0; quad < nQuads; ++quad)
+		{
+			uint32_t corner = mapping.vertFrom + (quad / width) * (width + 1) + quad % width;
+			faces.addTriangle(corner, corner + 1, corner + width + 1);
+			faces.addTriangle(corner + 1, corner + width + 2, corner + width + 1);
+		}
+
+		mapping.vertTo = vertices.size();
+		mapping.triTo = faces.size();
+		mappings.push_back(mapping);
+	}
+
+	std::vector<std::vector<float>> bbox = { { 0, 0, 0 }, { (float)width, (float)height, (float)nSubMeshes } };
+	auto mesh = RepoBSONFactory::makeMeshNode(vertices, faces, normals, bbox);
+	return mesh.cloneAndUpdateMeshMapping(mappings, true);
+}
+
+/**
+* Check the split of a mesh keeps every triangle, in order, and within the vertex limit
+*/
+static void checkSplit(const MeshNode &mesh, const size_t &vertLimit)
+{
+	MeshMapReorganiser reorganiser(&mesh, vertLimit, false);
+	auto idMaps = reorganiser.getIDMapArrays();
+	auto split = reorganiser.releaseMeshSplit();
+	ASSERT_TRUE((bool)split);
+
+	auto orgVertices = mesh.getVerticesView();
+	auto orgFaces = mesh.getFacesView();
+	auto newVertices = split->remappedMesh->getVerticesView();
+	auto newMappings = split->remappedMesh->getMeshMapping();
+
+	ASSERT_EQ(orgFaces.size() * 3, split->serialisedFaces.size());
+	ASSERT_EQ(newMappings.size(), split->idMapBuf.size());
+	EXPECT_EQ(idMaps, split->idMapBuf);
+
+	auto orgFace = orgFaces.begin();
+	for (size_t i = 0; i < newMappings.size(); ++i)
+	{
+		const auto &mapping = newMappings[i];
+		const size_t nVertices = mapping.vertTo - mapping.vertFrom;
+		EXPECT_LE(nVertices, vertLimit);
+		EXPECT_EQ(nVertices, split->idMapBuf[i].size());
+
+		for (int32_t tri = mapping.triFrom; tri < mapping.triTo; ++tri, ++orgFace)
+		{
+			for (size_t j = 0; j < 3; ++j)
+			{
+				const uint32_t newIndex = split->serialisedFaces[tri * 3 + j];
+				ASSERT_LT(newIndex, nVertices);
+				EXPECT_EQ(orgVertices[(*orgFace)[j]], newVertices[mapping.vertFrom + newIndex]);
+			}
+		}
+	}
+	EXPECT_TRUE(orgFace == orgFaces.end());
+
+	//Every original sub mesh is mapped to at least one new sub mesh
+	EXPECT_EQ(mesh.getMeshMapping().size(), split->splitMapping.size());
+	for (const auto &subMesh : split->splitMapping)
+		EXPECT_TRUE(subMesh.second.size());
+}
+
+TEST(MeshMapReorganiser, SplitLargeSubMesh)
+{
+	auto mesh = createGridMesh(20000);
+	ASSERT_GT(mesh.getVerticesView().size(), 1000u);
+	checkSplit(mesh, 1000);
+}
+
+TEST(MeshMapReorganiser, MergeSmallSubMeshes)
+{
+	auto mesh = createGridMesh(2000, 20);
+	checkSplit(mesh, 65535);
+
+	MeshMapReorganiser reorganiser(&mesh, 65535);
+	auto split = reorganiser.releaseMeshSplit();
+	ASSERT_TRUE((bool)split);
+	//All sub meshes fit within one, and vertices are taken as they are
+	EXPECT_EQ(1, split->remappedMesh->getMeshMapping().size());
+	EXPECT_EQ(mesh.getVerticesView().size(), split->remappedMesh->getVerticesView().size());
+	EXPECT_EQ(20, split->matMap[0].size());
+}
+
+TEST(MeshMapReorganiser, MultipleSubMeshes)
+{
+	//8 sub meshes of 1332 vertices each
+	auto mesh = createGridMesh(20000, 8);
+	//every sub mesh fits on its own, but no two together
+	checkSplit(mesh, 1400);
+	//every sub mesh is over the limit
+	checkSplit(mesh, 1000);
+}
+
+TEST(MeshMapReorganiser, ReleaseMeshSplit)
+{
+	auto mesh = createGridMesh(200);
+	MeshMapReorganiser reorganiser(&mesh, 65535);
+	EXPECT_TRUE((bool)reorganiser.releaseMeshSplit());
+	//The results have been handed over
+	EXPECT_FALSE((bool)reorganiser.releaseMeshSplit());
+	EXPECT_TRUE(reorganiser.getRemappedMesh().isEmpty());
+}
+
+/**
+* Get the triangles of an original sub mesh within a split as vertex positions,
+* rotated so the smallest vertex comes first (keeping the winding) and sorted
+*/
+static std::vector<std::vector<float>> getSortedTriangles(
+	const MeshSplit           &split,
+	const size_t              &subMeshIdx,
+	const repo_mesh_mapping_t &orgSubMesh)
+{
+	auto vertices = split.remappedMesh->getVerticesView();
+	auto subMeshVFrom = split.remappedMesh->getMeshMapping()[subMeshIdx].vertFrom;
+
+	std::vector<std::vector<float>> triangles;
+	for (int32_t tri = orgSubMesh.triFrom; tri < orgSubMesh.triTo; ++tri)
+	{
+		std::vector<repo::lib::RepoVector3D> corners;
+		for (size_t j = 0; j < 3; ++j)
+		{
+			const uint32_t index = split.serialisedFaces[tri * 3 + j] + subMeshVFrom;
+			EXPECT_GE(index, orgSubMesh.vertFrom);
+			EXPECT_LT(index, orgSubMesh.vertTo);
+			corners.push_back(vertices[index]);
+		}
+
+		auto first = std::min_element(corners.begin(), corners.end(),
+			[](const repo::lib::RepoVector3D &a, const repo::lib::RepoVector3D &b)
+		{ return std::make_tuple(a.x, a.y, a.z) < std::make_tuple(b.x, b.y, b.z); });
+		std::rotate(corners.begin(), first, corners.end());
+
+		std::vector<float> triangle;
+		for (const auto &corner : corners)
+			triangle.insert(triangle.end(), { corner.x, corner.y, corner.z });
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(MeshMapReorganiser, OptimiseVertexCache)
+{
+	auto mesh = createGridMesh(20000, 8);
+	for (const auto &vertLimit : { 1000, 65535 })
+	{
+		MeshMapReorganiser orgReorganiser(&mesh, vertLimit, false);
+		auto orgSplit = orgReorganiser.releaseMeshSplit();
+		MeshMapReorganiser reorganiser(&mesh, vertLimit);
+		auto split = reorganiser.releaseMeshSplit();
+		ASSERT_TRUE((bool)orgSplit);
+		ASSERT_TRUE((bool)split);
+
+		//The sub meshes are the same, only the order within every original sub mesh changes
+		EXPECT_EQ(orgSplit->idMapBuf, split->idMapBuf);
+		ASSERT_EQ(orgSplit->matMap.size(), split->matMap.size());
+		ASSERT_EQ(orgSplit->serialisedFaces.size(), split->serialisedFaces.size());
+		EXPECT_EQ(orgSplit->remappedMesh->getVerticesView().size(), split->remappedMesh->getVerticesView().size());
+
+		for (size_t i = 0; i < split->matMap.size(); ++i)
+		{
+			ASSERT_EQ(orgSplit->matMap[i].size(), split->matMap[i].size());
+			for (size_t j = 0; j < split->matMap[i].size(); ++j)
+			{
+				EXPECT_EQ(orgSplit->matMap[i][j].vertFrom, split->matMap[i][j].vertFrom);
+				EXPECT_EQ(orgSplit->matMap[i][j].triFrom, split->matMap[i][j].triFrom);
+				EXPECT_EQ(getSortedTriangles(*orgSplit, i, orgSplit->matMap[i][j]), getSortedTriangles(*split, i, split->matMap[i][j]));
+			}
+		}
+
+		//The cache misses are only counted when optimising
+		EXPECT_EQ(0, orgSplit->cacheMisses);
+		EXPECT_GT(split->orgCacheMisses, 0);
+		EXPECT_LT(split->cacheMisses, split->orgCacheMisses);
+	}
+}
+
+/**
+* Time the split of a synthetic mesh, these are disabled by default
+* Run with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+* @param nTriangles number of triangles of the mesh
+* @param optimiseForCache also reorder the faces for the vertex cache
+*/
+static void benchmarkSplit(const size_t &nTriangles, const bool &optimiseForCache)
+{
+	auto mesh = createGridMesh(nTriangles);
+	auto start = std::chrono::steady_clock::now();
+	MeshMapReorganiser reorganiser(&mesh, 65535, optimiseForCache);
+	auto split = reorganiser.releaseMeshSplit();
+	auto end = std::chrono::steady_clock::now();
+
+	ASSERT_TRUE((bool)split);
+	std::cout << "Split " << mesh.getFacesView().size() << " triangles into "
+		<< split->remappedMesh->getMeshMapping().size() << " sub meshes in "
+		<< std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms";
+	if (optimiseForCache)
+	{
+		std::cout << ", vertex cache ACMR "
+			<< (float)split->orgCacheMisses / mesh.getFacesView().size() << " -> "
+			<< (float)split->cacheMisses / mesh.getFacesView().size();
+	}
+	std::cout << std::endl;
+}
+
+TEST(MeshMapReorganiser, DISABLED_Benchmark1MTriangles)
+{
+	benchmarkSplit(1000000, false);
+}
+
+TEST(MeshMapReorganiser, DISABLED_Benchmark10MTriangles)
+{
+	benchmarkSplit(10000000, false);
+}
+
+TEST(MeshMapReorganiser, DISABLED_BenchmarkOptimiseVertexCache1MTriangles)
+{
+	benchmarkSplit(1000000, true);
+}
@@ -0,0 +1,163 @@
+/**
+*  Copyright (C) 2016 3D Repo Ltd
+*
+*  This program is free software: you can redistribute it and/or modify
+*  it under the terms of the GNU Affero General Public License as
+*  published by the Free Software Foundation, either version 3 of the
+*  License, or (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU Affero General Public License for more details.
+*
+*  You should have received a copy of the GNU Affero General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <repo/manipulator/modelutility/repo_vertex_cache_optimiser.h>
+
+using namespace repo::manipulator::modelutility;
+
+/**
+* Create a width x height grid of quads, with its triangles in random order
+*/
+static void createShuffledGrid(
+	const size_t                         &width,
+	const size_t                         &height,
+	std::vector<repo::lib::RepoVector3D> &vertices,
+	std::vector<uint16_t>                &faces)
+{
+	for (size_t y = 0; y <= height; ++y)
+		for (size_t x = 0; x <= width; ++x)
+			vertices.push_back({ (float)x, (float)y, 0 });
+
+	std::vector<std::array<uint16_t, 3>> triangles;
+	for (size_t y = 0; y < height; ++y)
+	{
+		for (size_t x = 0; x < width; ++x)
+		{
+			uint16_t corner = y * (width + 1) + x;
+			triangles.push_back({ { corner, (uint16_t)(corner + 1), (uint16_t)(corner + width + 1) } });
+			triangles.push_back({ { (uint16_t)(corner + 1), (uint16_t)(corner + width + 2), (uint16_t)(corner + width + 1) } });
+		}
+	}
+
+	std::mt19937 generator(1);
+	std::shuffle(triangles.begin(), triangles.end(), generator);
+	for (const auto &triangle : triangles)
+		faces.insert(faces.end(), triangle.begin(), triangle.end());
+}
+
+/**
+* Get the triangles of a face buffer as vertex positions, rotated so the
+* smallest index comes first (keeping the winding) and sorted
+*/
+static std::vector<std::array<uint16_t, 3>> getSortedTriangles(
+	const std::vector<uint16_t> &faces,
+	const std::vector<uint32_t> &newToOld = std::vector<uint32_t>())
+{
+	std::vector<std::array<uint16_t, 3>> triangles;
+	for (size_t i = 0; i < faces.size(); i += 3)
+	{
+		std::array<uint16_t, 3> triangle;
+		for (size_t j = 0; j < 3; ++j)
+			triangle[j] = newToOld.size() ? newToOld[faces[i + j]] : faces[i + j];
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(VertexCacheOptimiser, CountCacheMisses)
+{
+	VertexCacheOptimiser optimiser(3);
+	std::vector<uint16_t> faces = { 0, 1, 2, 2, 1, 0 };
+	EXPECT_EQ(3, optimiser.countCacheMisses(faces.data(), 2, 3));
+
+	//The first triangle is out of the cache by the time it is drawn again
+	faces = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+	EXPECT_EQ(9, optimiser.countCacheMisses(faces.data(), 3, 6));
+
+	//A hit does not move the vertex within a FIFO cache
+	faces = { 0, 1, 2, 0, 3, 4 };
+	EXPECT_EQ(5, optimiser.countCacheMisses(faces.data(), 2, 5));
+	faces = { 0, 1, 2, 0, 3, 4, 0, 5, 6 };
+	EXPECT_EQ(8, optimiser.countCacheMisses(faces.data(), 3, 7));
+}
+
+TEST(VertexCacheOptimiser, ReorderFaces)
+{
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<uint16_t> faces;
+	createShuffledGrid(100, 100, vertices, faces);
+	const size_t nFaces = faces.size() / 3;
+
+	VertexCacheOptimiser optimiser;
+	auto orgTriangles = getSortedTriangles(faces);
+	const float orgACMR = (float)optimiser.countCacheMisses(faces.data(), nFaces, vertices.size()) / nFaces;
+
+	optimiser.reorderFaces(faces.data(), nFaces, vertices.data(), vertices.size());
+	const float acmr = (float)optimiser.countCacheMisses(faces.data(), nFaces, vertices.size()) / nFaces;
+
+	//Every face is kept, with its winding
+	EXPECT_EQ(orgTriangles, getSortedTriangles(faces));
+	//A grid has 0.5 vertices per face, shuffled faces miss almost every vertex
+	EXPECT_GT(orgACMR, 2.5);
+	EXPECT_LT(acmr, 1.0);
+}
+
+TEST(VertexCacheOptimiser, ReorderVertices)
+{
+	std::vector<repo::lib::RepoVector3D> vertices;
+	std::vector<uint16_t> faces;
+	createShuffledGrid(10, 10, vertices, faces);
+	//A vertex no face uses
+	vertices.push_back({ 0, 0, 1 });
+	const size_t nFaces = faces.size() / 3;
+
+	VertexCacheOptimiser optimiser;
+	auto orgTriangles = getSortedTriangles(faces);
+	auto newToOld = optimiser.reorderVertices(faces.data(), nFaces, vertices.size());
+
+	//The vertices are a permutation, unused ones at the end
+	ASSERT_EQ(vertices.size(), newToOld.size());
+	EXPECT_EQ(vertices.size() - 1, newToOld.back());
+	auto sorted = newToOld;
+	std::sort(sorted.begin(), sorted.end());
+	for (uint32_t i = 0; i < sorted.size(); ++i)
+		EXPECT_EQ(i, sorted[i]);
+
+	//Vertices are numbered in the order they are first used
+	uint16_t nextVertex = 0;
+	for (const auto &index : faces)
+	{
+		EXPECT_LE(index, nextVertex);
+		if (index == nextVertex)
+			++nextVertex;
+	}
+	EXPECT_EQ(vertices.size() - 1, nextVertex);
+
+	EXPECT_EQ(orgTriangles, getSortedTriangles(faces, newToOld));
+}
+
+TEST(VertexCacheOptimiser, DegenerateInput)
+{
+	VertexCacheOptimiser optimiser;
+	std::vector<repo::lib::RepoVector3D> vertices = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } };
+	std::vector<uint16_t> faces = { 0, 0, 1, 1, 2, 2, 0, 1, 2 };
+
+	optimiser.reorderFaces(faces.data(), 3, vertices.data(), vertices.size());
+	EXPECT_EQ(getSortedTriangles({ 0, 0, 1, 1, 2, 2, 0, 1, 2 }), getSortedTriangles(faces));
+
+	//Nothing to reorder
+	optimiser.reorderFaces(faces.data(), 0, vertices.data(), vertices.size());
+	EXPECT_EQ(0, optimiser.countCacheMisses(faces.data(), 0, vertices.size()));
+	EXPECT_EQ(vertices.size(), optimiser.reorderVertices(faces.data(), 0, vertices.size()).size());
+}